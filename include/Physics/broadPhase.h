@@ -0,0 +1,161 @@
+/**
+ * @file broadPhase.h
+ * @author DotBox
+ * @brief Broad phases for sphere-sphere contacts (uniform spatial hash, sweep and prune)
+ *
+ * Testing every pair of spheres for overlap is O(N²) even though in granular
+ * and debris scenes almost all pairs are far apart. The broad phase bins each
+ * sphere's bounding box into a uniform grid of cubic cells and only pairs
+ * spheres that share a cell, so the cost grows with the number of bodies and
+ * actual neighbours instead of all pairs.
+ *
+ * - Cell size: four times the median radius, so a typical sphere overlaps at
+ *   most two cells per axis whatever the absolute scale of the scene. Spheres
+ *   spanning more than MAX_CELL_SPAN cells per axis are kept out of the grid
+ *   and tested against everything, so a few large bodies do not flood it.
+ * - Storage: every (cell, body) entry is hashed into a table of buckets and
+ *   the entries are grouped by bucket with a counting sort (count, prefix sum,
+ *   scatter). Above PARALLEL_ENTRIES the count and scatter passes run on
+ *   several threads, each on its own slice; the result is identical to the
+ *   serial sort.
+ * - Uniqueness: two boxes usually share several cells. A pair is reported only
+ *   from the cell holding the lower corner of the boxes' intersection.
+ *
+ * The grid suits scenes of similar sized spheres. When radii vary widely no
+ * single cell size fits, and SweepAndPrune is the better choice: it keeps the
+ * bodies sorted by the lower bound of their boxes along one axis and carries
+ * that order from step to step. Bodies move little per step, so an insertion
+ * sort restores the order in close to linear time, and a sweep over the sorted
+ * list pairs every box with the boxes starting before its end, whatever their
+ * size. The sweep axis is the one along which the centres spread most.
+ *
+ * Both report pairs sorted by body index, matching the order of the former
+ * all-pairs loop, and hand them to the unchanged narrow phase (areColliding).
+ * Both can widen the boxes by a skin, for neighbour lists that stay valid
+ * while the bodies move less than half the skin (see NeighbourList).
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef BROAD_PHASE_H
+#define BROAD_PHASE_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "body.h"
+
+inline constexpr int MAX_CELL_SPAN = 4;                   ///< Larger bodies bypass the grid
+inline constexpr size_t PARALLEL_ENTRIES = 1 << 15;       ///< Entry count above which the sort runs threaded
+inline constexpr float AXIS_HYSTERESIS = 1.5f;            ///< Spread ratio needed to change the sweep axis
+
+class SpatialHash {
+public:
+    SpatialHash();
+
+    /**
+     * @brief Worker threads for large rebuilds (default: hardware concurrency).
+     */
+    void setThreads(unsigned threads);
+
+    /**
+     * @brief Rebuild the grid from the current positions and collect candidate pairs.
+     *
+     * Light sources take no part in contacts and are skipped. With start
+     * positions given, each box covers the sphere's whole sweep from there to
+     * its current position (for continuous collision detection).
+     *
+     * @param bodies All bodies of the simulation
+     * @param start Positions at the start of the step, one per body (optional)
+     * @param skin Extra distance at which pairs are reported (half of it per box)
+     */
+    void build(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start = {}, float skin = 0.0f);
+
+    /**
+     * @brief Candidate pairs (i, j), i < j, as indices into the bodies passed to build().
+     */
+    const std::vector<std::pair<uint32_t, uint32_t>>& getPairs() const;
+
+    float getCellSize() const;
+
+private:
+    struct Entry {
+        glm::ivec3 Cell;   ///< Grid cell
+        uint32_t Body;     ///< Index into the bodies vector
+    };
+
+    unsigned Threads;
+    float CellSize;
+
+    std::vector<glm::vec3> Lower, Upper;        ///< Bounding box per body (incl. contact tolerance)
+    std::vector<uint32_t> Oversized;            ///< Bodies tested against all others
+    std::vector<Entry> Entries;                 ///< (cell, body) pairs before sorting
+    std::vector<Entry> Sorted;                  ///< Entries grouped by bucket
+    std::vector<uint32_t> BucketStart;          ///< First entry of each bucket in Sorted (+ end)
+    std::vector<uint32_t> Counts;               ///< Per-thread bucket counters
+    std::vector<std::pair<uint32_t, uint32_t>> Pairs;
+
+    glm::ivec3 cellOf(const glm::vec3& point) const;
+
+    /**
+     * @brief Group Entries by bucket into Sorted/BucketStart (counting sort).
+     */
+    void sortEntries(size_t buckets);
+};
+
+class SweepAndPrune {
+public:
+    SweepAndPrune();
+
+    /**
+     * @brief Update the boxes, restore the sort order and collect candidate pairs.
+     *
+     * The order of the previous call is reused as long as the same bodies are
+     * passed in the same order; otherwise (bodies added, removed or reordered)
+     * the list is sorted from scratch. Light sources are skipped.
+     *
+     * @param bodies All bodies of the simulation
+     * @param start Positions at the start of the step for swept boxes (optional)
+     * @param skin Extra distance at which pairs are reported (half of it per box)
+     */
+    void build(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start = {}, float skin = 0.0f);
+
+    /**
+     * @brief Candidate pairs (i, j), i < j, as indices into the bodies passed to build().
+     */
+    const std::vector<std::pair<uint32_t, uint32_t>>& getPairs() const;
+
+    /**
+     * @brief Current sweep axis (0 = x, 1 = y, 2 = z).
+     */
+    int getAxis() const;
+
+    /**
+     * @brief Element moves made by the insertion sort of the last build (0 after a full sort).
+     */
+    size_t getSwaps() const;
+
+private:
+    int Axis;
+    size_t Swaps;
+
+    std::vector<Body*> Tracked;                 ///< Bodies the order belongs to
+    std::vector<uint32_t> Order;                ///< Body indices sorted by Lower[Axis]
+    std::vector<glm::vec3> Lower, Upper;        ///< Bounding box per body (incl. contact tolerance)
+    std::vector<std::pair<uint32_t, uint32_t>> Pairs;
+
+    /**
+     * @brief Axis of largest centre spread, keeping the current one unless beaten by AXIS_HYSTERESIS.
+     */
+    int chooseAxis(const std::vector<Body*>& bodies) const;
+
+    /**
+     * @brief Insertion sort of Order by the lower bound on the sweep axis.
+     */
+    void insertionSort();
+};
+
+#endif
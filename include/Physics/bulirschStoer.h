@@ -0,0 +1,119 @@
+/**
+ * @file bulirschStoer.h
+ * @author DotBox
+ * @brief Gragg–Bulirsch–Stoer extrapolation integrator
+ *
+ * Integrates a generic first order system y' = f(y) by repeatedly crossing one
+ * macro step H with Gragg's modified midpoint rule using an increasing number of
+ * substeps n = 2, 4, 6, ... and Richardson-extrapolating the results to n → ∞.
+ * The midpoint rule has an error expansion in even powers of the substep, so
+ * every extra column of the Neville tableau gains two orders of accuracy.
+ *
+ * Both the macro step and the extrapolation order (number of tableau columns)
+ * are chosen adaptively in the style of Deuflhard / Hairer's ODEX: the local
+ * error estimate is the difference between the two highest columns, and the
+ * order that minimises work per unit step is carried over to the next step.
+ *
+ * For smooth problems at tight tolerances (1e-10 .. 1e-13) this needs far fewer
+ * force evaluations than any fixed step scheme.
+ *
+ * The extrapolation works for any base method with an even error expansion, so
+ * step() also accepts a custom time-symmetric substepper (e.g. the leapfrog of
+ * the chain regularization in chain.h) in place of the modified midpoint rule.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef BULIRSCH_STOER_H
+#define BULIRSCH_STOER_H
+
+#include <vector>
+#include <functional>
+
+class BulirschStoer {
+public:
+    /// Right hand side of y' = f(y)
+    using Derivative = std::function<void(const std::vector<double>& y, std::vector<double>& dydt)>;
+
+    /// Symmetric base method: cross H from y0 with n equal substeps, result in y
+    using Substepper = std::function<void(const std::vector<double>& y0, double H, unsigned n, std::vector<double>& y)>;
+
+    /**
+     * @brief Construct with the default relative/absolute tolerance (1e-12).
+     */
+    BulirschStoer();
+
+    /**
+     * @brief Construct with a custom tolerance.
+     *
+     * @param tolerance Combined relative and absolute error tolerance per step
+     */
+    BulirschStoer(double tolerance);
+
+    void setTolerance(double tolerance);
+
+    /**
+     * @brief Advance y by exactly `interval`, subdividing it into adaptive steps.
+     *
+     * The step size and order reached at the end of the interval are kept and
+     * used as the first guess on the next call, so repeated calls with a fixed
+     * frame interval cost no more than one long call.
+     *
+     * @param f Right hand side of the ODE
+     * @param y State vector, overwritten with the state at the end of the interval
+     * @param interval Length of the interval to integrate over
+     * @return false if the step size fell below MIN_STEP times the interval
+     *         (y is left at the last accepted step and the history is reset)
+     */
+    bool integrate(const Derivative& f, std::vector<double>& y, double interval);
+
+    /**
+     * @brief Attempt one extrapolated macro step built on a custom base method.
+     *
+     * The caller owns the step size loop; order selection is still adaptive.
+     *
+     * @param base Time-symmetric base method (error expansion in even powers)
+     * @param y State, advanced by H if the step is accepted
+     * @param H Macro step size
+     * @param hNext Receives the suggested next step size (smaller retry on rejection)
+     * @return true if accepted, false if rejected (y untouched)
+     */
+    bool step(const Substepper& base, std::vector<double>& y, double H, double& hNext);
+
+    /**
+     * @brief Forget step size and order history (e.g. after a discontinuity).
+     */
+    void reset();
+
+    /// Number of right hand side evaluations since construction
+    unsigned long getEvaluations() const;
+
+private:
+    static constexpr unsigned MAX_COLUMNS = 8;   ///< Rows of the extrapolation tableau
+    static constexpr double MIN_STEP = 1e-12;    ///< Smallest macro step, relative to the interval of integrate()
+
+    double Tolerance;           ///< Error tolerance per step
+    double StepSize;            ///< Suggested next macro step (0 = unknown)
+    unsigned Order;             ///< Target tableau row for the next step
+    unsigned long Evaluations;  ///< Right hand side evaluation counter
+
+    std::vector<std::vector<double>> Table;  ///< Extrapolation tableau (current row only per column)
+    std::vector<double> dydt0;               ///< Derivative at the start of the step
+    std::vector<double> zPrev, zCurr, dz;    ///< Modified midpoint scratch buffers
+
+    /**
+     * @brief Gragg's modified midpoint rule with n substeps across H.
+     *
+     * Uses the derivative at y0 cached in dydt0 for the first substep.
+     */
+    void modifiedMidpoint(const Derivative& f, const std::vector<double>& y0, double H, unsigned n, std::vector<double>& out);
+
+    /**
+     * @brief Scaled RMS norm of the difference between two tableau entries.
+     */
+    double errorNorm(const std::vector<double>& y0, const std::vector<double>& a, const std::vector<double>& b) const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file ccd.h
+ * @author DotBox
+ * @brief Continuous collision detection: time of impact of swept spheres
+ *
+ * The discrete contact tests (areColliding, onSurface) only look at the
+ * positions at the end of a step. Two spheres whose relative displacement in
+ * one step exceeds the sum of their radii pass through each other unnoticed,
+ * and a bounce on a collider face is applied at the end of the step instead of when
+ * the sphere actually touched it, so the rebound height depends on dt.
+ *
+ * Here each sphere is swept along the straight segment from its position at
+ * the start of the step to its position at the end (exact for the Euler drift,
+ * the chord of the arc for the other integrators), and the first time of
+ * contact is solved for in closed form:
+ *
+ * - Sphere pair: the relative centre d(s) = d₀ + s Δ is linear in the step
+ *   fraction s, so |d(s)|² = (r₁ + r₂)² is a quadratic in s.
+ * - Plane: the signed distance of the centre is linear in s (ColliderSet
+ *   faces also check that the contact point lies within the face).
+ *
+ * Times are step fractions in [0, 1]. Only approaching configurations that
+ * start apart produce an impact; spheres already touching at the start of
+ * the sweep are left to the discrete test.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef CCD_H
+#define CCD_H
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief First contact of two spheres moving linearly over the step.
+ *
+ * @param startOne Centre of the first sphere at s = 0
+ * @param endOne Centre of the first sphere at s = 1
+ * @param startTwo Centre of the second sphere at s = 0
+ * @param endTwo Centre of the second sphere at s = 1
+ * @param radius Sum of the radii
+ * @param s Receives the step fraction of the first contact
+ * @return true if the spheres start apart and touch within the step
+ */
+bool sphereImpact(const glm::vec3& startOne, const glm::vec3& endOne, const glm::vec3& startTwo, const glm::vec3& endTwo, float radius, float& s);
+
+/**
+ * @brief First contact of a sphere moving linearly over the step with a plane.
+ *
+ * The sphere must start on the side the normal points to.
+ *
+ * @param start Centre at s = 0
+ * @param end Centre at s = 1
+ * @param radius Sphere radius
+ * @param point Any point of the plane
+ * @param normal Unit normal of the plane (towards the free side)
+ * @param s Receives the step fraction of the first contact
+ * @return true if the sphere starts clear of the plane and reaches it within the step
+ */
+bool planeImpact(const glm::vec3& start, const glm::vec3& end, float radius, const glm::vec3& point, const glm::vec3& normal, float& s);
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file chain.h
+ * @author DotBox
+ * @brief Algorithmic chain regularization (AR-chain) for compact subsystems
+ *
+ * KS regularization (regularization.h) handles one close pair at a time. A
+ * compact triple or small cluster (resonant interplay, democratic encounters)
+ * keeps producing close approaches between changing pairs, so all pairwise
+ * singularities have to be tamed at once. This module implements the
+ * algorithmic regularization of Mikkola & Tanikawa / Mikkola & Aarseth:
+ *
+ * 1. Chain coordinates: the bodies are ordered into a chain that links each
+ *    body to its nearest unlinked neighbour, and the state is expressed as
+ *    the chain vectors Xₖ = r(cₖ₊₁) - r(cₖ) and their velocities Wₖ. Close
+ *    separations are then small differences of small numbers instead of big
+ *    differences of big ones, which keeps round-off under control. Pairs up to
+ *    two links apart take their separations from chain sums.
+ *
+ * 2. Time transformation (logarithmic Hamiltonian): with U the force function
+ *    and B = -E the binding energy, a leapfrog in fictitious time s uses
+ *      drift:  dt = Δs / (T + B),   r += v dt
+ *      kick:   dt = Δs / U,         v += a dt
+ *    This leapfrog follows Keplerian collisions exactly and is time symmetric.
+ *
+ * 3. GBS extrapolation: the symmetric leapfrog is used as the base method of the
+ *    Bulirsch–Stoer extrapolator, giving high accuracy at large steps in s.
+ *
+ * The chain is rebuilt after every accepted macro step, and the physical time
+ * interval requested is hit exactly by secant iteration on the final step.
+ *
+ * ChainSubsystem embeds the integrator in the main force loop the same way a
+ * RegularizedPair does: members only feel external forces there, and their
+ * internal motion is advanced by the chain integrator afterwards.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef CHAIN_H
+#define CHAIN_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "body.h"
+#include "Physics/state.h"
+#include "Physics/bulirschStoer.h"
+
+inline constexpr size_t MAX_CHAIN_BODIES = 10;   ///< Largest subsystem handed to the chain integrator
+
+class ChainIntegrator {
+public:
+    /**
+     * @brief Construct with the default tolerance (1e-12).
+     */
+    ChainIntegrator();
+
+    void setTolerance(double tolerance);
+
+    /**
+     * @brief Advance an isolated subsystem by exactly `interval`.
+     *
+     * Only the mutual forces of the bodies in the state are included; the
+     * centre of mass moves uniformly.
+     *
+     * @param state Subsystem state (2..MAX_CHAIN_BODIES bodies), advanced in place
+     * @param interval Physical time to advance by
+     */
+    void integrate(SystemState& state, double interval);
+
+    /**
+     * @brief Nearest-neighbour chain ordering of the bodies.
+     *
+     * Starts from the closest pair and repeatedly attaches the unused body
+     * closest to either end of the chain.
+     */
+    static std::vector<size_t> buildChain(const SystemState& state);
+
+private:
+    BulirschStoer Extrapolator;     ///< GBS extrapolation over the leapfrog
+    double StepSize;                ///< Suggested next step in fictitious time (0 = unknown)
+
+    // Fixed for the duration of one integrate() call
+    std::vector<size_t> Chain;      ///< Body index at each chain position
+    std::vector<double> Mass;       ///< Masses in chain order
+    double Binding;                 ///< B = -E, constant for an isolated subsystem
+
+    /**
+     * @brief Pack chain vectors, chain velocities and time into a flat vector.
+     */
+    void pack(const SystemState& state, std::vector<double>& y) const;
+
+    /**
+     * @brief Restore positions/velocities (centre of mass frame) from a flat vector.
+     */
+    void unpack(const std::vector<double>& y, std::vector<glm::dvec3>& pos, std::vector<glm::dvec3>& vel) const;
+
+    /**
+     * @brief Logarithmic Hamiltonian leapfrog (DKD) with n substeps across H.
+     */
+    void leapfrog(const std::vector<double>& y0, double H, unsigned n, std::vector<double>& y) const;
+
+    void drift(std::vector<double>& y, double ds) const;
+    void kick(std::vector<double>& y, double ds) const;
+
+    /**
+     * @brief Accelerations (chain order) and force function U from a flat state.
+     */
+    double accelerations(const std::vector<double>& y, std::vector<glm::dvec3>& acc) const;
+};
+
+class ChainSubsystem {
+public:
+    ChainSubsystem(const std::vector<Body*>& members);
+
+    std::vector<Body*> Members;   ///< Bodies of the subsystem
+    Body* Last;                   ///< Member moved last by the force loop
+
+    bool contains(const Body* body) const;
+
+    /**
+     * @brief Record member positions at the start of the frame.
+     */
+    void begin();
+
+    /**
+     * @brief Replace the internal motion of the members by the chain solution.
+     *
+     * @param interval Length of the frame (dt)
+     */
+    void finish(double interval);
+
+private:
+    ChainIntegrator Integrator;             ///< Keeps its step history between frames
+    std::vector<glm::dvec3> StartPosition;  ///< Member positions at the start of the frame
+};
+
+#endif
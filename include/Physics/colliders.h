@@ -0,0 +1,134 @@
+/**
+ * @file colliders.h
+ * @author DotBox
+ * @brief Static plane and box colliders tested with a vectorized distance kernel
+ *
+ * The floor used to be a hard-coded plane at y = -2 while the walls drawn by
+ * the renderer were visual only. A ColliderSet holds any number of static
+ * planes, each a face n·x = d with
+ *
+ * - a side: one-sided faces push bodies back to the side the normal points to
+ *   (solid ground, box faces), two-sided faces act as thin sheets and keep a
+ *   body on whichever side it is,
+ * - an extent: the face only acts where the sphere centre lies inside its
+ *   bounds (infinite for planes, the quad for surfaces, the face rectangle for
+ *   boxes),
+ * - a depth: how far behind a one-sided face a centre may be and still be
+ *   pushed out through it (infinite for ground planes, half the box for box
+ *   faces, so a sphere inside a box leaves through the nearest face).
+ *
+ * Surfaces are converted from their Surface3D orientation, distance and size,
+ * so the colliders match what is rendered. Boxes become six one-sided faces.
+ *
+ * The faces are stored as structure of arrays and tested against all bodies
+ * plane by plane over contiguous coordinate arrays, a branch-free loop the
+ * compiler vectorizes, so a container with many walls costs a few SIMD passes
+ * over the bodies.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef COLLIDERS_H
+#define COLLIDERS_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "body.h"
+
+class ColliderSet {
+public:
+    ColliderSet();
+
+    /**
+     * @brief Infinite one-sided plane (e.g. the ground).
+     *
+     * @param point Any point of the plane
+     * @param normal Direction of the free side
+     * @return Index of the face
+     */
+    size_t addPlane(const glm::vec3& point, const glm::vec3& normal);
+
+    /**
+     * @brief Face matching a rendered surface (quad of its size on its plane).
+     *
+     * @param surface Geometry of the surface
+     * @param side +1 / -1: one-sided, free towards the positive / negative axis; 0: two-sided
+     * @return Index of the face
+     */
+    size_t addSurface(const Surface3D& surface, int side = 0);
+
+    /**
+     * @brief Solid axis-aligned box (six one-sided faces).
+     */
+    void addBox(const glm::vec3& lower, const glm::vec3& upper);
+
+    void clear();
+
+    size_t size() const;
+
+    bool empty() const;
+
+    /**
+     * @brief Collect every (body, face) contact (vectorized kernel).
+     *
+     * A body touches a face when its surface is within EPSILON of it on the
+     * acting side (or behind a one-sided face, up to its depth) and its centre
+     * lies inside the face bounds. Light sources and sleeping bodies are
+     * skipped.
+     *
+     * @param bodies All bodies of the simulation
+     * @param contacts Receives (body index, face index) pairs in body order
+     */
+    void findContacts(const std::vector<Body*>& bodies, std::vector<std::pair<uint32_t, uint32_t>>& contacts);
+
+    /**
+     * @brief True if a sphere touches any face (scalar version of the kernel).
+     */
+    bool touches(const glm::vec3& position, float radius) const;
+
+    /**
+     * @brief Orientation of a face as seen from a body.
+     *
+     * @param face Face index
+     * @param position Sphere centre
+     * @param normal Receives the unit normal towards the free side
+     * @param offset Receives d in normal·x = d
+     */
+    void facing(size_t face, const glm::vec3& position, glm::vec3& normal, float& offset) const;
+
+    /**
+     * @brief First contact of a sphere moving linearly over the step with a face.
+     *
+     * @param face Face index
+     * @param start Centre at s = 0
+     * @param end Centre at s = 1
+     * @param radius Sphere radius
+     * @param s Receives the step fraction of the contact
+     * @return true if the sphere starts clear and reaches the face inside its bounds
+     */
+    bool sweep(size_t face, const glm::vec3& start, const glm::vec3& end, float radius, float& s) const;
+
+private:
+    // Faces, structure of arrays
+    std::vector<float> NormalX, NormalY, NormalZ;   ///< Unit normal (free side for one-sided faces)
+    std::vector<float> Offset;                      ///< d in n·x = d
+    std::vector<int> Sided;                         ///< 1 one-sided, 0 two-sided
+    std::vector<float> Depth;                       ///< Deepest centre still pushed out (one-sided)
+    std::vector<float> LowerX, LowerY, LowerZ;      ///< Bounds of the centre for the face to act
+    std::vector<float> UpperX, UpperY, UpperZ;
+
+    // Body coordinates gathered for the kernel
+    std::vector<float> BodyX, BodyY, BodyZ, BodyRadius;
+    std::vector<uint32_t> BodyIndex;
+    std::vector<uint8_t> Hits;
+
+    size_t addFace(const glm::vec3& normal, float offset, bool sided, float depth, const glm::vec3& lower, const glm::vec3& upper);
+
+    bool inside(size_t face, const glm::vec3& position) const;
+};
+
+#endif
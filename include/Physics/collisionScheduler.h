@@ -0,0 +1,87 @@
+/**
+ * @file collisionScheduler.h
+ * @author DotBox
+ * @brief Time-of-impact priority queue for event-driven collision handling
+ *
+ * Event-driven (hard sphere) dynamics moves the bodies on their free paths
+ * from one collision straight to the next instead of testing for overlaps at
+ * fixed intervals. Predicted impacts wait in a min-heap ordered by time. A
+ * collision changes the paths of its two bodies and with them every impact
+ * predicted for either one; rather than searching the heap for those, each
+ * body carries a collision counter that is stored with every prediction and
+ * bumped when the body collides. A popped event whose counters no longer
+ * match is stale and dropped (lazy invalidation), so scheduling and
+ * invalidating both cost O(log n).
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef COLLISION_SCHEDULER_H
+#define COLLISION_SCHEDULER_H
+
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <cstddef>
+
+inline constexpr uint32_t SCHEDULE_SURFACE = UINT32_MAX;   ///< Partner index of a collider contact
+inline constexpr size_t MAX_EVENTS_PER_BODY = 64;          ///< Event budget per body and step (guards against Zeno cascades)
+inline constexpr int MAX_SWEEP_ROUNDS = 8;                 ///< Broad phase passes per step over the deflected paths
+
+struct CollisionEvent {
+    float Time;          ///< Step fraction of the impact
+    uint32_t One;        ///< Index of the first body
+    uint32_t Two;        ///< Index of the second body, or SCHEDULE_SURFACE
+    uint32_t Pair;       ///< Caller's identifier of the candidate (e.g. broad phase pair index)
+    uint32_t CountOne;   ///< Collision counter of One at prediction time
+    uint32_t CountTwo;   ///< Collision counter of Two at prediction time
+};
+
+class CollisionScheduler {
+public:
+    CollisionScheduler();
+
+    /**
+     * @brief Empty the queue and reset the counters for a new step.
+     *
+     * @param bodies Number of bodies that can take part
+     */
+    void reset(size_t bodies);
+
+    /**
+     * @brief Queue a predicted impact of two bodies (or of One with a collider face).
+     */
+    void schedule(float time, uint32_t one, uint32_t two, uint32_t pair);
+
+    /**
+     * @brief Mark every queued prediction involving a body as stale.
+     */
+    void invalidate(uint32_t body);
+
+    /**
+     * @brief Pop the earliest prediction that is still valid.
+     *
+     * @param event Receives the event
+     * @return false once no valid prediction is left
+     */
+    bool next(CollisionEvent& event);
+
+    size_t getProcessed() const;   ///< Valid events handed out since reset()
+    size_t getStale() const;       ///< Invalidated events dropped since reset()
+
+private:
+    struct Later {
+        bool operator()(const CollisionEvent& a, const CollisionEvent& b) const {
+            return a.Time > b.Time || (a.Time == b.Time && a.Pair > b.Pair);
+        }
+    };
+
+    std::priority_queue<CollisionEvent, std::vector<CollisionEvent>, Later> Queue;
+    std::vector<uint32_t> Counts;    ///< Collision counter per body
+    size_t Processed;
+    size_t Stale;
+};
+
+#endif
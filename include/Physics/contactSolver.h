@@ -0,0 +1,141 @@
+/**
+ * @file contactSolver.h
+ * @author DotBox
+ * @brief Sequential impulse contact solver with a persistent, warm-started contact cache
+ *
+ * The elastic response resolves each contact once per step from scratch. In a
+ * resting pile every sphere presses on several neighbours at once; fixing one
+ * contact pushes into the next, so the pile jitters unless the step is cut
+ * into many substeps. The sequential impulse method instead looks for the
+ * normal impulse λ ≥ 0 of every contact such that, after all of them are
+ * applied, no contact is still approaching. It sweeps over the contacts a few
+ * times, each time correcting the accumulated λ of one contact:
+ *
+ *   Δλ = m_eff · (target − vn),  λ ← max(λ + Δλ, 0),  m_eff = 1 / (1/m₁ + 1/m₂)
+ *
+ * with vn the current normal velocity of the contact and target the speed it
+ * should separate with (restitution for impacts, zero for resting contacts).
+ *
+ * From one step to the next the contacts of a settled pile and their impulses
+ * hardly change. The accumulated impulse of every contact is kept in a cache
+ * keyed by the body handles of the pair (body and face index for colliders);
+ * a contact that is found again starts from its impulse of the last step
+ * (warm start) instead of zero, so one or two sweeps suffice where a cold
+ * start needs many. Contacts that have come apart drop out of the cache.
+ *
+ * The position pass can open a resting contact by a hair, which would
+ * make it new (and cold, and bouncing) again in the next step. Pairs that were
+ * in contact and are apart by less than CONTACT_MARGIN are kept as speculative
+ * contacts: they may close the gap within the step but push only once it is
+ * closed, and keep their cached impulse.
+ *
+ * Overlap is removed by moving the bodies directly (split by inverse mass,
+ * a small CONTACT_SLOP is left so that resting contacts persist) rather than
+ * through the velocities, so position correction adds no energy. Sleeping
+ * bodies take part with infinite mass, as do the collider faces.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef CONTACT_SOLVER_H
+#define CONTACT_SOLVER_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "body.h"
+#include "Physics/colliders.h"
+#include "Physics/contactGraph.h"
+
+inline constexpr float SPHERE_RESTITUTION = 1.0f;       ///< Sphere-sphere impacts are elastic, as in the default response
+inline constexpr float SURFACE_RESTITUTION = 0.8f;      ///< Fraction of the normal speed kept off a collider face
+inline constexpr float RESTING_SPEED = 0.1f;            ///< Approach speed below which a contact does not bounce
+inline constexpr float CONTACT_SLOP = 1e-3f;            ///< Overlap left in place so resting contacts persist
+inline constexpr float CONTACT_MARGIN = 1e-2f;          ///< Gap up to which a resting contact is kept
+inline constexpr int CONTACT_ITERATIONS = 2;            ///< Default sweeps over the contacts per step
+
+class ContactSolver {
+public:
+    ContactSolver();
+
+    /**
+     * @brief Sweeps over the contacts per step (at least 1).
+     */
+    void setIterations(int iterations);
+
+    int getIterations() const;
+
+    /**
+     * @brief Use the cached impulses as the starting point (on by default).
+     */
+    void setWarmStart(bool enabled);
+
+    /**
+     * @brief Resolve the contacts of one step and remember their impulses.
+     *
+     * @param bodies All bodies of the simulation
+     * @param pairs Sphere pairs (i, j) as indices into the bodies, touching or within CONTACT_MARGIN
+     * @param surface Collider contacts (body, face)
+     * @param colliders Collider set the faces belong to
+     * @param graph Colouring of the sphere contacts into independent batches (rebuilt here)
+     * @param step Time step the velocities act over
+     */
+    void solve(const std::vector<Body*>& bodies,
+               const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+               const std::vector<std::pair<uint32_t, uint32_t>>& surface,
+               const ColliderSet& colliders, ContactGraph& graph, float step);
+
+    /**
+     * @brief Forget every cached impulse.
+     */
+    void clear();
+
+    /**
+     * @brief Contacts of the last step that started from a cached impulse.
+     */
+    size_t getWarmStarted() const;
+
+    /**
+     * @brief Contacts of the last step (size of the cache).
+     */
+    size_t getCached() const;
+
+private:
+    /// Body handles of a contact; Face is NO_FACE for sphere pairs
+    struct Key {
+        const Body* One;
+        const Body* Two;
+        uint32_t Face;
+
+        bool operator<(const Key& other) const;
+        bool operator==(const Key& other) const;
+    };
+
+    struct Contact {
+        uint32_t One;           ///< Index of the first body (the only one for a face)
+        uint32_t Two;           ///< Index of the second body, or of the face
+        glm::vec3 Normal;       ///< From one to two, or the face normal towards the body
+        float Mass;             ///< Effective mass along the normal
+        float Target;           ///< Normal speed to separate with
+        float Impulse;          ///< Accumulated normal impulse
+    };
+
+    static constexpr uint32_t NO_FACE = UINT32_MAX;
+
+    int Iterations;
+    bool WarmStart;
+    size_t WarmStarted;
+
+    std::vector<std::pair<Key, float>> Cache;   ///< Accumulated impulses of the last step, sorted by key
+    std::vector<Contact> Pairs;
+    std::vector<std::pair<uint32_t, uint32_t>> Links;  ///< Bodies of each sphere contact, for the colouring
+    std::vector<Contact> Faces;
+
+    float cached(const Key& key) const;
+};
+
+#endif
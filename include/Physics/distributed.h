@@ -0,0 +1,192 @@
+/**
+ * @file distributed.h
+ * @author DotBox
+ * @brief Domain-decomposed large-N simulation over MPI ranks
+ *
+ * Scenes of millions of bodies do not fit the engine of one process: the
+ * pairwise sum is O(N²) and the memory of one node runs out. The distributed
+ * system spreads the bodies over the MPI ranks of a communicator, each rank
+ * owning the bodies of one region of space, and advances them together with
+ * a kick-drift-kick leapfrog of fixed step in double precision.
+ *
+ * - Decomposition: orthogonal recursive bisection (ORB). The set of ranks is
+ *   halved, and space is cut across its longest extent at the position that
+ *   splits the work of the bodies in the same proportion; both halves are
+ *   cut again until every rank has a region. The cut positions are found by
+ *   bisection, with one reduction over all ranks per step of every cut of a
+ *   level. The work of a body is the number of interactions of its last force
+ *   evaluation, so dense regions get smaller domains.
+ * - Migration: after every drift, bodies that crossed a cut are sent to the
+ *   rank owning their new position (one all-to-all exchange).
+ * - Gravity: every rank builds the Barnes-Hut octree of its own bodies (see
+ *   octree.h) and sends each other rank the locally essential tree of that
+ *   rank's bounding box: distant cubes as single masses, the bodies of nearby
+ *   leaves as they are. The imported masses and the local bodies go into one
+ *   tree, which gives the forces on the local bodies.
+ * - Collisions: every rank receives ghost copies of the remote bodies that
+ *   come within touching distance of its bounding box (halo exchange) and
+ *   resolves the contacts of its bodies with each other and with the ghosts.
+ *   The impulse (restitution SPHERE_RESTITUTION) and overlap correction of
+ *   every contact are computed from the state at the start of the pass and
+ *   summed, with the lower body id first. So the two ranks of a pair split
+ *   across a cut see the same numbers, and each updates its own body.
+ * - Rebalancing: after every step the work of the ranks is compared. When
+ *   the ratio of the busiest rank to the mean has grown past the threshold
+ *   times its value right after the last redraw (which is above 1 when there
+ *   are too few bodies to split evenly), the cuts are redrawn from the
+ *   current work and the bodies migrate.
+ *
+ * All members that take part in communication are collective: every rank of
+ * the communicator has to call them together.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef DISTRIBUTED_H
+#define DISTRIBUTED_H
+
+#include <mpi.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include "Physics/octree.h"
+
+inline constexpr double DISTRIBUTED_IMBALANCE = 1.2;    ///< Default growth of the max / mean work that triggers a rebalance
+inline constexpr int ORB_ITERATIONS = 48;               ///< Bisection steps per cut
+
+/// A body of the distributed system
+struct Particle {
+    glm::dvec3 Position;
+    glm::dvec3 Velocity;
+    glm::dvec3 Acceleration;    ///< Of the last force evaluation
+    double Mass;
+    double Radius;              ///< 0: takes no part in collisions
+    double Potential;           ///< Per unit mass, of the last force evaluation
+    double Cost;                ///< Interactions of the last force evaluation: the weight of the decomposition
+    uint64_t Id;                ///< Unique over all ranks
+};
+
+/// Totals over all ranks of the last step
+struct DistributedStats {
+    uint64_t Bodies = 0;
+    uint64_t Imported = 0;      ///< Masses received as locally essential trees
+    uint64_t Ghosts = 0;        ///< Bodies received as halos
+    uint64_t Migrated = 0;      ///< Bodies that changed rank
+    uint64_t Contacts = 0;      ///< Touching pairs
+    uint64_t Rebalances = 0;    ///< Since initialize()
+    double Imbalance = 1.0;     ///< Max over mean of the work of the ranks
+};
+
+class DistributedSystem {
+public:
+    explicit DistributedSystem(MPI_Comm comm = MPI_COMM_WORLD);
+    ~DistributedSystem();
+
+    DistributedSystem(const DistributedSystem&) = delete;
+    DistributedSystem& operator=(const DistributedSystem&) = delete;
+
+    /**
+     * @brief Fixed integration step (s).
+     */
+    void setStep(double step);
+
+    /**
+     * @brief Opening angle of the gravity trees.
+     */
+    void setTheta(double theta);
+
+    /**
+     * @brief Plummer softening length of the gravity (0: none).
+     */
+    void setSoftening(double softening);
+
+    /**
+     * @brief Growth of the max over mean work of the ranks, since the last redraw, that redraws the domains.
+     */
+    void setImbalance(double threshold);
+
+    /**
+     * @brief Threads per rank for the force evaluation (default 1: the ranks are the parallelism).
+     */
+    void setThreads(unsigned threads);
+
+    /**
+     * @brief Bodies owned by this rank. Fill them (on any rank) before initialize().
+     */
+    std::vector<Particle>& getParticles();
+
+    /**
+     * @brief Decompose, distribute the bodies and compute the first forces (collective).
+     */
+    void initialize();
+
+    /**
+     * @brief Advance every body by one step (collective).
+     */
+    void step();
+
+    /**
+     * @brief Kinetic and potential energy and momentum over all ranks (collective).
+     */
+    void totals(double& kinetic, double& potential, glm::dvec3& momentum) const;
+
+    double getTime() const;
+
+    const DistributedStats& getStats() const;
+
+    int getRank() const;
+
+    int getRanks() const;
+
+private:
+    /// Node of the ORB tree: Count ranks from First, cut in two unless Count is 1
+    struct Domain {
+        int First;
+        int Count;
+        int Axis;
+        double Cut;
+        int Lower;
+        int Upper;
+    };
+
+    /// Bounding box of the bodies of a rank and their largest radius (empty: Lower > Upper)
+    struct Box {
+        glm::dvec3 Lower;
+        glm::dvec3 Upper;
+        double Radius;
+    };
+
+    MPI_Comm Comm;
+    MPI_Datatype ParticleType;
+    MPI_Datatype MassType;
+    int Rank;
+    int Ranks;
+
+    double Step;
+    double Imbalance;
+    unsigned Threads;
+    double Time;
+
+    std::vector<Particle> Local;
+    std::vector<Particle> Ghosts;
+    std::vector<Domain> Domains;
+    std::vector<Box> Boxes;
+    Octree Tree;
+    DistributedStats Stats;
+    uint64_t Imported;
+    double Balanced;                ///< Imbalance right after the last redraw
+
+    int owner(const glm::dvec3& position) const;
+    void decompose();
+    size_t migrate();
+    void exchangeBoxes();
+    void exchangeHalo();
+    size_t collide();
+    void computeForces();
+    void balance(size_t migrated, size_t contacts);
+};
+
+#endif
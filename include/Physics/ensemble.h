@@ -0,0 +1,140 @@
+/**
+ * @file ensemble.h
+ * @author DotBox
+ * @brief Many independent three-body systems integrated side by side, one per SIMD lane
+ *
+ * Sweeps over initial conditions run thousands of small, independent systems.
+ * Simulated one scene at a time, each step of a three-body system is three
+ * pair forces: far too little work to fill a vector unit, let alone a core.
+ * The ensemble engine turns the problem around: a block of ENSEMBLE_LANES
+ * systems is stored as structure of arrays (x of body 0 for every system,
+ * then x of body 1, ...), and every loop of the step runs over the systems,
+ * so each SIMD lane advances a different system with exactly the same
+ * instructions.
+ *
+ * - Integrator: kick-drift-kick leapfrog with a fixed step in double
+ *   precision (symplectic, so long sweeps show no secular energy drift),
+ *   plain Newtonian gravity without softening or clamping. The last step of
+ *   each system is shortened to land exactly on the duration.
+ * - Termination: each lane carries an activity mask. A lane stops when two
+ *   of its bodies come within the collision distance, or touch when radii
+ *   are given (checked every step), when a body escapes (further than the
+ *   escape radius from the centre of mass of the other two, receding, with
+ *   positive energy relative to them; checked every ENSEMBLE_CHECK steps),
+ *   or at the end of the duration.
+ *   Stopped lanes keep their state and take zero-length steps, so the loops
+ *   stay branch-free.
+ * - Harvest and refill: every ENSEMBLE_CHECK steps the stopped lanes of a
+ *   block are harvested (outcome, time and final state handed to the
+ *   caller) and loaded with the next systems of the queue, so the lanes stay
+ *   busy until the queue runs dry.
+ * - Threads: every worker thread owns one block and takes systems from a
+ *   shared queue, so all cores stay busy whatever the spread of run times.
+ *
+ * Results do not depend on the number of threads or on which lane a system
+ * lands in; only the order in which they are harvested does.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef ENSEMBLE_H
+#define ENSEMBLE_H
+
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include "Physics/state.h"
+
+inline constexpr size_t ENSEMBLE_LANES = 64;    ///< Systems per block (a multiple of any SIMD width)
+inline constexpr int ENSEMBLE_CHECK = 16;       ///< Steps between escape checks and harvests
+inline constexpr int ENSEMBLE_BODIES = 3;       ///< Bodies per system
+inline constexpr double ENSEMBLE_MIN_STEP = 1e-6;   ///< Smallest step setStep() accepts (s)
+
+/// Why a system stopped (scoped: the names are too common to put in the global namespace)
+enum class ensembleOutcome {
+    TIMED_OUT,  ///< Reached the end of the duration
+    COLLIDED,   ///< Two bodies came within the collision distance
+    ESCAPED     ///< One body left the other two for good
+};
+
+struct EnsembleResult {
+    size_t System;              ///< Index of the system in the initial conditions
+    ensembleOutcome Outcome;    ///< Why it stopped
+    int Body;                   ///< Escaping body (ESCAPED), the body not in the colliding pair (COLLIDED), or -1
+    SystemState Final;          ///< State when it stopped; Final.Time is the time of the stop
+};
+
+using EnsembleHarvest = std::function<void(const EnsembleResult& result)>;
+
+class Ensemble {
+public:
+    Ensemble();
+
+    /**
+     * @brief Fixed integration step (s), at least ENSEMBLE_MIN_STEP.
+     */
+    void setStep(double step);
+
+    /**
+     * @brief Time after which a system stops with TIMED_OUT (s).
+     */
+    void setDuration(double duration);
+
+    /**
+     * @brief Distance between centres below which a pair has collided (0 disables).
+     */
+    void setCollisionDistance(double distance);
+
+    /**
+     * @brief Radii of the three bodies: each pair collides at the sum of its radii, instead of the collision distance.
+     *
+     * Shared by every system. Anything but ENSEMBLE_BODIES radii goes back to the collision distance.
+     */
+    void setRadii(const std::vector<double>& radii);
+
+    /**
+     * @brief Distance from the other two beyond which a receding, unbound body has escaped (0 disables).
+     */
+    void setEscapeRadius(double radius);
+
+    /**
+     * @brief Worker threads (default: hardware concurrency).
+     */
+    void setThreads(unsigned threads);
+
+    /**
+     * @brief Integrate every system until it stops and hand over the results.
+     *
+     * @param systems Initial conditions, three bodies each (Time is the start time)
+     * @param harvest Called once per system as it stops, from the worker
+     *                threads but never concurrently
+     */
+    void run(const std::vector<SystemState>& systems, const EnsembleHarvest& harvest);
+
+    /**
+     * @brief Integrate every system until it stops.
+     *
+     * @return Results in the order of the systems
+     */
+    std::vector<EnsembleResult> run(const std::vector<SystemState>& systems);
+
+    /**
+     * @brief Fraction of the lane steps of the last run that advanced a system.
+     */
+    double getUtilization() const;
+
+private:
+    double Step;
+    double Duration;
+    double CollisionDistance;
+    std::vector<double> Radii;  ///< Per body (empty: CollisionDistance for every pair)
+    double EscapeRadius;
+    unsigned Threads;
+
+    size_t LaneSteps;       ///< Lane steps taken in the last run, busy or not
+    size_t BusySteps;       ///< Of which advanced a system
+};
+
+#endif
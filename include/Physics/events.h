@@ -0,0 +1,129 @@
+/**
+ * @file events.h
+ * @author DotBox
+ * @brief Event detection by root finding on dense output
+ *
+ * An event is the zero crossing of a scalar function g(state): a pair reaching
+ * a given separation, a body's energy turning positive (escape), a body passing
+ * through a plane (boundaries, Poincaré sections). Checking g only at step
+ * boundaries misses crossings that happen and undo themselves inside a step,
+ * and locates the others no better than to one dt. Here every step is scanned
+ * on a few interior sample points of the dense output (the Taylor series, or a
+ * cubic Hermite interpolant of positions and velocities otherwise), and each
+ * sign change is refined with the Illinois variant of regula falsi to the
+ * exact event time. Callbacks receive the interpolated state at that time.
+ *
+ * Body indices in the event functions refer to the order of the state the
+ * detector is fed with (for Physics: the non-source bodies in scene order).
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <vector>
+#include <functional>
+#include <glm/glm.hpp>
+#include "Physics/state.h"
+
+/// Which zero crossings of an event function count
+enum eventDirection {
+    FALLING = -1,   ///< g goes from positive to negative
+    EITHER  = 0,    ///< Any sign change
+    RISING  = 1     ///< g goes from negative to positive
+};
+
+using EventFunction = std::function<double(const SystemState& state)>;
+using EventCallback = std::function<void(const SystemState& state)>;
+
+/// State of the system at time t inside the current step
+using Interpolator = std::function<void(double t, SystemState& out)>;
+
+struct Event {
+    EventFunction Function;             ///< g(state); the event happens where g crosses zero
+    eventDirection Direction = EITHER;  ///< Crossings that trigger the event
+    bool Terminal = false;              ///< Stop the simulation at the event
+    EventCallback Callback;             ///< Called with the state at the event time (optional)
+};
+
+class EventDetector {
+public:
+    EventDetector();
+
+    /**
+     * @brief Register an event.
+     *
+     * @return Identifier for remove()
+     */
+    size_t add(const Event& event);
+
+    void remove(size_t id);
+
+    void clear();
+
+    bool empty() const;
+
+    /**
+     * @brief Number of subintervals per step scanned for sign changes (default 4).
+     *
+     * More samples catch crossings that enter and leave within a short part of
+     * the step (grazing close approaches) at the cost of more interpolations.
+     */
+    void setSamples(unsigned samples);
+
+    /**
+     * @brief Find and fire the events between two states.
+     *
+     * Events fire in time order. Scanning stops at the first terminal event,
+     * whose state is returned in `terminal`.
+     *
+     * @param start State at the start of the step (Time set)
+     * @param end State at the end of the step (Time set)
+     * @param interpolate Dense output valid over [start.Time, end.Time]
+     * @param terminal Receives the state at a terminal event
+     * @return true if a terminal event fired
+     */
+    bool locate(const SystemState& start, const SystemState& end, const Interpolator& interpolate, SystemState& terminal);
+
+    /**
+     * @brief Cubic Hermite interpolation of positions (and its derivative for velocities).
+     */
+    static void hermite(const SystemState& start, const SystemState& end, double t, SystemState& out);
+
+    /**
+     * @brief Separation of two bodies crossing `distance` (FALLING = approach).
+     */
+    static Event pairDistance(size_t one, size_t two, double distance, eventDirection direction = FALLING);
+
+    /**
+     * @brief Body becoming unbound from the rest of the system.
+     *
+     * g is the two-body energy ½v² - G(M + m)/r of the body relative to the
+     * centre of mass of all other bodies, rising through zero.
+     */
+    static Event escape(size_t body);
+
+    /**
+     * @brief Body crossing the plane through `point` with normal `normal`.
+     */
+    static Event planeCrossing(size_t body, const glm::dvec3& point, const glm::dvec3& normal, eventDirection direction = EITHER);
+
+    /**
+     * @brief Poincaré section: every crossing of the plane along its normal is reported.
+     */
+    static Event poincareSection(size_t body, const glm::dvec3& point, const glm::dvec3& normal, const EventCallback& callback);
+
+private:
+    std::vector<Event> Events;   ///< Registered events (removed ones have no Function)
+    unsigned Samples;            ///< Scan subintervals per step
+
+    /**
+     * @brief Illinois root finding of g on [tA, tB] with g(tA), g(tB) of opposite sign.
+     */
+    double findRoot(const Event& event, const Interpolator& interpolate, double tA, double gA, double tB, double gB) const;
+};
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file neighbourList.h
+ * @author DotBox
+ * @brief Verlet neighbour list with a skin, reused until a body has moved half the skin
+ *
+ * The broad phase rediscovers the close pairs every step although the
+ * neighbourhood of a body hardly changes from one step to the next. A Verlet
+ * list is built once from broad phase boxes widened by a skin: it holds every
+ * pair whose spheres are within (contact distance + skin) of each other, and
+ * the reference position of every body at that time.
+ *
+ * As long as no body has moved more than half the skin from its reference
+ * position, no pair missing from the list can have come into contact (each
+ * of the two bodies would have had to cover more than half the skin), so the
+ * list is handed out unchanged and the narrow phase works through it. The
+ * check is a single pass over the bodies. The list is rebuilt when any body
+ * has gone further, when bodies are added, removed or reordered, or when a
+ * radius changes (mergers). For swept contacts both ends of each path are
+ * checked; the path lies between them.
+ *
+ * A larger skin means fewer rebuilds and a longer list to narrow down; a
+ * skin of a few times the typical displacement per step amortizes a rebuild
+ * over many steps. The list is the single source of close pairs for the
+ * contact passes and for sleeping islands.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef NEIGHBOUR_LIST_H
+#define NEIGHBOUR_LIST_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "body.h"
+
+class NeighbourList {
+public:
+    NeighbourList();
+
+    /**
+     * @brief Skin distance (0 disables the list; a change forces a rebuild).
+     */
+    void setSkin(float skin);
+
+    float getSkin() const;
+
+    /**
+     * @brief True while the stored pairs still cover every possible contact.
+     *
+     * @param bodies All bodies of the simulation
+     * @param start Positions at the start of the step for swept contacts (optional)
+     */
+    bool valid(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start = {}) const;
+
+    /**
+     * @brief Store the pairs of a broad phase built with the skin, and the reference positions.
+     *
+     * @param bodies All bodies of the simulation
+     * @param pairs Candidate pairs (i, j), i < j, sorted, from boxes widened by the skin
+     */
+    void store(const std::vector<Body*>& bodies, const std::vector<std::pair<uint32_t, uint32_t>>& pairs);
+
+    /**
+     * @brief Forget the list; the next query rebuilds it.
+     */
+    void invalidate();
+
+    /**
+     * @brief Pairs within contact distance plus skin, as indices into the bodies.
+     */
+    const std::vector<std::pair<uint32_t, uint32_t>>& getPairs() const;
+
+    /**
+     * @brief Number of rebuilds so far.
+     */
+    size_t getBuilds() const;
+
+private:
+    float Skin;
+    size_t Builds;
+
+    std::vector<Body*> Tracked;                 ///< Bodies the list belongs to
+    std::vector<glm::vec3> Reference;           ///< Positions at the last build
+    std::vector<float> Radius;                  ///< Radii at the last build
+    std::vector<std::pair<uint32_t, uint32_t>> Pairs;
+};
+
+#endif
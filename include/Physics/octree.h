@@ -0,0 +1,127 @@
+/**
+ * @file octree.h
+ * @author DotBox
+ * @brief Barnes-Hut octree for approximate gravity of large N, and the locally essential tree of a region
+ *
+ * The pairwise sum costs O(N²) and stops being usable somewhere past ten
+ * thousand bodies. The tree code groups distant bodies: space is cut into
+ * nested cubes (octants) until each leaf holds at most OCTREE_LEAF points,
+ * and every cube keeps the mass and centre of mass of what it holds. The
+ * force on a point walks the tree from the root and takes a whole cube as a
+ * single mass (monopole) once it is far enough away,
+ *
+ *   d > l / θ + δ
+ *
+ * with d the distance to the centre of mass, l the edge of the cube and δ
+ * the offset of the centre of mass from the centre of the cube (so a lopsided
+ * cube is opened earlier). Otherwise its children are visited. The walk costs
+ * O(log N) per point, with an error set by the opening angle θ (θ → 0 gives
+ * the direct sum back).
+ *
+ * Nodes are stored in depth-first order with, for each, the index of the node
+ * after its subtree, so the walk is a loop without a stack: opening a cube
+ * means going to the next node, accepting it means jumping past its subtree.
+ * Points are kept in tree order for locality.
+ *
+ * For a domain decomposed run the tree also cuts out its locally essential
+ * part for a remote region (a box): the cubes that pass the opening test for
+ * every point of the box, as single masses, and the points of the leaves
+ * that do not. That is everything the remote side needs of this tree to
+ * compute its forces to the same accuracy.
+ *
+ * Gravity is softened with a Plummer length ε (r² → r² + ε²), 0 by default.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef OCTREE_H
+#define OCTREE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+inline constexpr double OCTREE_THETA = 0.5;     ///< Default opening angle
+inline constexpr uint32_t OCTREE_LEAF = 8;      ///< Points per leaf
+inline constexpr int OCTREE_DEPTH = 48;         ///< Depth at which coincident points stop the subdivision
+
+/// A mass at a point: a body, or a whole cube seen from afar
+struct PointMass {
+    glm::dvec3 Position;
+    double Mass;
+};
+
+class Octree {
+public:
+    Octree();
+
+    /**
+     * @brief Opening angle θ, in (0, 1].
+     */
+    void setTheta(double theta);
+
+    double getTheta() const;
+
+    /**
+     * @brief Plummer softening length (0: none).
+     */
+    void setSoftening(double softening);
+
+    /**
+     * @brief Build the tree over a set of points (copied).
+     */
+    void build(const std::vector<PointMass>& points);
+
+    /**
+     * @brief Gravitational acceleration and potential at a point.
+     *
+     * @param position Where to evaluate
+     * @param self Index (into the points given to build()) of the point at that position, left out of the sum; SIZE_MAX for none
+     * @param acceleration Output acceleration
+     * @param potential Output potential (per unit mass)
+     * @return Interactions summed, the cost of the evaluation
+     */
+    size_t evaluate(const glm::dvec3& position, size_t self, glm::dvec3& acceleration, double& potential) const;
+
+    /**
+     * @brief Append the locally essential tree of the box [lower, upper] to out.
+     */
+    void essential(const glm::dvec3& lower, const glm::dvec3& upper, std::vector<PointMass>& out) const;
+
+    /**
+     * @brief Nodes of the current tree.
+     */
+    size_t getNodes() const;
+
+private:
+    struct Node {
+        glm::dvec3 Centre;      ///< Centre of the cube
+        double Size;            ///< Edge of the cube
+        glm::dvec3 Com;         ///< Centre of mass
+        double Mass;
+        double Offset;          ///< |Com - Centre|
+        uint32_t Next;          ///< Node after the subtree
+        uint32_t First;         ///< First point (leaves)
+        uint32_t Count;         ///< Points below the node
+        bool Leaf;
+    };
+
+    double Theta;
+    double Softening;
+
+    std::vector<Node> Nodes;
+    std::vector<PointMass> Points;          ///< In tree order
+    std::vector<size_t> Index;              ///< Index of each point in the input of build()
+    std::vector<PointMass> Scratch;
+    std::vector<size_t> ScratchIndex;
+
+    uint32_t subdivide(uint32_t begin, uint32_t end, const glm::dvec3& centre, double size, int depth);
+
+    // True when the node may stand in as one mass at squared distance d2
+    bool far(const Node& node, double d2) const;
+};
+
+#endif
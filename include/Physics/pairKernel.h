@@ -0,0 +1,74 @@
+/**
+ * @file pairKernel.h
+ * @author DotBox
+ * @brief Fused pairwise kernel: gravity and contact candidates from one separation
+ *
+ * Every step the engine visited all pairs j > i for gravity, and the contact
+ * pass then went looking for close pairs again, recomputing the separations
+ * it had just had. The kernel gathers the bodies into contiguous arrays
+ * (positions, masses, radii, flags) and walks each row j > i once: from the
+ * separation and its square it emits the gravitational force of the pair
+ * and flags the pair as a contact candidate when the spheres are within
+ * their contact distance plus a skin.
+ *
+ * - Gravity: the same expression, clamping and summation order as
+ *   Physics::calculateGravForce(), so results are unchanged. Each row is a
+ *   branch-free loop over j that the compiler vectorizes: the force of every
+ *   pair goes to a row buffer and is subtracted from body j; body i then sums
+ *   its row in order.
+ * - Sleeping bodies pull awake ones but are not pulled; pairs within one KS
+ *   pair or chain (same group) are left to the regularization.
+ * - Candidates: pairs within r₁ + r₂ + √EPSILON + skin at the start of the
+ *   step. While no body moves further than half the skin during the step,
+ *   every contact at its end is among them, and they are handed to the
+ *   contact pass in place of the broad phase (see NeighbourList for the
+ *   check). The skin is FUSED_REACH times the largest step displacement, so
+ *   a body that speeds up a lot only costs a broad phase that frame.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef PAIR_KERNEL_H
+#define PAIR_KERNEL_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "body.h"
+
+inline constexpr float FUSED_REACH = 2.0f;         ///< Skin as a multiple of the largest step displacement (per side)
+inline constexpr float FUSED_MIN_SKIN = 1e-2f;     ///< Skin floor, so bodies at rest do not invalidate the candidates
+
+class PairKernel {
+public:
+    PairKernel();
+
+    /**
+     * @brief Add the gravity of all pairs to the force accumulators and collect contact candidates.
+     *
+     * Light sources and sleeping bodies' rows are skipped.
+     *
+     * @param bodies All bodies of the simulation
+     * @param group Regularization group per body (-1: none); pairs in one group exert no force here
+     * @param skin Extra distance for contact candidates
+     * @param candidates Receives the candidate pairs (i, j), i < j, sorted; nullptr for gravity only
+     */
+    void run(std::vector<Body*>& bodies, const std::vector<int>& group, float skin, std::vector<std::pair<uint32_t, uint32_t>>* candidates);
+
+private:
+    // Gathered bodies, structure of arrays
+    std::vector<float> X, Y, Z, Mass, Radius;
+    std::vector<float> ForceX, ForceY, ForceZ;
+    std::vector<int> Group;
+    std::vector<float> Awake;                   ///< 1 for awake bodies, 0 for sleepers
+    std::vector<uint32_t> Index;                ///< Position of each gathered body in the bodies vector
+
+    // Row buffers
+    std::vector<float> RowX, RowY, RowZ;
+    std::vector<float> Close;                   ///< 1 where the pair is a contact candidate
+};
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file parareal.h
+ * @author DotBox
+ * @brief Parareal parallel-in-time driver for long single trajectories
+ *
+ * Time stepping is inherently sequential, so one long three-body run cannot use
+ * more than one core. Parareal trades extra arithmetic for concurrency: the
+ * interval is cut into N slices, a cheap coarse propagator G sweeps through them
+ * sequentially, and an accurate fine propagator F runs on every slice at once.
+ * The slices are then stitched together with the correction
+ *
+ *   Uₙ₊₁ᵏ⁺¹ = G(Uₙᵏ⁺¹) + F(Uₙᵏ) - G(Uₙᵏ)
+ *
+ * and the process repeats until the largest change between iterations drops
+ * below the tolerance. After k iterations the first k slices are exact, so the
+ * scheme always converges to the serial fine solution within N iterations; the
+ * speed-up comes from converging in far fewer.
+ *
+ * Any pair of reentrant propagators works (see Physics::makePropagator), e.g.
+ * Euler or a loose-tolerance Bulirsch–Stoer as G and a tight Taylor series as F.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef PARAREAL_H
+#define PARAREAL_H
+
+#include <vector>
+#include "Physics/state.h"
+
+class Parareal {
+public:
+    /**
+     * @brief Construct the driver from a coarse and a fine propagator.
+     *
+     * @param coarse Cheap propagator G (run sequentially)
+     * @param fine Accurate propagator F (run concurrently, must be reentrant)
+     */
+    Parareal(Propagator coarse, Propagator fine);
+
+    /**
+     * @brief Convergence threshold on the scaled change between iterations (default 1e-10).
+     */
+    void setTolerance(double tolerance);
+
+    /**
+     * @brief Worker threads for the fine sweeps (default: hardware concurrency).
+     */
+    void setThreads(unsigned threads);
+
+    /**
+     * @brief Upper bound on the number of iterations (default: number of slices).
+     */
+    void setMaxIterations(unsigned iterations);
+
+    /**
+     * @brief Advance the state by `interval` using `slices` time slices.
+     *
+     * @param state Initial state, overwritten with the final state
+     * @param interval Total time to integrate over
+     * @param slices Number of time slices (typically one or a few per thread)
+     * @return Number of iterations performed
+     *
+     * An exception thrown by a propagator (on any worker thread) is passed on
+     * to the caller, and the state is left as it was.
+     */
+    unsigned integrate(SystemState& state, double interval, unsigned slices);
+
+    /// Largest scaled correction of the last iteration
+    double getCorrection() const;
+
+    /**
+     * @brief Largest difference between two states, relative to their magnitude (the measure of the correction).
+     */
+    static double difference(const SystemState& a, const SystemState& b);
+
+private:
+    Propagator Coarse;        ///< Sequential predictor G
+    Propagator Fine;          ///< Parallel corrector F
+    double Tolerance;         ///< Convergence threshold
+    unsigned Threads;         ///< Concurrent fine propagations
+    unsigned MaxIterations;   ///< Iteration cap (0 = slices)
+    double Correction;        ///< Last iteration's correction
+
+    /**
+     * @brief Run the fine propagator on slices [first, n) concurrently.
+     */
+    void fineSweep(const std::vector<SystemState>& start, std::vector<SystemState>& out, unsigned first, double slice);
+};
+
+#endif
@@ -12,12 +12,25 @@
  * using kinematic equations, with optional gravitational force accumulation between bodies.
  * 
  * Key features:
- * - Euler integration for position/velocity updates
+ * - Euler integration for position/velocity updates, with gravity and contact candidates from one fused pair pass
  * - Exponential decay functions for natural motion damping: v(t) = v₀ * e^(-λt)
- * - Sphere-sphere collision detection (distance-based)
- * - Impulse-based collision response (elastic collisions)
+ * - Sphere-sphere collision detection (spatial hash or sweep-and-prune broad phase, optional Verlet
+ *   neighbour list on top, distance-based narrow phase)
+ * - Static plane and box colliders (ground, walls, containers) tested with a vectorized kernel
+ * - Optional continuous collision detection (swept-sphere time of impact against spheres and colliders)
+ * - Event-driven collision mode (time-of-impact priority queue between gravity kicks)
+ * - Island-based sleeping of settled bodies
+ * - Impulse-based collision response (elastic collisions), resolved in parallel batches of independent contacts
+ * - Optional sequential impulse solver with a persistent, warm-started contact cache for resting piles
+ * - Optional inelastic merging (accretion) with in-place compaction of the body list
  * - Configurable timestep and simulation speed
  * - Boundary-based simulation termination
+ * - Optional Kustaanheimo–Stiefel regularization of close pairs (replaces the distance clamp for them)
+ * - Algorithmic chain regularization of compact subsystems (3 to 10 bodies)
+ * - Optional high-order integrators (Gragg–Bulirsch–Stoer, Taylor series) on a double precision mirror
+ * - Orbit-averaged (secular) evolution of stable hierarchical triples
+ * - Variational equations with MEGNO / Lyapunov chaos indicators
+ * - Event detection (close approach, escape, plane crossing) located by root finding within the step
  * 
  * @version 0.1
  * @date 2025-10-28
@@ -33,6 +46,25 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/epsilon.hpp>
 #include "body.h"
+#include "Physics/state.h"
+#include "Physics/bulirschStoer.h"
+#include "Physics/taylor.h"
+#include "Physics/regularization.h"
+#include "Physics/chain.h"
+#include "Physics/parareal.h"
+#include "Physics/stepController.h"
+#include "Physics/secular.h"
+#include "Physics/variational.h"
+#include "Physics/events.h"
+#include "Physics/broadPhase.h"
+#include "Physics/neighbourList.h"
+#include "Physics/pairKernel.h"
+#include "Physics/ccd.h"
+#include "Physics/collisionScheduler.h"
+#include "Physics/contactGraph.h"
+#include "Physics/contactSolver.h"
+#include "Physics/sleeping.h"
+#include "Physics/colliders.h"
 
 // Global physics constants and parameters
 inline float dt;                                                      ///< Physics timestep (seconds per frame)
@@ -40,6 +72,31 @@ inline constexpr double GRAV_CONST = 6.67430e-11;                     ///< Gravi
 inline constexpr glm::vec3 GRAV_FORCE = glm::vec3(0.0f, 0.0f, 0.0f); ///< Earth's gravitational force
 inline constexpr double EPSILON = 1e-3;                               ///< Numerical tolerance for zero comparisons
 
+/// Numerical integration schemes available to the engine
+enum integratorType {
+    EULER,          ///< Semi-implicit Euler directly on Body (single precision, default)
+    BULIRSCH_STOER, ///< Adaptive Gragg–Bulirsch–Stoer extrapolation (double precision)
+    TAYLOR          ///< Adaptive high-order Taylor series with dense output (double precision)
+};
+
+/// Outcome of a sphere-sphere contact
+enum collisionPolicy {
+    BOUNCE,   ///< Elastic collision with overlap correction (default)
+    MERGE     ///< Perfectly inelastic merger into a single body
+};
+
+/// Response to bouncing contacts
+enum contactSolverType {
+    ELASTIC,            ///< Each moving contact resolved once per step from scratch (default)
+    SEQUENTIAL_IMPULSE  ///< Iterated normal impulses, warm-started from the previous step
+};
+
+/// Broad phases available for the sphere-sphere contact pass
+enum broadPhaseType {
+    SPATIAL_HASH,     ///< Uniform grid sized from the median radius (default)
+    SWEEP_AND_PRUNE   ///< Sorted intervals along one axis, kept across frames
+};
+
 class Physics {
 public:
 
@@ -88,6 +145,315 @@ public:
 
     void wait(float sec);
 
+    /**
+     * @brief Select the integration scheme used by processFrame().
+     * 
+     * EULER integrates each Body in place. Every other scheme advances a double
+     * precision mirror of the bodies over one dt (taking as many internal steps
+     * as its error control needs) and writes the result back, so tolerances far
+     * below float resolution are reachable over long runs.
+     * 
+     * @param type Integrator to use from the next frame on
+     */
+    void setIntegrator(integratorType type);
+
+    /**
+     * @brief Set the local error tolerance of the adaptive integrators.
+     * 
+     * Ignored by EULER. Typical values range from 1e-8 (fast) to 1e-13.
+     * 
+     * @param tolerance Combined relative/absolute error tolerance per step
+     */
+    void setTolerance(double tolerance);
+
+    integratorType getIntegrator() const;
+
+    double getTolerance() const;
+
+    /**
+     * @brief Build a reentrant propagator on SystemState for any engine integrator.
+     * 
+     * Each call of the returned function uses its own integrator instance, so
+     * several can run concurrently (e.g. as the coarse and fine propagators
+     * of the Parareal driver). A propagator whose adaptive integrator gives up
+     * on a step throws std::runtime_error and leaves the state as it was.
+     * 
+     * @param type Integrator to wrap
+     * @param tolerance Error tolerance for the adaptive integrators
+     * @param timeStep Fixed step for EULER (ignored by the adaptive integrators)
+     * @return Propagator advancing a state by a given interval
+     */
+    static Propagator makePropagator(integratorType type, double tolerance, double timeStep);
+
+    /**
+     * @brief Dense output: state of the simulation at an arbitrary time inside the last step.
+     * 
+     * Only available with the TAYLOR integrator, whose series from the last
+     * expansion can be evaluated anywhere inside its step for the cost of a
+     * polynomial evaluation (e.g. for smooth trajectory plots between frames).
+     * 
+     * @param time Absolute simulation time
+     * @param out Receives the state (in the same body order as the non-source bodies)
+     * @return false if dense output is unavailable for that time
+     */
+    bool interpolateState(double time, SystemState& out) const;
+
+    /**
+     * @brief Set the separation below which two bodies are KS-regularized.
+     * 
+     * Pairs closer than this have their relative motion carried exactly in
+     * Kustaanheimo–Stiefel variables instead of through the singular 1/r² force,
+     * and are released again once they separate beyond 1.5× the distance.
+     * Applies to the EULER integrator (the adaptive integrators resolve close
+     * approaches with their own step control). Pairs that are not regularized
+     * still skip the force when closer than one unit.
+     * 
+     * @param distance Entry separation in world units (default 0: disabled)
+     */
+    void setRegularization(float distance);
+
+    /**
+     * @brief Set the linking distance for chain-regularized subsystems.
+     * 
+     * Groups of 3 to MAX_CHAIN_BODIES bodies whose members are linked by
+     * separations below this distance are integrated internally with the
+     * AR-chain integrator (chain coordinates, logarithmic time transformation
+     * and GBS extrapolation), while the rest of the simulation only sees their
+     * centre of mass motion under external forces. Members leave a subsystem
+     * once they separate beyond 1.5× the distance. Applies to the EULER
+     * integrator; 0 disables it (the default).
+     * 
+     * @param radius Linking distance in world units
+     */
+    void setChainRegularization(float radius);
+
+    /**
+     * @brief Allow orbit-averaged evolution of hierarchical triples.
+     * 
+     * When the simulation holds exactly three bodies forming a stable
+     * hierarchical triple (inner binary plus distant companion, Mardling &
+     * Aarseth criterion with a 20% margin), processFrame() evolves the double
+     * averaged orbital elements instead of the bodies, so Kozai–Lidov cycles
+     * cost a handful of operations per frame regardless of dt. Direct
+     * integration with the selected integrator resumes as soon as the
+     * stability or averaging criterion fails, the inner pericentre drops
+     * below the KS threshold, or a contact changes the orbits. With the
+     * adaptive step enabled, advance() covers a whole interval in one
+     * secular step.
+     * 
+     * @param enabled Detect triples and switch automatically (default off)
+     */
+    void setSecularMode(bool enabled);
+
+    /**
+     * @brief True while the bodies are evolved by the secular integrator.
+     */
+    bool isSecular() const;
+
+    /**
+     * @brief Resolve contacts on k substeps per gravity step (multi-rate).
+     * 
+     * With k > 1 the EULER integrator switches to an impulse multi-rate
+     * (r-RESPA) scheme: a half kick from the long-range gravity at the start
+     * of the frame, k substeps of free drift each followed by the surface and
+     * sphere-sphere contact pass, then gravity at the new positions and a
+     * closing half kick. The closing forces are reused as the opening forces
+     * of the next frame, so fast contacts no longer force a small step on the
+     * O(N²) gravity sum. k = 1 keeps the single-rate loop (the default).
+     * 
+     * @param substeps Number of contact substeps per frame (k ≥ 1)
+     */
+    void setContactSubsteps(int substeps);
+
+    /**
+     * @brief Select the broad phase that feeds the sphere-sphere contact pass.
+     * 
+     * SPATIAL_HASH rebuilds a uniform grid every frame and suits spheres of
+     * similar size. SWEEP_AND_PRUNE keeps the bodies sorted along one axis
+     * from frame to frame and re-sorts them incrementally, which copes with
+     * widely varying radii and costs close to linear time while the scene
+     * changes slowly. Both report the same pairs.
+     * 
+     * @param type Broad phase to use from the next frame on
+     */
+    void setBroadPhase(broadPhaseType type);
+
+    /**
+     * @brief Reuse the close pairs over several frames (Verlet neighbour list).
+     * 
+     * The broad phase is run with boxes widened by the skin and its pairs are
+     * kept until some body has moved more than half the skin, bodies are
+     * added or removed, or a radius changes. In between, finding the close
+     * pairs costs one displacement check per body. Contacts are the same as
+     * without the list.
+     * 
+     * @param skin Extra pair distance (0 disables the list, the default)
+     */
+    void setNeighbourSkin(float skin);
+
+    /**
+     * @brief Number of neighbour list rebuilds so far.
+     */
+    size_t getNeighbourBuilds() const;
+
+    /**
+     * @brief Move the bodies from collision to collision between gravity kicks.
+     * 
+     * For dilute, hard-sphere-like scenes. Each frame becomes a kick-drift-kick
+     * step: a half kick from gravity, a free flight over the whole dt in which
+     * the predicted impacts are taken from a priority queue and resolved one
+     * after the other at their exact times (re-predicting only for the two
+     * bodies involved), and a closing half kick whose forces are reused by the
+     * next frame. Without collisions a frame costs one drift and one broad
+     * phase pass, and dt is no longer limited by contact resolution, only by
+     * the accuracy of the gravity splitting. Applies to the EULER integrator.
+     * 
+     * @param enabled Use event-driven frames (default off)
+     */
+    void setEventDriven(bool enabled);
+
+    /**
+     * @brief Resolve contacts at their time of impact inside the step.
+     * 
+     * Every sphere is swept along its path over the step, and contacts with
+     * other spheres and with the colliders are resolved at the moment they touch:
+     * the bodies are moved back to the contact, the response is applied there
+     * and they travel the remainder of the step with their new velocities.
+     * Fast bodies no longer pass through each other, and bounces no longer
+     * depend on dt, so much larger steps keep correct contacts. Overlaps that
+     * are present at the start of the step (resting contacts) still go through
+     * the end-of-step test. Secular frames are not swept.
+     * 
+     * @param enabled Use swept-sphere contacts (default off)
+     */
+    void setContinuousCollisions(bool enabled);
+
+    /**
+     * @brief Let settled bodies fall asleep (see SleepIslands).
+     * 
+     * Islands of touching bodies that have rested on the surface for a while
+     * are frozen and cost nothing until an awake body touches them, they are
+     * moved or pushed from outside, or the pull of the awake bodies on them
+     * changes noticeably. Once every body sleeps, processFrame() only checks
+     * for disturbances. Applies to the EULER integrator; switching integrator
+     * or disabling wakes everything.
+     * 
+     * @param enabled Allow sleeping (default off)
+     */
+    void setSleeping(bool enabled);
+
+    /**
+     * @brief Number of bodies currently asleep.
+     */
+    size_t getSleeping() const;
+
+    /**
+     * @brief Make a rendered surface solid (see ColliderSet).
+     * 
+     * The face matches the surface's orientation, distance and size; call it
+     * after configuring the surface. Without colliders bodies fall freely.
+     * 
+     * @param surface Surface to collide with
+     * @param side +1 / -1: solid below / above, free towards the positive / negative axis; 0: thin two-sided sheet
+     */
+    void addSurface(const Surface& surface, int side = 0);
+
+    /**
+     * @brief Add an infinite one-sided ground plane.
+     * 
+     * @param point Any point of the plane
+     * @param normal Direction of the free side
+     */
+    void addPlane(const glm::vec3& point, const glm::vec3& normal);
+
+    /**
+     * @brief Add an axis-aligned box whose six faces push bodies outwards.
+     */
+    void addBox(const glm::vec3& lower, const glm::vec3& upper);
+
+    /**
+     * @brief Remove all planes, surfaces and boxes.
+     */
+    void clearColliders();
+
+    /**
+     * @brief Choose whether touching spheres bounce or merge.
+     * 
+     * With MERGE the heavier body of a contact absorbs the other (the lower
+     * index on a tie): mass and momentum are conserved, the survivor moves to
+     * the centre of mass and its radius is recomputed from the density, or
+     * from the summed volumes when no density is given. Absorbed bodies are
+     * removed from the body list at the end of the contact pass by compacting
+     * it in place (order kept, no reallocation), so later frames only pay for
+     * the bodies that are left. Indices into the list (events, pairs) refer
+     * to the compacted list from then on.
+     * 
+     * @param policy BOUNCE or MERGE
+     * @param density Density of merged bodies (mass per volume); 0 conserves volume
+     */
+    void setCollisionPolicy(collisionPolicy policy, float density = 0.0f);
+
+    /**
+     * @brief Called for every body removed by a merger, before it leaves the list.
+     * 
+     * Lets the owner of the bodies (e.g. the renderer) drop its references.
+     */
+    void setRemovalCallback(const std::function<void(Body&)>& callback);
+
+    /**
+     * @brief Choose how bouncing contacts are resolved.
+     * 
+     * ELASTIC exchanges the velocities of each moving pair once per step and
+     * clamps bodies onto the colliders. SEQUENTIAL_IMPULSE solves all contacts
+     * of the step together, resting ones included, by iterating on their
+     * normal impulses; the impulses are kept per body pair from one step to
+     * the next and used as the starting point, so settled piles converge in
+     * one or two iterations and stay still without contact substeps. Has no
+     * effect with MERGE.
+     * 
+     * @param solver ELASTIC or SEQUENTIAL_IMPULSE
+     * @param iterations Sweeps over the contacts per step (sequential impulses only)
+     * @param warmStart Start from the impulses of the last step (off: from zero)
+     */
+    void setContactSolver(contactSolverType solver, int iterations = CONTACT_ITERATIONS, bool warmStart = true);
+
+    /**
+     * @brief Contacts of the last step that were warm-started from a cached impulse.
+     */
+    size_t getWarmStartedContacts() const;
+
+    /**
+     * @brief Worker threads for the broad phase and the contact batches.
+     * 
+     * Results do not depend on the number of threads.
+     * 
+     * @param threads Thread count (default: hardware concurrency)
+     */
+    void setThreads(unsigned threads);
+
+    /**
+     * @brief Carry a tangent vector along with the simulation and track chaos indicators.
+     * 
+     * The variational equations are advanced with the state: in the same
+     * Bulirsch–Stoer extrapolation for BULIRSCH_STOER, by a matching
+     * semi-implicit Euler step for EULER, and in the same Taylor series for
+     * TAYLOR. Frames handled by the secular integrator are skipped. Enabling
+     * restarts the run with a fresh tangent vector.
+     * 
+     * @param enabled Track MEGNO and the Lyapunov exponent (default off)
+     */
+    void setChaosIndicators(bool enabled);
+
+    /**
+     * @brief Running MEGNO ⟨Y⟩ of the current run (≈2 regular, growing when chaotic).
+     */
+    double getMegno() const;
+
+    /**
+     * @brief Finite time maximal Lyapunov exponent of the current run.
+     */
+    double getLyapunov() const;
+
     /**
      * @brief Execute one physics timestep for all bodies in the simulation.
      * 
@@ -103,18 +469,79 @@ public:
      * 
      * @param bodies Reference to vector of all Body objects in the simulation
      */
-    void processFrame(std::vector<Body*> bodies);
+    void processFrame(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Advance the simulation by an arbitrary interval with adaptive steps.
+     * 
+     * Takes steps chosen by the step controller (see setAdaptiveStep) and
+     * shortens the last one so the interval ends exactly on the requested
+     * time, letting the renderer keep sampling at its own frame times.
+     * Without the adaptive step it takes whole steps of dt and one shorter
+     * step for the rest. The global dt holds each step while it is processed
+     * and is restored to the caller's value afterwards.
+     * 
+     * @param bodies All bodies in the simulation
+     * @param interval Time to advance by (e.g. the accumulated frame time)
+     */
+    void advance(std::vector<Body*>& bodies, double interval);
+
+    /**
+     * @brief Enable or disable the error-driven adaptive global timestep.
+     * 
+     * @param enabled When true, advance() picks dt from the Aarseth-style criterion
+     * @param minStep Smallest step the controller may choose
+     * @param maxStep Largest step the controller may choose
+     */
+    void setAdaptiveStep(bool enabled, float minStep, float maxStep);
+
+    /**
+     * @brief Accuracy parameter η of the adaptive step criterion (default 0.02).
+     */
+    void setStepAccuracy(float eta);
+
+    bool isAdaptive() const;
+
+    /**
+     * @brief Register an event located within each frame by root finding.
+     * 
+     * After every frame the event functions are scanned on the dense output of
+     * the frame and each crossing is refined to its exact time before the
+     * callback fires, so events need no smaller dt to be caught. A terminal
+     * event moves the bodies to the state at the event time and ends the
+     * simulation (shouldClose()). See EventDetector for the ready-made close
+     * approach, escape, plane crossing and Poincaré section events; body
+     * indices count the non-source bodies in scene order.
+     * 
+     * @param event Event function, direction, terminal flag and callback
+     * @return Identifier for removeEvent()
+     */
+    size_t addEvent(const Event& event);
+
+    void removeEvent(size_t id);
+
+    /**
+     * @brief Simulation time elapsed in processFrame() (exact event time after a terminal event).
+     */
+    double getTime() const;
 
     /**
      * @brief Check if the simulation should terminate.
      * 
-     * Returns true when any body crosses the defined boundary threshold
-     * or when another termination condition is met.
+     * Returns true when any body crosses the defined boundary threshold,
+     * a terminal event fired, or another termination condition is met.
      * 
      * @return true if simulation should stop, false otherwise
      */
     bool shouldClose();
 
+    /**
+     * @brief True once the adaptive integrator gave up on a step (e.g. coincident bodies).
+     *
+     * The simulation stops at the start of the lost frame (shouldClose()).
+     */
+    bool hasFailed() const;
+
     /**
      * @brief Clean up physics engine resources.
      * 
@@ -123,10 +550,87 @@ public:
      */
     void cleanup();
 
+    /**
+     * @brief Gravitational force on sphereOne exerted by sphereTwo (same clamping as calculateGravForce).
+     * 
+     * The reference for the fused pair kernel, which reproduces it exactly.
+     */
+    glm::vec3 gravityBetween(Body& sphereOne, Body& sphereTwo);
+
 private:
     // Simulation parameters
     float Speed;              ///< Global speed multiplier for all motion
     bool endSim;              ///< Flag to terminate simulation when boundary reached
+    bool Failed;              ///< The adaptive integrator gave up on a step
+
+    // High-order integration
+    integratorType Integrator;              ///< Scheme used by processFrame()
+    double Tolerance;                       ///< Error tolerance of the adaptive integrators
+    BulirschStoer bsIntegrator;             ///< Extrapolation integrator (keeps step/order history)
+    TaylorIntegrator taylorIntegrator;      ///< Taylor series integrator (keeps last series for dense output)
+    SystemState State;                      ///< Double precision mirror of the non-source bodies
+    std::vector<Body*> stateBodies;         ///< Bodies mirrored in State, in State order
+    std::vector<glm::vec3> syncedPosition;  ///< Positions last written back to the bodies
+    std::vector<glm::vec3> syncedVelocity;  ///< Velocities last written back to the bodies
+
+    // Close encounter regularization
+    float KSThreshold;                          ///< Entry separation for KS pairs (0 = disabled)
+    std::vector<RegularizedPair> ksPairs;       ///< Pairs currently integrated in KS variables
+    float ChainRadius;                          ///< Linking distance for chain subsystems (0 = disabled)
+    std::vector<ChainSubsystem> chains;         ///< Compact subsystems integrated with AR-chain
+
+    // Adaptive timestep
+    bool Adaptive;                              ///< True when advance() uses the step controller
+    StepController stepController;              ///< Aarseth-style global step selection
+
+    // Secular evolution
+    bool SecularMode;                           ///< True when hierarchical triples may be orbit-averaged
+    bool inSecular;                             ///< True while secularTriple drives the bodies
+    SecularTriple secularTriple;                ///< Averaged orbits of the current triple
+
+    // Multi-rate contacts
+    int ContactSubsteps;                        ///< Contact substeps per gravity step (1 = single rate)
+    std::vector<Body*> multirateBodies;         ///< Bodies the cached closing forces belong to
+    std::vector<glm::vec3> multiratePosition;   ///< Positions the cached forces were computed at
+    std::vector<const Body*> multirateRegularized; ///< Regularized set the cached forces excluded
+
+    // Chaos indicators
+    bool Chaos;                                 ///< True when the tangent vector is integrated
+    ChaosIndicator chaosIndicator;              ///< Tangent vector and MEGNO / Lyapunov accumulators
+
+    // Events
+    double simTime;                             ///< Simulation time advanced by processFrame()
+    EventDetector events;                       ///< Registered events, checked after every frame
+
+    // Contacts
+    broadPhaseType BroadPhase;                  ///< Source of candidate pairs for the narrow phase
+    SpatialHash spatialHash;                    ///< Uniform grid broad phase
+    SweepAndPrune sweepAndPrune;                ///< Incrementally sorted broad phase
+    NeighbourList neighbourList;                ///< Broad phase pairs reused within the skin
+    PairKernel pairKernel;                      ///< Fused gravity and contact candidate pass
+    std::vector<std::pair<uint32_t, uint32_t>> fusedPairs; ///< Contact candidates of the last fused pass
+    NeighbourList fusedList;                    ///< Fused candidates, valid within their skin
+    bool Continuous;                            ///< True when contacts are swept over the step
+    std::vector<glm::vec3> sweepStart;          ///< Positions at the start of the step being swept
+    float sweepInterval;                        ///< Duration of the step being swept
+    bool EventDriven;                           ///< True when frames drift from collision to collision
+    CollisionScheduler scheduler;               ///< Predicted impacts of the step being swept
+    ContactGraph contactGraph;                  ///< Colour batches of the end-of-step contacts
+    collisionPolicy Policy;                     ///< Bounce or merge on contact
+    float MergeDensity;                         ///< Density of merged bodies (0: conserve volume)
+    contactSolverType Solver;                   ///< Response to bouncing contacts
+    ContactSolver contactSolver;                ///< Sequential impulses and their cache across steps
+    std::function<void(Body&)> onRemove;        ///< Notified of bodies removed by mergers
+    std::vector<bool> absorbed;                 ///< Bodies merged away in the current contact pass
+
+    // Sleeping
+    bool Sleep;                                 ///< True when settled islands may fall asleep
+    SleepIslands sleepIslands;                  ///< Rest timers, islands and frozen forces
+    std::vector<std::pair<uint32_t, uint32_t>> touchingPairs; ///< Touching pairs of the last contact pass
+
+    // Static geometry
+    ColliderSet colliders;                      ///< Planes, surfaces and box faces
+    std::vector<std::pair<uint32_t, uint32_t>> surfaceContacts; ///< (body, face) contacts of the last pass
 
     /**
      * @brief Check if a vector is approximately zero within epsilon tolerance.
@@ -142,15 +646,178 @@ private:
 
     void updateState(Body& body);
 
+    /**
+     * @brief Advance all bodies by one dt (everything processFrame() does except events).
+     */
+    void stepFrame(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Switch pairs in and out of KS regularization and record their start state.
+     * 
+     * Existing pairs are released beyond 1.5× the threshold; new pairs are
+     * formed closest first, each body belonging to at most one pair.
+     */
+    void updateRegularization(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Form, keep or dissolve chain subsystems from the linking distance.
+     */
+    void updateChains(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Finish the KS pairs and chains whose last member has just been moved.
+     */
+    void finishRegularization(Body& body);
+
+    /**
+     * @brief Dissolve the KS pair or chain holding both bodies, if any (e.g. on contact).
+     */
+    void releasePair(Body& sphereOne, Body& sphereTwo);
+
+    /**
+     * @brief Dissolve every KS pair and chain the body belongs to (e.g. before removing it).
+     */
+    void releaseBody(Body& body);
+
+    bool isRegularized(Body& sphereOne, Body& sphereTwo);
+
+    /**
+     * @brief Index of the KS pair or chain of every body (-1: none), for the pair kernel.
+     */
+    std::vector<int> regularizationGroups(const std::vector<Body*>& bodies) const;
+
+    /**
+     * @brief Advance all non-source bodies by dt with the selected high-order integrator.
+     */
+    void integrateSystem(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Stop the simulation after the integrator gave up (hasFailed()).
+     */
+    void fail();
+
+    /**
+     * @brief Double precision copy of the non-source bodies (independent of the mirror).
+     */
+    void collectState(std::vector<Body*>& bodies, SystemState& out);
+
+    /**
+     * @brief Refresh the double precision mirror from the bodies.
+     * 
+     * Values that still match what was last written back are taken from the
+     * mirror, so precision is only lost for bodies something else touched
+     * (collisions, pushes, user edits).
+     * 
+     * @return true if any body was modified outside the integrator
+     */
+    bool syncState(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Write the mirror back to the bodies and remember what was written.
+     */
+    void writeState();
+
+    /**
+     * @brief Evolve the bodies secularly if they form a suitable hierarchical triple.
+     * 
+     * @return true if the frame was handled (the caller only processes contacts)
+     */
+    bool processSecular(std::vector<Body*>& bodies);
+
+    /**
+     * @brief One frame of the multi-rate scheme (see setContactSubsteps).
+     * 
+     * In event-driven mode the drift is a single swept pass over the whole dt.
+     */
+    void processMultirate(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Gravitational force and acceleration on every non-source body.
+     * 
+     * Pairs handled by KS or chain regularization are left out.
+     */
+    void accumulateGravity(std::vector<Body*>& bodies);
+
+    /**
+     * @brief True if the forces from the end of the last multi-rate frame still apply.
+     */
+    bool gravityCached(std::vector<Body*>& bodies);
+
+    /**
+     * @brief Members of all KS pairs and chains, in a comparable order.
+     */
+    std::vector<const Body*> regularizedBodies() const;
+
+    /**
+     * @brief Surface and sphere-sphere collision pass, run after the bodies have moved.
+     * 
+     * Sphere pairs come from the selected broad phase. The touching ones are
+     * collected into a contact list and resolved in batches of contacts that
+     * share no body (graph colouring), each batch in parallel, so the result is
+     * deterministic and independent of the thread count. With continuous
+     * collisions the swept contacts are resolved first and are not tested
+     * again at the end of the step. The sequential impulse solver instead
+     * takes every touching pair and collider contact of the step at once.
+     * 
+     * @param step Time the bodies moved over since the last contact pass
+     */
+    void processContacts(std::vector<Body*>& bodies, float step);
+
+    /**
+     * @brief Record the start of a step of the given duration for the swept contact pass.
+     */
+    void beginSweep(std::vector<Body*>& bodies, float interval);
+
+    /**
+     * @brief Candidate pairs from the selected broad phase (boxes swept from `start` if given).
+     */
+    const std::vector<std::pair<uint32_t, uint32_t>>& findPairs(std::vector<Body*>& bodies, const std::vector<glm::vec3>& start);
+
+    /**
+     * @brief Resolve the contacts of the step at their times of impact, in time order.
+     * 
+     * Impacts are predicted for every candidate and queued by time; after each
+     * collision only the candidates of the two bodies involved are predicted
+     * again on their new paths. The broad phase is repeated over the paths
+     * left after the collisions until it yields no further impact.
+     * 
+     * @param bounced Set for bodies that bounced off a collider
+     * @param resolved Receives the pairs that collided
+     * @return Candidate pairs of the last broad phase pass
+     */
+    const std::vector<std::pair<uint32_t, uint32_t>>& processSweptContacts(std::vector<Body*>& bodies, std::vector<bool>& bounced, std::vector<std::pair<uint32_t, uint32_t>>& resolved);
+
+    /**
+     * @brief Merge two bodies into the heavier one and mark the other as absorbed.
+     * 
+     * @return Index of the surviving body
+     */
+    uint32_t mergePair(std::vector<Body*>& bodies, uint32_t one, uint32_t two);
+
+    /**
+     * @brief Remove the absorbed bodies from the list in place, keeping the order.
+     * 
+     * Touching pairs of the pass are renumbered to the compacted list.
+     */
+    void removeAbsorbed(std::vector<Body*>& bodies);
+
     float calculateDistanceSquare(Body& sphereOne, Body& sphereTwo);
 
     void calculateGravForce(Body& sphereOne, Body& sphereTwo);
 
     void calculateForce(Body& body);
 
+    /**
+     * @brief True if the body touches any collider.
+     */
     bool onSurface(Body& body);
 
-    void processSurfaceCollision(Body& body);
+    /**
+     * @brief Bounce a body off a collider face and place it on the face.
+     * 
+     * @param face Index into the collider set
+     */
+    void processSurfaceCollision(Body& body, size_t face);
 
     /**
      * @brief Detect collision between two spherical bodies.
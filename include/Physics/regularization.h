@@ -0,0 +1,107 @@
+/**
+ * @file regularization.h
+ * @author DotBox
+ * @brief Kustaanheimo–Stiefel regularization of close two-body encounters
+ *
+ * Near a close approach the relative motion of two bodies is dominated by their
+ * mutual attraction, whose 1/r² singularity forces any explicit integrator down
+ * to tiny steps (or, as before, forces the pair to be ignored below a cut-off).
+ *
+ * The KS transformation lifts the relative position r ∈ ℝ³ to u ∈ ℝ⁴ with
+ * r = L(u) u and introduces the fictitious time s through dt = r ds. In these
+ * variables the unperturbed Kepler problem becomes a harmonic oscillator
+ *
+ *   u'' = (h/2) u,      h = |v|²/2 - G(m₁+m₂)/r  (constant)
+ *
+ * which has no singularity at r = 0 and can be solved in closed form. A
+ * regularized pair is advanced by splitting: the external (tidal) forces act
+ * on the pair as part of the regular force loop, then the relative motion is
+ * carried exactly along the KS oscillator for the frame interval. The physical
+ * time reached is t(s) = ∫ |u|² ds, also closed form, so the fictitious time
+ * matching dt is found with a safeguarded Newton iteration.
+ *
+ * Energy of the pair's internal motion is conserved to round-off through the
+ * encounter regardless of how close the bodies pass.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef REGULARIZATION_H
+#define REGULARIZATION_H
+
+#include <glm/glm.hpp>
+#include "body.h"
+
+/// Relative two-body motion expressed in KS variables
+struct KSState {
+    glm::dvec4 U;       ///< Regularized coordinates (r = L(u) u)
+    glm::dvec4 UPrime;  ///< Derivative of U with respect to fictitious time s
+    double Energy;      ///< Binding energy per unit reduced mass h
+};
+
+class RegularizedPair {
+public:
+    /**
+     * @brief Create a pair from two bodies (order does not matter).
+     */
+    RegularizedPair(Body* one, Body* two);
+
+    Body* One;     ///< Member updated first in the force loop
+    Body* Two;     ///< Member updated last; the pair is finished after its update
+
+    bool contains(const Body* body) const;
+    bool matches(const Body* a, const Body* b) const;
+
+    /**
+     * @brief Current separation of the pair.
+     */
+    double getDistance() const;
+
+    /**
+     * @brief Record the relative position at the start of the frame.
+     *
+     * Must be called before either member is moved this frame.
+     */
+    void begin();
+
+    /**
+     * @brief Replace the members' relative motion by the exact KS solution.
+     *
+     * Called once both members were moved by the regular integrator with the
+     * mutual force left out: their centre of mass and the relative velocity
+     * already contain the external forces, so only the Kepler drift of the
+     * relative coordinates over the interval remains to be done.
+     *
+     * @param interval Length of the frame (dt)
+     */
+    void finish(double interval);
+
+    /**
+     * @brief Convert relative position/velocity to KS variables.
+     *
+     * @param r Relative position (two - one)
+     * @param v Relative velocity (two - one)
+     * @param mu Gravitational parameter G(m₁ + m₂)
+     */
+    static KSState toKS(const glm::dvec3& r, const glm::dvec3& v, double mu);
+
+    /**
+     * @brief Convert KS variables back to relative position/velocity.
+     */
+    static void fromKS(const KSState& ks, glm::dvec3& r, glm::dvec3& v);
+
+    /**
+     * @brief Advance an unperturbed KS state by a physical time interval.
+     *
+     * @param ks State to advance in place
+     * @param interval Physical time to advance by
+     */
+    static void propagate(KSState& ks, double interval);
+
+private:
+    glm::dvec3 StartSeparation;  ///< Relative position at the start of the frame
+};
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file secular.h
+ * @author DotBox
+ * @brief Orbit-averaged (secular) evolution of hierarchical triples
+ *
+ * A hierarchical triple is an inner binary orbited by a distant third body.
+ * Its long term evolution (Kozai–Lidov cycles) happens on a time scale
+ *
+ *   t_LK = (1/n_in) (m₁₂/m₃) (a_out/a_in)³ (1 - e_out²)^(3/2)
+ *
+ * that can be millions of inner orbits, so following it with direct steps is
+ * hopeless. Averaging the interaction over both orbits leaves the double
+ * averaged quadrupole potential, under which the semi-major axes are fixed and
+ * only the orientation and shape of the orbits change. They are evolved in the
+ * vector form of Liu, Muñoz & Lai (2015): the dimensionless angular momentum
+ * vectors j = √(1-e²) n̂ and the eccentricity vectors e of both orbits,
+ *
+ *   dj_in/dt = 3/(4t_LK) [ (j_in·n̂) j_in×n̂ - 5 (e_in·n̂) e_in×n̂ ]
+ *   de_in/dt = 3/(4t_LK) [ (j_in·n̂) e_in×n̂ + 2 j_in×e_in - 5 (e_in·n̂) j_in×n̂ ]
+ *
+ * with n̂ the outer orbit normal, and the outer orbit responding so that total
+ * angular momentum is conserved. The mean anomalies keep advancing at their
+ * mean motions so the orbital phases are meaningful when switching back.
+ *
+ * The averaging is only valid while the triple is dynamically stable
+ * (Mardling & Aarseth 2001 criterion) and the secular time scale is long
+ * compared to the outer period; detect() and isValid() test both.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef SECULAR_H
+#define SECULAR_H
+
+#include <glm/glm.hpp>
+#include "Physics/state.h"
+
+/// Keplerian orbit in vector elements
+struct Orbit {
+    double SemiMajorAxis = 0.0;                   ///< a
+    glm::dvec3 Eccentricity = glm::dvec3(0.0);    ///< Eccentricity vector (points to pericentre)
+    glm::dvec3 AngularMomentum = glm::dvec3(0.0); ///< j = √(1-e²) n̂
+    double MeanAnomaly = 0.0;                     ///< M
+
+    /**
+     * @brief Elements from relative position and velocity (bound orbits only).
+     */
+    static Orbit fromState(const glm::dvec3& r, const glm::dvec3& v, double mu);
+
+    /**
+     * @brief Relative position and velocity at the current mean anomaly.
+     */
+    void toState(double mu, glm::dvec3& r, glm::dvec3& v) const;
+};
+
+class SecularTriple {
+public:
+    SecularTriple();
+
+    /**
+     * @brief Recognize a hierarchical triple suitable for secular evolution.
+     *
+     * The closest pair is taken as the inner binary. Both orbits must be bound,
+     * the configuration must be stable with some margin, and the secular time
+     * scale must be long compared to the outer period.
+     *
+     * @param state Exactly three bodies
+     * @param triple Receives the orbit-averaged description on success
+     * @return true if the state can be evolved secularly
+     */
+    static bool detect(const SystemState& state, SecularTriple& triple);
+
+    /**
+     * @brief Advance the averaged orbits (and the orbital phases) by `interval`.
+     */
+    void evolve(double interval);
+
+    /**
+     * @brief Check that the averaged description still applies.
+     *
+     * @param margin Required factor above the stability limit (1 = at the limit)
+     */
+    bool isValid(double margin = 1.0) const;
+
+    /**
+     * @brief Write positions and velocities of the three bodies back into a state.
+     *
+     * @param state State with the same three bodies as detected (masses untouched)
+     */
+    void write(SystemState& state) const;
+
+    /// Kozai–Lidov time scale t_LK
+    double getTimescale() const;
+
+    /// Inner pericentre distance a_in (1 - e_in)
+    double getInnerPericenter() const;
+
+    const Orbit& getInner() const;
+    const Orbit& getOuter() const;
+
+private:
+    size_t InnerOne, InnerTwo, Third;   ///< Body indices in the detected state
+    double MassOne, MassTwo, MassThird; ///< Masses of the three bodies
+    Orbit Inner;                        ///< Inner binary orbit
+    Orbit Outer;                        ///< Third body around the inner centre of mass
+    glm::dvec3 Centre;                  ///< Centre of mass of the triple
+    glm::dvec3 CentreVelocity;          ///< Its (constant) velocity
+    double Time;                        ///< Time since detection
+
+    /// Right hand side for (e_in, j_in, e_out, j_out)
+    void derivative(const glm::dvec3 y[4], glm::dvec3 dydt[4]) const;
+
+    double innerMu() const;
+    double outerMu() const;
+};
+
+#endif
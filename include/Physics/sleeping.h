@@ -0,0 +1,115 @@
+/**
+ * @file sleeping.h
+ * @author DotBox
+ * @brief Island-based sleeping of resting bodies
+ *
+ * Once a pile has settled on the surface its bodies still pay for integration,
+ * force accumulation and contact tests every step, only to end up where they
+ * were. Bodies whose speed has stayed below SLEEP_VELOCITY for SLEEP_TIME are
+ * candidates for sleep. Touching bodies form islands (union-find over the
+ * contacts), and an island falls asleep as a whole once every member is a
+ * candidate and it is supported (resting on the surface or on sleeping bodies).
+ * Sleeping bodies are frozen: they are neither moved nor force-accumulated,
+ * and pairs of sleeping bodies are skipped entirely.
+ *
+ * An island wakes up as a whole when
+ * - an awake body touches one of its members,
+ * - a member was moved or given a velocity from outside (push, user edit), or
+ * - the gravitational force on a member has drifted from its value at the
+ *   time the island fell asleep by more than WAKE_FORCE_FRACTION of it (plus
+ *   WAKE_ACCELERATION × mass), i.e. an awake body came close enough to pull
+ *   it off its support.
+ *
+ * To check the last condition without summing over sleeping pairs, the force
+ * each sleeper receives from the other sleepers is kept up to date as islands
+ * fall asleep and wake up; only the awake bodies are summed every step.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef SLEEPING_H
+#define SLEEPING_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include "body.h"
+
+inline constexpr float SLEEP_VELOCITY = 0.05f;       ///< Speed below which a body counts as resting
+inline constexpr float SLEEP_TIME = 0.5f;            ///< Time a whole island must rest before it sleeps (s)
+inline constexpr float WAKE_FORCE_FRACTION = 0.1f;   ///< Relative force change that wakes an island
+inline constexpr float WAKE_ACCELERATION = 0.01f;    ///< Absolute acceleration change that wakes an island
+
+class SleepIslands {
+public:
+    /// Force on `one` exerted by `two`
+    using PairForce = std::function<glm::vec3(Body& one, Body& two)>;
+    /// True if the body rests on a static support (the surface)
+    using Support = std::function<bool(Body& body)>;
+
+    SleepIslands();
+
+    /**
+     * @brief Wake the islands that were disturbed since the last step (start of a step).
+     *
+     * Covers outside edits of sleeping bodies and changes of the force on them.
+     *
+     * @param bodies All bodies of the simulation
+     * @param force Pair force law
+     */
+    void wakeChanged(const std::vector<Body*>& bodies, const PairForce& force);
+
+    /**
+     * @brief Advance the rest timers and put settled islands to sleep (end of a step).
+     *
+     * @param bodies All bodies of the simulation
+     * @param touching Touching pairs of the step (indices into bodies)
+     * @param step Duration of the step
+     * @param supported Static support test
+     * @param force Pair force law
+     */
+    void update(const std::vector<Body*>& bodies, const std::vector<std::pair<uint32_t, uint32_t>>& touching, float step, const Support& supported, const PairForce& force);
+
+    /**
+     * @brief Wake the island holding the body with the given index.
+     */
+    void wake(size_t body, const PairForce& force);
+
+    /**
+     * @brief Wake every tracked body (e.g. when sleeping is switched off).
+     */
+    void wakeAll();
+
+    /**
+     * @brief True if every non-source body is asleep.
+     */
+    bool allAsleep() const;
+
+    size_t getSleeping() const;
+
+private:
+    std::vector<Body*> Tracked;              ///< Bodies the per-body data belongs to
+    std::vector<float> RestTime;             ///< Time spent below SLEEP_VELOCITY
+    std::vector<int> Island;                 ///< Island of a sleeping body (-1 while awake)
+    std::vector<glm::dvec3> StaticForce;     ///< Force from the other sleeping bodies
+    std::vector<glm::dvec3> SleepForce;      ///< Total force when the island fell asleep
+    std::vector<glm::vec3> SleepPosition;    ///< Position when the island fell asleep
+    int NextIsland;
+    size_t Active;                           ///< Non-source bodies that are awake
+
+    /**
+     * @brief Start over (everything awake) if the body list changed.
+     */
+    void track(const std::vector<Body*>& bodies);
+
+    /**
+     * @brief Wake the given islands and remove their pull from the remaining sleepers.
+     */
+    void wakeIslands(std::vector<int> islands, const PairForce& force);
+};
+
+#endif
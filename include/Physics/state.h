@@ -0,0 +1,118 @@
+/**
+ * @file state.h
+ * @author DotBox
+ * @brief Double precision N-body state shared by the high-order integrators
+ *
+ * The Euler path in Physics works directly on Body objects in single precision.
+ * The higher order integrators need far more headroom than float offers, so they
+ * operate on this mirror of the simulation instead: masses, positions and
+ * velocities stored as doubles, plus helpers to flatten the state into a single
+ * vector y = [x₀ y₀ z₀ ... xₙ yₙ zₙ, vx₀ vy₀ vz₀ ... vxₙ vyₙ vzₙ] for the
+ * generic ODE machinery.
+ *
+ * Every double precision path (computeAccelerations, computeDerivative, the
+ * Taylor series and the variational equations) uses plain Newtonian gravity
+ * without the minimum distance clamp of the Euler path, so the adaptive
+ * integrators see one smooth force law and differ only in how they step.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef STATE_H
+#define STATE_H
+
+#include <vector>
+#include <functional>
+#include <glm/glm.hpp>
+
+struct SystemState {
+    std::vector<double>     Mass;       ///< Body masses (kg)
+    std::vector<glm::dvec3> Position;   ///< Body positions (world units)
+    std::vector<glm::dvec3> Velocity;   ///< Body velocities (world units / s)
+    double                  Time = 0.0; ///< Simulation time of this state (s)
+
+    size_t size() const { return Mass.size(); }
+
+    void resize(size_t n) {
+        Mass.resize(n, 0.0);
+        Position.resize(n, glm::dvec3(0.0));
+        Velocity.resize(n, glm::dvec3(0.0));
+    }
+
+    /**
+     * @brief Flatten positions and velocities into y (size 6N).
+     */
+    void pack(std::vector<double>& y) const;
+
+    /**
+     * @brief Restore positions and velocities from a flat vector y (size 6N).
+     */
+    void unpack(const std::vector<double>& y);
+};
+
+/**
+ * @brief Advances a state by a time interval (state.Time included).
+ *
+ * Propagators handed to drivers that run several of them at once (Parareal)
+ * must be reentrant, i.e. keep no shared mutable state between calls.
+ */
+using Propagator = std::function<void(SystemState& state, double interval)>;
+
+/**
+ * @brief Newtonian gravitational accelerations for every body in the state.
+ *
+ * Plain pairwise sum a_i = Σ G m_j (r_j - r_i) / |r_j - r_i|³ without any
+ * softening, so the integrator sees the true force law.
+ *
+ * @param state Current system state
+ * @param acc Output accelerations (resized to state.size())
+ */
+void computeAccelerations(const SystemState& state, std::vector<glm::dvec3>& acc);
+
+/**
+ * @brief First order form y' = f(y) of the N-body equations on a flat state.
+ *
+ * @param mass Body masses (N entries)
+ * @param y Flat state as produced by SystemState::pack
+ * @param dydt Output derivative [v, a] (resized to y.size())
+ */
+void computeDerivative(const std::vector<double>& mass, const std::vector<double>& y, std::vector<double>& dydt);
+
+/**
+ * @brief Accelerations and their first order variations in a single pair sweep.
+ *
+ * For a tangent vector (δr, δv) the variational equations read δr' = δv and
+ *
+ *   δa_i = Σ_j G m_j [ δr_ij / r_ij³ - 3 (r_ij · δr_ij) r_ij / r_ij⁵ ]
+ *
+ * with r_ij = r_j - r_i. Both sums share the pair distances, so the tangent
+ * costs a fraction of a second force evaluation.
+ *
+ * @param state Current system state
+ * @param dPos Tangent position components δr (N entries)
+ * @param acc Output accelerations (resized to state.size())
+ * @param dAcc Output variations δa (resized to state.size())
+ */
+void computeVariations(const SystemState& state, const std::vector<glm::dvec3>& dPos,
+                       std::vector<glm::dvec3>& acc, std::vector<glm::dvec3>& dAcc);
+
+/**
+ * @brief First order form of the N-body equations together with one tangent vector.
+ *
+ * @param mass Body masses (N entries)
+ * @param y Flat state [r, v, δr, δv] (12N entries)
+ * @param dydt Output derivative [v, a, δv, δa] (resized to y.size())
+ */
+void computeVariationalDerivative(const std::vector<double>& mass, const std::vector<double>& y, std::vector<double>& dydt);
+
+/**
+ * @brief Total mechanical energy (kinetic + gravitational potential).
+ *
+ * Used as the diagnostic for integrator accuracy: a perfect integrator
+ * keeps this constant for an isolated system.
+ */
+double totalEnergy(const SystemState& state);
+
+#endif
@@ -0,0 +1,78 @@
+/**
+ * @file stepController.h
+ * @author DotBox
+ * @brief Adaptive global timestep selection (Aarseth-style criterion)
+ *
+ * A fixed dt is either wasteful in quiet phases or far too coarse during close
+ * approaches. The controller picks the next global step from how fast the
+ * accelerations are changing:
+ *
+ *   dtᵢ = η |aᵢ| / |ȧᵢ|,      dt = minᵢ dtᵢ
+ *
+ * where the jerk ȧ is evaluated analytically from the current positions and
+ * velocities (ȧᵢ = Σⱼ G mⱼ [vᵢⱼ/r³ - 3 (rᵢⱼ·vᵢⱼ) rᵢⱼ / r⁵]), so it anticipates
+ * an approach instead of reacting after the fact. The result is limited to
+ * doubling per step and clamped to [MinStep, MaxStep].
+ *
+ * Pairs the engine regularizes (KS pairs, chain subsystems) can be excluded,
+ * since their internal time scale no longer limits the global step.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef STEP_CONTROLLER_H
+#define STEP_CONTROLLER_H
+
+#include <vector>
+#include <functional>
+#include "body.h"
+
+class StepController {
+public:
+    /// Returns true for pairs that should not limit the step
+    using PairFilter = std::function<bool(Body& one, Body& two)>;
+
+    /**
+     * @brief Construct with η = 0.02 and steps between 1e-5 s and 1/60 s.
+     */
+    StepController();
+
+    /**
+     * @brief Construct with custom bounds.
+     *
+     * @param minStep Smallest allowed step
+     * @param maxStep Largest allowed step
+     */
+    StepController(double minStep, double maxStep);
+
+    void setBounds(double minStep, double maxStep);
+
+    /**
+     * @brief Accuracy parameter η (smaller = smaller steps).
+     */
+    void setAccuracy(double eta);
+
+    /**
+     * @brief Choose the next step for the current body state.
+     *
+     * @param bodies All bodies in the simulation (light sources are ignored)
+     * @param exclude Optional filter for pairs that should not limit the step
+     * @return Step size within [MinStep, MaxStep]
+     */
+    double suggest(const std::vector<Body*>& bodies, const PairFilter& exclude = nullptr);
+
+    /**
+     * @brief Forget the previous step (removes the growth limit once).
+     */
+    void reset();
+
+private:
+    double Eta;       ///< Accuracy parameter
+    double MinStep;   ///< Lower bound on the step
+    double MaxStep;   ///< Upper bound on the step
+    double Step;      ///< Previously suggested step (0 = none)
+};
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file taylor.h
+ * @author DotBox
+ * @brief High-order Taylor series integrator driven by automatic differentiation
+ *
+ * Instead of sampling the force at many trial points, this integrator expands
+ * the whole trajectory into a Taylor series around the current state:
+ *
+ *   x(t₀ + h) = Σₖ Xₖ hᵏ,    v(t₀ + h) = Σₖ Vₖ hᵏ
+ *
+ * The coefficients come from Taylor-mode automatic differentiation of the
+ * gravity law. Each pair separation d = xⱼ - xᵢ, its square s = d·d and the
+ * factor q = s^(-3/2) are propagated as truncated power series using the
+ * standard recurrences for products and real powers:
+ *
+ *   sₖ = Σₗ dₗ·dₖ₋ₗ
+ *   qₖ = 1/(k s₀) Σⱼ₌₀..ₖ₋₁ (α(k-j) - j) sₖ₋ⱼ qⱼ     with α = -3/2
+ *   aₖ = Σₗ dₗ qₖ₋ₗ
+ *
+ * and Xₖ₊₁ = Vₖ/(k+1), Vₖ₊₁ = Aₖ/(k+1) close the recursion.
+ *
+ * Order and step are chosen afresh on every step from the decay of the
+ * coefficients. The series is built one order at a time; for each order p the
+ * last two coefficients give the step that meets the tolerance, and the order
+ * with the least work per unit time ((p + 4)² / h) is kept. Near close encounters,
+ * where the coefficients decay slowly, this settles on higher orders than in
+ * quiet stretches. For a fixed radius of convergence the optimum is the
+ * p ≈ -½ ln ε + 1 of Jorba & Zou, so at tight tolerances the steps are far
+ * longer than any fixed-order scheme can afford.
+ * The coefficients of the last step are kept, giving dense output anywhere
+ * inside it for the price of a polynomial evaluation.
+ *
+ * A tangent vector (δr, δv) of the variational equations can ride along: its
+ * series follow from the variation of the same recurrences,
+ *
+ *   δsₖ = 2 Σₗ dₗ·δdₖ₋ₗ,   δq = α s^(α-1) δs,   δaₖ = Σₗ δdₗ qₖ₋ₗ + dₗ δqₖ₋ₗ
+ *
+ * with s^(α-1) from the power recurrence, at about 2.5 times the cost of the
+ * state alone (see ChaosIndicator::propagate).
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef TAYLOR_H
+#define TAYLOR_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Physics/state.h"
+
+inline constexpr unsigned TAYLOR_MIN_ORDER = 6;     ///< Lowest series order tried
+inline constexpr unsigned TAYLOR_MAX_ORDER = 40;    ///< Highest series order tried
+
+class TaylorIntegrator {
+public:
+    /**
+     * @brief Construct with the default tolerance (1e-12).
+     */
+    TaylorIntegrator();
+
+    /**
+     * @brief Construct with a custom tolerance.
+     *
+     * @param tolerance Local error tolerance per step (relative to state magnitude)
+     */
+    TaylorIntegrator(double tolerance);
+
+    /**
+     * @brief Set the local error tolerance.
+     */
+    void setTolerance(double tolerance);
+
+    /**
+     * @brief Advance the state by exactly `interval` (state.Time is advanced too).
+     *
+     * @param state System state, overwritten with the state at the end of the interval
+     * @param interval Length of the interval to integrate over
+     * @return false if no usable series exists (coincident bodies, overflow); the state is left as it was
+     */
+    bool integrate(SystemState& state, double interval);
+
+    /**
+     * @brief Advance the state and a tangent vector of the variational equations by exactly `interval`.
+     *
+     * The steps are chosen from the state series alone; the tangent (one
+     * entry per body) is advanced in place. Returns false, leaving both as
+     * they were, in the same cases as integrate() without a tangent.
+     */
+    bool integrate(SystemState& state, double interval, std::vector<glm::dvec3>& tangentPosition, std::vector<glm::dvec3>& tangentVelocity);
+
+    /**
+     * @brief Take a single step of the natural (error-controlled) size.
+     *
+     * @param state System state, advanced in place
+     * @return Size of the step taken (0, state unchanged, if no usable series exists)
+     */
+    double step(SystemState& state);
+
+    /**
+     * @brief Dense output: evaluate the last computed series at time t.
+     *
+     * Valid for t between getStepStart() and getStepEnd(), which covers the
+     * full natural step even when integrate() truncated it to hit an interval end.
+     *
+     * @param t Absolute simulation time
+     * @param out Receives the interpolated state (masses copied from the step start)
+     * @return false if no step has been computed or t lies outside the valid range
+     */
+    bool evaluate(double t, SystemState& out) const;
+
+    double getStepStart() const;
+    double getStepEnd() const;
+
+    /// Order of the last series (before the first step: the Jorba & Zou order of the tolerance)
+    unsigned getOrder() const;
+
+    /// Number of Taylor expansions computed since construction
+    unsigned long getExpansions() const;
+
+private:
+    double Tolerance;            ///< Local error tolerance
+    unsigned Order;              ///< Series order p of the last step
+    unsigned long Expansions;    ///< Expansion counter
+
+    // Dense output of the last expansion
+    SystemState Start;           ///< State the series is expanded around
+    double ValidStep;            ///< Natural step size, i.e. the trusted range of the series
+    bool HasSeries;              ///< True once a series has been computed
+
+    std::vector<std::vector<glm::dvec3>> X;  ///< Position coefficients X[k][body]
+    std::vector<std::vector<glm::dvec3>> V;  ///< Velocity coefficients V[k][body]
+
+    // Per pair series scratch (pair-major, TAYLOR_MAX_ORDER + 1 coefficients each)
+    std::vector<glm::dvec3> D;   ///< Separation series
+    std::vector<double> S;       ///< Squared distance series
+    std::vector<double> Q;       ///< Inverse cube distance series
+
+    // Tangent series, only filled when a tangent rides along
+    std::vector<std::vector<glm::dvec3>> DX;    ///< δr coefficients DX[k][body]
+    std::vector<std::vector<glm::dvec3>> DV;    ///< δv coefficients DV[k][body]
+    std::vector<glm::dvec3> DD;  ///< Separation variation series
+    std::vector<double> DS;      ///< Squared distance variation series
+    std::vector<double> W;       ///< s^(α-1) series
+    std::vector<double> DQ;      ///< Inverse cube distance variation series
+
+    /**
+     * @brief Compute X[0..p] and V[0..p] around the given state, choosing the order p and the step.
+     *
+     * With a tangent, DX and DV are expanded alongside.
+     *
+     * @return false if the series is not finite or allows no step (the last series is dropped)
+     */
+    bool expand(const SystemState& state, const std::vector<glm::dvec3>* tangentPosition, const std::vector<glm::dvec3>* tangentVelocity);
+
+    /**
+     * @brief Natural step size of the series of order p, from its last two coefficients (0 if they are not finite).
+     */
+    double naturalStep(unsigned p) const;
+
+    /**
+     * @brief Sum the stored series at offset h from the expansion point.
+     */
+    void sum(double h, SystemState& out) const;
+
+    /**
+     * @brief Sum the stored tangent series at offset h.
+     */
+    void sumTangent(double h, std::vector<glm::dvec3>& tangentPosition, std::vector<glm::dvec3>& tangentVelocity) const;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file variational.h
+ * @author DotBox
+ * @brief Tangent vector integration with MEGNO and Lyapunov chaos indicators
+ *
+ * Deciding whether an orbit is chaotic used to mean integrating a second,
+ * slightly displaced copy of it and watching the two separate. The
+ * variational equations give the same information from the linearized flow:
+ * a tangent vector δ = (δr, δv) is carried along with the state,
+ *
+ *   δr' = δv,   δa_i = Σ_j G m_j [ δr_ij / r_ij³ - 3 (r_ij · δr_ij) r_ij / r_ij⁵ ]
+ *
+ * sharing the pair distances of the force sum (computeVariations). From the
+ * growth of |δ| two indicators are accumulated:
+ *
+ * - MEGNO (Cincotta & Simó 2000): Y(t) = (2/t) ∫ (δ̇·δ / δ²) s ds and its running
+ *   mean ⟨Y⟩. ⟨Y⟩ → 2 for quasi-periodic orbits, 0 for stable periodic ones,
+ *   and grows like λt/2 for chaotic ones, so it separates the cases long
+ *   before the Lyapunov exponent converges.
+ * - The finite time maximal Lyapunov exponent λ(t) = ln(|δ(t)| / |δ(0)|) / t.
+ *
+ * Since δ̇·δ / δ² = d ln|δ| / dt, both are accumulated from the change of ln|δ|
+ * over each step, so any integrator that advances the tangent can feed them.
+ * The tangent is renormalized after every step (the equations are linear), so
+ * it never overflows on strongly chaotic orbits.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef VARIATIONAL_H
+#define VARIATIONAL_H
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Physics/state.h"
+#include "Physics/bulirschStoer.h"
+#include "Physics/taylor.h"
+
+class ChaosIndicator {
+public:
+    /**
+     * @brief Construct with the default tolerance (1e-12) for integrate().
+     */
+    ChaosIndicator();
+
+    ChaosIndicator(double tolerance);
+
+    void setTolerance(double tolerance);
+
+    /**
+     * @brief Start a new run with a random unit tangent vector.
+     *
+     * @param bodies Number of bodies in the states this indicator will follow
+     * @param seed Seed for the tangent direction (fixed seeds make runs reproducible)
+     */
+    void reset(size_t bodies, unsigned seed = 1);
+
+    /// Number of bodies the tangent vector is sized for
+    size_t size() const;
+
+    /**
+     * @brief Integrate state and tangent by `interval`, sampling every `sample`.
+     *
+     * Uses the indicator's own Bulirsch–Stoer integrator on the combined
+     * [r, v, δr, δv] system. Typical use is classifying ensembles of initial
+     * conditions: reset(), integrate() over many orbits, read getMegno().
+     *
+     * @param state State advanced in place (state.Time included)
+     * @param interval Time to integrate
+     * @param sample Spacing of the indicator updates (≤ 0 = once at the end)
+     * @return false if the integrator gave up on a step; state stops at the last sample
+     */
+    bool integrate(SystemState& state, double interval, double sample);
+
+    /**
+     * @brief Advance state and tangent together with an external integrator.
+     *
+     * Keeps the step history of `integrator`, so a simulation already using
+     * Bulirsch–Stoer pays only for the longer state vector.
+     *
+     * @return false if the integrator gave up on a step; state and tangent are left as they were
+     */
+    bool propagate(SystemState& state, double interval, BulirschStoer& integrator);
+
+    /**
+     * @brief Advance state and tangent together in the Taylor series of `integrator`.
+     *
+     * @return false if the integrator found no usable series; state and tangent are left as they were
+     */
+    bool propagate(SystemState& state, double interval, TaylorIntegrator& integrator);
+
+    /**
+     * @brief Semi-implicit Euler step of the tangent alone, linearized at `start`.
+     *
+     * For trajectories advanced elsewhere by the same scheme (the Euler loop).
+     */
+    void eulerStep(const SystemState& start, double h);
+
+    /// Running MEGNO ⟨Y⟩ (0 before the first step)
+    double getMegno() const;
+
+    /// Finite time maximal Lyapunov exponent estimate (1/time units)
+    double getLyapunov() const;
+
+    /// Time covered since reset()
+    double getTime() const;
+
+private:
+    BulirschStoer Integrator;                  ///< Used by integrate()
+    std::vector<glm::dvec3> TangentPosition;   ///< δr
+    std::vector<glm::dvec3> TangentVelocity;   ///< δv
+
+    double Time;        ///< Time since reset
+    double Growth;      ///< ln(|δ(t)| / |δ(0)|) including all renormalizations
+    double Weighted;    ///< ∫ s d ln|δ(s)|
+    double Mean;        ///< ∫ Y dt
+    double LastY;       ///< Y at the last update
+
+    /**
+     * @brief Accumulate the indicators after the tangent advanced by `interval`,
+     * then renormalize it to unit length.
+     */
+    void record(double interval);
+};
+
+#endif
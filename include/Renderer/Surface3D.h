@@ -27,6 +27,9 @@ public:
     const int getVertexSize();
     const int getIndexSize();
     const int getIndexCount();
+    float getDistance() const;
+    float getSize() const;
+    surfaceOrientation getOrientation() const;
 
     // Setter functions
     void setDistance(float distance);
@@ -47,6 +47,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <algorithm>
 
 #include "shader.h"         // Shader wrapper (compile / link / uniform helpers)
 #include "camera.h"         // FPS style camera with mouse look
@@ -89,6 +90,16 @@ public:
      */
     void drawSphere(Body& body);
 
+    /**
+     * @brief Unregister a sphere body and release its GPU buffers
+     * 
+     * Used when the physics engine merges a body into another one and
+     * removes it from the simulation (see Physics::setRemovalCallback()).
+     * 
+     * @param body Body previously passed to drawSphere()
+     */
+    void removeSphere(Body& body);
+
     /**
      * @brief Register a surface for rendering
      * 
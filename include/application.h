@@ -78,13 +78,20 @@ public:
                     pEngine.push(ball_three, glm::vec3(multiplier * 0.7071f, multiplier * 0.7071f, 0.0f));
                 }
 
-                // Fixed timestep physics loop: process physics at constant rate
-                // regardless of rendering frame rate (ensures determinism)
-                while (accumulator >= dt) {
-
-                    pEngine.processFrame(bodies);
-                    accumulator -= dt;
-                }            
+                if (pEngine.isAdaptive()) {
+                    // Adaptive steps: the engine picks dt itself and ends exactly
+                    // on the frame time, so the display still samples at frame times
+                    pEngine.advance(bodies, accumulator);
+                    accumulator = 0.0f;
+                } else {
+                    // Fixed timestep physics loop: process physics at constant rate
+                    // regardless of rendering frame rate (ensures determinism)
+                    while (accumulator >= dt) {
+
+                        pEngine.processFrame(bodies);
+                        accumulator -= dt;
+                    }
+                }
             }
             timeCount++;
             rEngine.RenderFrame(bodies);
@@ -167,6 +174,9 @@ private:
         light.Force = glm::vec3(0.0f, 0.0f, 0.0f);       
         bodies.push_back(&light);
 
+        // Bodies merged away by the physics engine stop being drawn
+        pEngine.setRemovalCallback([this](Body& body) { rEngine.removeSphere(body); });
+
         // Register all spheres with renderer for drawing
         for (Body* body : bodies) {
             rEngine.drawSphere(*body);
@@ -185,6 +195,10 @@ private:
         wallOne.setWireframe(false);
         wallOne.mesh.inactive = true;
 
+        // Solid ground, free above. The renderer only keeps the last surface it is
+        // given, so the wall is neither drawn nor solid
+        pEngine.addSurface(surface, 1);
+
         rEngine.drawSurface(wallOne);
         rEngine.drawSurface(surface);
     }
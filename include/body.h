@@ -14,6 +14,8 @@ struct Body {
     glm::vec3 Force = glm::vec3(0);
     glm::vec3 vForceAccumulator = glm::vec3(0);
 
+    bool Sleeping = false;
+
     void setRadius(float radius) {
         sphere.setRadius(radius);
     }
@@ -0,0 +1,98 @@
+/**
+ * @file scenario.h
+ * @author DotBox
+ * @brief Scenes described in text files, for the drivers that run without a window
+ *
+ * The windowed demo builds its scene in code. Batch drivers read it from a
+ * scenario file instead, with one directive per line ('#' starts a comment):
+ *
+ *   step <dt>                               Frame length (s)
+ *   steps <N>                               Frames to run
+ *   integrator euler|bulirsch_stoer|taylor
+ *   tolerance <tol>                         Error tolerance of the high-order integrators
+ *   regularization <distance>               KS threshold (0: off, the default)
+ *   adaptive off|<min> <max> [eta]          Adaptive global step within [min, max] (accuracy η)
+ *   secular on|off                          Orbit-average stable hierarchical triples
+ *   chain <radius>                          Chain regularization radius
+ *   broadphase hash|sweep
+ *   skin <distance>                         Verlet neighbour list skin
+ *   continuous on|off
+ *   eventdriven on|off
+ *   substeps <k>                            Contact substeps per gravity step
+ *   sleep on|off
+ *   merge [density]                         Merge on contact instead of bouncing
+ *   solver elastic|impulse [iterations]
+ *   chaos on|off                            Track MEGNO and the Lyapunov exponent
+ *   event approach <body> <body> <distance> [stop]
+ *   event escape <body> [stop]
+ *   event plane <body> <px> <py> <pz> <nx> <ny> <nz> [stop]
+ *   body <name> <mass> <radius> <x> <y> <z> [<vx> <vy> <vz>] [light]
+ *   plane <px> <py> <pz> <nx> <ny> <nz>
+ *   box <lx> <ly> <lz> <ux> <uy> <uz>
+ *   surface <distance> <size> x|y|z [side]
+ *
+ * Bodies, the frame length and the frame count are read into the scenario;
+ * everything else is kept as text and applied to an engine later, so one
+ * scenario can be edited (e.g. by a parameter sweep) and run many times.
+ * Events are located inside the frame (see events.h); stop ends the run at
+ * the event. Malformed files raise std::runtime_error with the offending line.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Physics/physics.h"
+
+struct Scenario {
+    float Step = 1.0f / 60.0f;
+    long Steps = 600;
+    std::vector<std::string> Directives;    ///< Engine settings, applied once the engine exists
+    std::vector<int> Lines;                 ///< Line number of each directive
+    std::deque<Body> Bodies;                ///< Stable addresses for the engine's pointers
+
+    /**
+     * @brief Body with the given name, or nullptr.
+     */
+    Body* find(const std::string& name);
+
+    /**
+     * @brief Pointers to all bodies, in file order, for the engine.
+     */
+    std::vector<Body*> pointers();
+};
+
+/**
+ * @brief Read a scenario file.
+ */
+Scenario loadScenario(const std::string& path);
+
+/**
+ * @brief Apply the settings, colliders and events of a scenario to an engine.
+ *
+ * @param log Receives a line per event that fires (nullptr: events are silent)
+ */
+void configureEngine(Physics& engine, const Scenario& scenario, std::ostream* log = nullptr);
+
+/**
+ * @brief Run one frame of the scenario.
+ *
+ * processFrame(), or with the adaptive step on, advance() over the frame
+ * length in as many steps as the step controller asks for.
+ */
+void advanceFrame(Physics& engine, const Scenario& scenario, std::vector<Body*>& bodies);
+
+/**
+ * @brief Kinetic plus pairwise potential energy and total momentum of the non-source bodies.
+ */
+void systemTotals(const std::vector<Body*>& bodies, double& energy, glm::dvec3& momentum);
+
+#endif
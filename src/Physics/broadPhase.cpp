@@ -0,0 +1,288 @@
+#include "Physics/broadPhase.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Integer hash of a cell; the table size is a power of two
+static uint32_t hashCell(const glm::ivec3& cell, size_t buckets) {
+    uint32_t h = (uint32_t)cell.x * 73856093u ^ (uint32_t)cell.y * 19349663u ^ (uint32_t)cell.z * 83492791u;
+    return h & (uint32_t)(buckets - 1);
+}
+
+// areColliding() accepts d² ≤ (r₁ + r₂)² + EPSILON, covered by √EPSILON / 2 per box
+static float contactMargin() {
+    return 0.5f * std::sqrt((float)EPSILON);
+}
+
+// Bounding box of a sphere, stretched over its sweep when a start position is known
+static void sphereBox(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start, size_t i, float margin, glm::vec3& lower, glm::vec3& upper) {
+    Body* body = bodies[i];
+    glm::vec3 extent(body->sphere.geometry.getRadius() + margin);
+
+    lower = body->Position - extent;
+    upper = body->Position + extent;
+    if (i < start.size()) {
+        lower = glm::min(lower, start[i] - extent);
+        upper = glm::max(upper, start[i] + extent);
+    }
+}
+
+SpatialHash::SpatialHash() : CellSize(1.0f) {
+    Threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void SpatialHash::setThreads(unsigned threads) {
+    Threads = std::max(1u, threads);
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>>& SpatialHash::getPairs() const {
+    return Pairs;
+}
+
+float SpatialHash::getCellSize() const {
+    return CellSize;
+}
+
+glm::ivec3 SpatialHash::cellOf(const glm::vec3& point) const {
+    // Clamp so that runaway bodies cannot overflow the integer coordinates
+    const float limit = 1e9f;
+    glm::vec3 scaled = glm::clamp(point / CellSize, glm::vec3(-limit), glm::vec3(limit));
+    return glm::ivec3(glm::floor(scaled));
+}
+
+void SpatialHash::build(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start, float skin) {
+    const size_t n = bodies.size();
+    Pairs.clear();
+    Oversized.clear();
+    Entries.clear();
+
+    // Cell size from the median radius of the contact bodies
+    std::vector<float> radii;
+    for (Body* body : bodies) {
+        if (!body->sphere.mesh.source) radii.push_back(body->sphere.geometry.getRadius());
+    }
+    if (radii.size() < 2) return;
+
+    std::nth_element(radii.begin(), radii.begin() + radii.size() / 2, radii.end());
+    float median = radii[radii.size() / 2];
+
+    const float margin = contactMargin() + 0.5f * skin;
+    CellSize = std::max(4.0f * median, 4.0f * margin);
+
+    Lower.assign(n, glm::vec3(0.0f));
+    Upper.assign(n, glm::vec3(0.0f));
+
+    for (size_t i = 0; i < n; ++i) {
+        if (bodies[i]->sphere.mesh.source) continue;
+
+        sphereBox(bodies, start, i, margin, Lower[i], Upper[i]);
+
+        glm::ivec3 lo = cellOf(Lower[i]);
+        glm::ivec3 hi = cellOf(Upper[i]);
+        glm::ivec3 span = hi - lo + 1;
+        if (span.x > MAX_CELL_SPAN || span.y > MAX_CELL_SPAN || span.z > MAX_CELL_SPAN) {
+            Oversized.push_back((uint32_t)i);
+            continue;
+        }
+
+        for (int x = lo.x; x <= hi.x; ++x)
+            for (int y = lo.y; y <= hi.y; ++y)
+                for (int z = lo.z; z <= hi.z; ++z)
+                    Entries.push_back({ glm::ivec3(x, y, z), (uint32_t)i });
+    }
+
+    size_t buckets = 1;
+    while (buckets < 2 * Entries.size()) buckets <<= 1;
+    sortEntries(buckets);
+
+    auto overlap = [this](uint32_t a, uint32_t b) {
+        return glm::all(glm::lessThanEqual(Lower[a], Upper[b])) && glm::all(glm::lessThanEqual(Lower[b], Upper[a]));
+    };
+
+    // Pairs sharing a cell; hash collisions put foreign cells in the same bucket
+    for (size_t b = 0; b < buckets; ++b) {
+        for (uint32_t p = BucketStart[b]; p < BucketStart[b + 1]; ++p) {
+            const Entry& one = Sorted[p];
+            for (uint32_t q = p + 1; q < BucketStart[b + 1]; ++q) {
+                const Entry& two = Sorted[q];
+                if (one.Cell != two.Cell || one.Body == two.Body) continue;
+                if (!overlap(one.Body, two.Body)) continue;
+
+                // Report once: from the cell holding the intersection's lower corner
+                if (cellOf(glm::max(Lower[one.Body], Lower[two.Body])) != one.Cell) continue;
+
+                Pairs.emplace_back(std::min(one.Body, two.Body), std::max(one.Body, two.Body));
+            }
+        }
+    }
+
+    // Oversized bodies against everything else
+    std::vector<bool> isOversized(n, false);
+    for (uint32_t big : Oversized) isOversized[big] = true;
+
+    for (uint32_t big : Oversized) {
+        for (uint32_t i = 0; i < n; ++i) {
+            if (i == big || bodies[i]->sphere.mesh.source) continue;
+
+            // Two oversized bodies meet once, from the lower index
+            if (isOversized[i] && i < big) continue;
+            if (!overlap(big, i)) continue;
+
+            Pairs.emplace_back(std::min(big, i), std::max(big, i));
+        }
+    }
+
+    std::sort(Pairs.begin(), Pairs.end());
+}
+
+void SpatialHash::sortEntries(size_t buckets) {
+    const size_t count = Entries.size();
+    const unsigned threads = count >= PARALLEL_ENTRIES ? Threads : 1u;
+    const size_t chunk = (count + threads - 1) / threads;
+
+    Sorted.resize(count);
+    BucketStart.assign(buckets + 1, 0);
+    Counts.assign((size_t)threads * buckets, 0);
+
+    auto run = [threads](auto&& pass) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(pass, t);
+        }
+        pass(0u);
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+    };
+
+    // 1. Histogram of each slice
+    run([&](unsigned t) {
+        uint32_t* counts = Counts.data() + (size_t)t * buckets;
+        size_t end = std::min(count, (t + 1) * chunk);
+        for (size_t e = t * chunk; e < end; ++e) {
+            counts[hashCell(Entries[e].Cell, buckets)]++;
+        }
+    });
+
+    // 2. Exclusive prefix sum, bucket-major so each slice keeps its order
+    uint32_t offset = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        BucketStart[b] = offset;
+        for (unsigned t = 0; t < threads; ++t) {
+            uint32_t c = Counts[(size_t)t * buckets + b];
+            Counts[(size_t)t * buckets + b] = offset;
+            offset += c;
+        }
+    }
+    BucketStart[buckets] = offset;
+
+    // 3. Scatter
+    run([&](unsigned t) {
+        uint32_t* cursor = Counts.data() + (size_t)t * buckets;
+        size_t end = std::min(count, (t + 1) * chunk);
+        for (size_t e = t * chunk; e < end; ++e) {
+            Sorted[cursor[hashCell(Entries[e].Cell, buckets)]++] = Entries[e];
+        }
+    });
+}
+
+SweepAndPrune::SweepAndPrune() : Axis(0), Swaps(0) { }
+
+const std::vector<std::pair<uint32_t, uint32_t>>& SweepAndPrune::getPairs() const {
+    return Pairs;
+}
+
+int SweepAndPrune::getAxis() const {
+    return Axis;
+}
+
+size_t SweepAndPrune::getSwaps() const {
+    return Swaps;
+}
+
+int SweepAndPrune::chooseAxis(const std::vector<Body*>& bodies) const {
+    glm::dvec3 vSum(0.0), vSquare(0.0);
+    size_t count = 0;
+    for (Body* body : bodies) {
+        if (body->sphere.mesh.source) continue;
+        glm::dvec3 p(body->Position);
+        vSum += p;
+        vSquare += p * p;
+        ++count;
+    }
+    if (count < 2) return Axis;
+
+    glm::dvec3 vSpread = vSquare / (double)count - (vSum / (double)count) * (vSum / (double)count);
+
+    int best = Axis;
+    for (int a = 0; a < 3; ++a) {
+        if (vSpread[a] > vSpread[best]) best = a;
+    }
+    return vSpread[best] > AXIS_HYSTERESIS * vSpread[Axis] ? best : Axis;
+}
+
+void SweepAndPrune::insertionSort() {
+    for (size_t k = 1; k < Order.size(); ++k) {
+        uint32_t body = Order[k];
+        float key = Lower[body][Axis];
+
+        size_t m = k;
+        while (m > 0 && Lower[Order[m - 1]][Axis] > key) {
+            Order[m] = Order[m - 1];
+            --m;
+        }
+        Order[m] = body;
+        Swaps += k - m;
+    }
+}
+
+void SweepAndPrune::build(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start, float skin) {
+    const size_t n = bodies.size();
+    const float margin = contactMargin() + 0.5f * skin;
+    Pairs.clear();
+    Swaps = 0;
+
+    Lower.assign(n, glm::vec3(0.0f));
+    Upper.assign(n, glm::vec3(0.0f));
+    for (size_t i = 0; i < n; ++i) {
+        if (bodies[i]->sphere.mesh.source) continue;
+
+        sphereBox(bodies, start, i, margin, Lower[i], Upper[i]);
+    }
+
+    int axis = chooseAxis(bodies);
+
+    if (bodies != Tracked || axis != Axis) {
+        // New body set or axis: the old order says nothing, sort from scratch
+        Tracked = bodies;
+        Axis = axis;
+        Order.clear();
+        for (size_t i = 0; i < n; ++i) {
+            if (!bodies[i]->sphere.mesh.source) Order.push_back((uint32_t)i);
+        }
+        std::sort(Order.begin(), Order.end(), [this](uint32_t a, uint32_t b) {
+            return Lower[a][Axis] < Lower[b][Axis];
+        });
+    } else {
+        // Same bodies, small moves: nearly sorted already
+        insertionSort();
+    }
+
+    // Sweep: each box against the boxes starting before it ends on the axis
+    for (size_t k = 0; k < Order.size(); ++k) {
+        uint32_t one = Order[k];
+        float end = Upper[one][Axis];
+
+        for (size_t m = k + 1; m < Order.size(); ++m) {
+            uint32_t two = Order[m];
+            if (Lower[two][Axis] > end) break;
+
+            if (glm::all(glm::lessThanEqual(Lower[one], Upper[two])) && glm::all(glm::lessThanEqual(Lower[two], Upper[one]))) {
+                Pairs.emplace_back(std::min(one, two), std::max(one, two));
+            }
+        }
+    }
+
+    std::sort(Pairs.begin(), Pairs.end());
+}
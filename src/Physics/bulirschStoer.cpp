@@ -0,0 +1,176 @@
+#include "Physics/bulirschStoer.h"
+#include <algorithm>
+#include <cmath>
+
+// Deuflhard step number sequence n_j = 2(j + 1)
+static unsigned substeps(unsigned j) {
+    return 2 * (j + 1);
+}
+
+BulirschStoer::BulirschStoer() : Tolerance(1e-12), StepSize(0.0), Order(3), Evaluations(0) {
+    Table.resize(MAX_COLUMNS);
+}
+
+BulirschStoer::BulirschStoer(double tolerance) : Tolerance(tolerance), StepSize(0.0), Order(3), Evaluations(0) {
+    Table.resize(MAX_COLUMNS);
+}
+
+void BulirschStoer::setTolerance(double tolerance) {
+    Tolerance = tolerance;
+}
+
+void BulirschStoer::reset() {
+    StepSize = 0.0;
+    Order = 3;
+}
+
+unsigned long BulirschStoer::getEvaluations() const {
+    return Evaluations;
+}
+
+bool BulirschStoer::integrate(const Derivative& f, std::vector<double>& y, double interval) {
+    double t = 0.0;
+    double h = StepSize > 0.0 ? StepSize : interval;
+
+    auto midpoint = [&](const std::vector<double>& y0, double H, unsigned n, std::vector<double>& out) {
+        modifiedMidpoint(f, y0, H, n, out);
+    };
+
+    while (t < interval) {
+        double remaining = interval - t;
+        bool truncated = h >= remaining;
+        double H = truncated ? remaining : h;
+
+        // Every row of the tableau starts from the same derivative
+        f(y, dydt0);
+        Evaluations++;
+
+        double hNext;
+        if (step(midpoint, y, H, hNext)) {
+            t = truncated ? interval : t + H;
+
+            // A step shortened to hit the end of the interval says nothing about
+            // the natural step size, so keep the larger of the two suggestions.
+            h = truncated ? std::max(h, hNext) : hNext;
+        } else {
+            h = hNext;
+
+            // The step collapsed (e.g. a singular right hand side): give up on
+            // the rest of the interval rather than spin forever
+            if (h < MIN_STEP * interval) {
+                StepSize = 0.0;
+                Order = 3;
+                return false;
+            }
+        }
+    }
+
+    StepSize = h;
+    return true;
+}
+
+bool BulirschStoer::step(const Substepper& base, std::vector<double>& y, double H, double& hNext) {
+    double hNew[MAX_COLUMNS];
+    double work[MAX_COLUMNS];
+    double cost[MAX_COLUMNS];
+
+    std::vector<double> current;
+    std::vector<double> next(y.size());
+
+    const unsigned last = std::min(Order + 1, MAX_COLUMNS - 1);
+
+    for (unsigned j = 0; j <= last; ++j) {
+        base(y, H, substeps(j), current);
+        cost[j] = (j == 0 ? 1.0 : cost[j - 1]) + substeps(j);
+
+        // Neville extrapolation towards h → 0 in powers of h², keeping only
+        // the newest row of the tableau in Table[0..j]
+        for (unsigned k = 1; k <= j; ++k) {
+            double ratio = double(substeps(j)) / double(substeps(j - k));
+            double factor = 1.0 / (ratio * ratio - 1.0);
+
+            for (size_t i = 0; i < y.size(); ++i) {
+                next[i] = current[i] + (current[i] - Table[k - 1][i]) * factor;
+            }
+            Table[k - 1].swap(current);
+            current.swap(next);
+        }
+        Table[j] = current;
+
+        if (j == 0) continue;
+
+        double err = errorNorm(y, Table[j], Table[j - 1]);
+        double exponent = 1.0 / (2.0 * j + 1.0);
+        // A non-finite error (overflow, NaN from the right hand side) is the
+        // worst possible step: reject it and shrink as far as allowed
+        double fac = !std::isfinite(err) ? 0.02 : err > 0.0 ? 0.94 * std::pow(0.65 / err, exponent) : 4.0;
+        fac = std::clamp(fac, 0.02, 4.0);
+
+        hNew[j] = H * fac;
+        work[j] = cost[j] / hNew[j];
+
+        if (err <= 1.0) {
+            y = Table[j];
+
+            // Pick the order with the least work per unit step for next time
+            unsigned order = j;
+            if (j > 1 && work[j - 1] < 0.9 * work[j]) {
+                order = j - 1;
+            } else if (j + 1 < MAX_COLUMNS - 1 && work[j] < 0.9 * work[j - 1]) {
+                order = j + 1;
+            }
+
+            if (order == j + 1) {
+                hNext = hNew[j] * (cost[j] + substeps(j + 1)) / cost[j];
+            } else {
+                hNext = hNew[order];
+            }
+
+            Order = std::clamp(order, 2u, MAX_COLUMNS - 2);
+            return true;
+        }
+    }
+
+    hNext = hNew[last];
+    return false;
+}
+
+void BulirschStoer::modifiedMidpoint(const Derivative& f, const std::vector<double>& y0, double H, unsigned n, std::vector<double>& out) {
+    const size_t size = y0.size();
+    const double h = H / n;
+
+    zPrev = y0;
+    zCurr.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        zCurr[i] = y0[i] + h * dydt0[i];
+    }
+
+    for (unsigned m = 1; m < n; ++m) {
+        f(zCurr, dz);
+        for (size_t i = 0; i < size; ++i) {
+            double z = zPrev[i] + 2.0 * h * dz[i];
+            zPrev[i] = zCurr[i];
+            zCurr[i] = z;
+        }
+    }
+
+    f(zCurr, dz);
+    Evaluations += n;
+
+    out.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = 0.5 * (zCurr[i] + zPrev[i] + h * dz[i]);
+    }
+}
+
+double BulirschStoer::errorNorm(const std::vector<double>& y0, const std::vector<double>& a, const std::vector<double>& b) const {
+    double sum = 0.0;
+
+    for (size_t i = 0; i < y0.size(); ++i) {
+        double scale = Tolerance * (1.0 + std::max(std::abs(y0[i]), std::abs(a[i])));
+        double d = (a[i] - b[i]) / scale;
+        sum += d * d;
+    }
+
+    return std::sqrt(sum / y0.size());
+}
@@ -0,0 +1,37 @@
+#include "Physics/ccd.h"
+#include <cmath>
+
+bool sphereImpact(const glm::vec3& startOne, const glm::vec3& endOne, const glm::vec3& startTwo, const glm::vec3& endTwo, float radius, float& s) {
+    // Relative motion in double: the quadratic subtracts nearly equal terms
+    glm::dvec3 d0 = glm::dvec3(startTwo) - glm::dvec3(startOne);
+    glm::dvec3 delta = (glm::dvec3(endTwo) - glm::dvec3(startTwo)) - (glm::dvec3(endOne) - glm::dvec3(startOne));
+
+    // |d₀ + sΔ|² = R²  ⇔  a s² + b s + c = 0
+    double a = glm::dot(delta, delta);
+    double b = 2.0 * glm::dot(d0, delta);
+    double c = glm::dot(d0, d0) - (double)radius * radius;
+
+    // Already touching, or not approaching
+    if (c <= 0.0 || b >= 0.0) return false;
+
+    double disc = b * b - 4.0 * a * c;
+    if (disc < 0.0) return false;
+
+    // Smaller root in the form without cancellation (b < 0)
+    double root = 2.0 * c / (-b + std::sqrt(disc));
+    if (root > 1.0) return false;
+
+    s = (float)root;
+    return true;
+}
+
+bool planeImpact(const glm::vec3& start, const glm::vec3& end, float radius, const glm::vec3& point, const glm::vec3& normal, float& s) {
+    double d0 = glm::dot(glm::dvec3(start) - glm::dvec3(point), glm::dvec3(normal)) - radius;
+    double d1 = glm::dot(glm::dvec3(end) - glm::dvec3(point), glm::dvec3(normal)) - radius;
+
+    // Starts clear and ends in contact
+    if (d0 <= 0.0 || d1 > 0.0) return false;
+
+    s = (float)(d0 / (d0 - d1));
+    return true;
+}
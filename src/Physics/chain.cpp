@@ -0,0 +1,341 @@
+#include "Physics/chain.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+
+ChainIntegrator::ChainIntegrator() : Extrapolator(1e-12), StepSize(0.0), Binding(0.0) { }
+
+void ChainIntegrator::setTolerance(double tolerance) {
+    Extrapolator.setTolerance(tolerance);
+}
+
+std::vector<size_t> ChainIntegrator::buildChain(const SystemState& state) {
+    const size_t n = state.size();
+    std::vector<size_t> chain;
+    if (n == 0) return chain;
+    if (n == 1) return {0};
+
+    auto distSq = [&](size_t a, size_t b) {
+        glm::dvec3 d = state.Position[b] - state.Position[a];
+        return glm::dot(d, d);
+    };
+
+    // Start from the closest pair
+    size_t first = 0, second = 1;
+    double best = distSq(0, 1);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            double d = distSq(i, j);
+            if (d < best) { best = d; first = i; second = j; }
+        }
+    }
+
+    std::vector<bool> used(n, false);
+    std::vector<size_t> front{first}, back{second};
+    used[first] = used[second] = true;
+
+    // Attach the unused body closest to either end
+    for (size_t added = 2; added < n; ++added) {
+        size_t head = front.back();
+        size_t tail = back.back();
+        size_t pick = n;
+        bool atHead = false;
+        best = 0.0;
+
+        for (size_t k = 0; k < n; ++k) {
+            if (used[k]) continue;
+            double dHead = distSq(head, k);
+            double dTail = distSq(tail, k);
+            double d = std::min(dHead, dTail);
+            if (pick == n || d < best) {
+                best = d;
+                pick = k;
+                atHead = dHead < dTail;
+            }
+        }
+
+        used[pick] = true;
+        if (atHead) front.push_back(pick); else back.push_back(pick);
+    }
+
+    chain.assign(front.rbegin(), front.rend());
+    chain.insert(chain.end(), back.begin(), back.end());
+    return chain;
+}
+
+void ChainIntegrator::integrate(SystemState& state, double interval) {
+    const size_t n = state.size();
+    if (n == 0 || interval <= 0.0) return;
+
+    // Centre of mass moves uniformly; the chain works in its frame
+    double mTotal = 0.0;
+    glm::dvec3 vCentre(0.0), vCentreVel(0.0);
+    for (size_t i = 0; i < n; ++i) {
+        mTotal += state.Mass[i];
+        vCentre += state.Mass[i] * state.Position[i];
+        vCentreVel += state.Mass[i] * state.Velocity[i];
+    }
+    vCentre /= mTotal;
+    vCentreVel /= mTotal;
+
+    if (n == 1) {
+        state.Position[0] += state.Velocity[0] * interval;
+        state.Time += interval;
+        return;
+    }
+
+    SystemState local = state;
+    for (size_t i = 0; i < n; ++i) {
+        local.Position[i] -= vCentre;
+        local.Velocity[i] -= vCentreVel;
+    }
+
+    Binding = -totalEnergy(local);
+
+    auto rebuild = [&](std::vector<double>& y) {
+        Chain = buildChain(local);
+        Mass.resize(n);
+        for (size_t k = 0; k < n; ++k) Mass[k] = local.Mass[Chain[k]];
+        pack(local, y);
+    };
+
+    std::vector<double> y;
+    rebuild(y);
+    const size_t timeIndex = y.size() - 1;
+
+    auto base = [this](const std::vector<double>& y0, double H, unsigned steps, std::vector<double>& out) {
+        leapfrog(y0, H, steps, out);
+    };
+
+    std::vector<glm::dvec3> acc;
+    double h = StepSize > 0.0 ? StepSize : interval * accelerations(y, acc);
+
+    for (int guard = 0; guard < 100000; ++guard) {
+        double t = y[timeIndex];
+        double remaining = interval - t;
+        if (remaining <= 1e-14 * interval) break;
+
+        // dt/ds ≈ 1/U, so this fictitious step lands close to the target time
+        double aim = remaining * accelerations(y, acc);
+        bool aiming = aim <= h;
+        double H = aiming ? aim : h;
+
+        std::vector<double> trial = y;
+        double hNext;
+        if (!Extrapolator.step(base, trial, H, hNext)) {
+            h = hNext;
+            continue;
+        }
+
+        // Overshot the target: secant estimate of the step that hits it
+        if (trial[timeIndex] > interval + 1e-14 * interval) {
+            h = H * remaining / (trial[timeIndex] - t);
+            continue;
+        }
+
+        y = trial;
+        if (!aiming) h = hNext;
+
+        // Re-chain in case the nearest neighbours changed during the step
+        unpack(y, local.Position, local.Velocity);
+        double tNow = y[timeIndex];
+        rebuild(y);
+        y[timeIndex] = tNow;
+    }
+
+    StepSize = h;
+
+    unpack(y, local.Position, local.Velocity);
+    for (size_t i = 0; i < n; ++i) {
+        state.Position[i] = vCentre + vCentreVel * interval + local.Position[i];
+        state.Velocity[i] = vCentreVel + local.Velocity[i];
+    }
+    state.Time += interval;
+}
+
+void ChainIntegrator::pack(const SystemState& state, std::vector<double>& y) const {
+    const size_t links = Chain.size() - 1;
+    y.assign(6 * links + 1, 0.0);
+
+    for (size_t k = 0; k < links; ++k) {
+        glm::dvec3 X = state.Position[Chain[k + 1]] - state.Position[Chain[k]];
+        glm::dvec3 W = state.Velocity[Chain[k + 1]] - state.Velocity[Chain[k]];
+        for (int c = 0; c < 3; ++c) {
+            y[3 * k + c] = X[c];
+            y[3 * (links + k) + c] = W[c];
+        }
+    }
+}
+
+void ChainIntegrator::unpack(const std::vector<double>& y, std::vector<glm::dvec3>& pos, std::vector<glm::dvec3>& vel) const {
+    const size_t n = Chain.size();
+    const size_t links = n - 1;
+
+    // Walk the chain from its first body, then shift to the centre of mass
+    std::vector<glm::dvec3> q(n), w(n);
+    q[0] = w[0] = glm::dvec3(0.0);
+    for (size_t k = 0; k < links; ++k) {
+        q[k + 1] = q[k] + glm::dvec3(y[3 * k], y[3 * k + 1], y[3 * k + 2]);
+        w[k + 1] = w[k] + glm::dvec3(y[3 * (links + k)], y[3 * (links + k) + 1], y[3 * (links + k) + 2]);
+    }
+
+    double mTotal = 0.0;
+    glm::dvec3 qCentre(0.0), wCentre(0.0);
+    for (size_t k = 0; k < n; ++k) {
+        mTotal += Mass[k];
+        qCentre += Mass[k] * q[k];
+        wCentre += Mass[k] * w[k];
+    }
+    qCentre /= mTotal;
+    wCentre /= mTotal;
+
+    pos.resize(n);
+    vel.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        pos[Chain[k]] = q[k] - qCentre;
+        vel[Chain[k]] = w[k] - wCentre;
+    }
+}
+
+void ChainIntegrator::leapfrog(const std::vector<double>& y0, double H, unsigned n, std::vector<double>& y) const {
+    const double h = H / n;
+    y = y0;
+
+    drift(y, 0.5 * h);
+    for (unsigned i = 0; i < n; ++i) {
+        kick(y, h);
+        drift(y, i + 1 == n ? 0.5 * h : h);
+    }
+}
+
+void ChainIntegrator::drift(std::vector<double>& y, double ds) const {
+    const size_t n = Chain.size();
+    const size_t links = n - 1;
+
+    // Kinetic energy in the centre of mass frame from the chain velocities
+    std::vector<glm::dvec3> w(n);
+    w[0] = glm::dvec3(0.0);
+    double mTotal = Mass[0];
+    glm::dvec3 wCentre(0.0);
+    for (size_t k = 0; k < links; ++k) {
+        w[k + 1] = w[k] + glm::dvec3(y[3 * (links + k)], y[3 * (links + k) + 1], y[3 * (links + k) + 2]);
+        mTotal += Mass[k + 1];
+        wCentre += Mass[k + 1] * w[k + 1];
+    }
+    wCentre /= mTotal;
+
+    double kinetic = 0.0;
+    for (size_t k = 0; k < n; ++k) {
+        glm::dvec3 v = w[k] - wCentre;
+        kinetic += 0.5 * Mass[k] * glm::dot(v, v);
+    }
+
+    double dt = ds / (kinetic + Binding);
+
+    for (size_t k = 0; k < 3 * links; ++k) {
+        y[k] += y[3 * links + k] * dt;
+    }
+    y[6 * links] += dt;
+}
+
+void ChainIntegrator::kick(std::vector<double>& y, double ds) const {
+    const size_t links = Chain.size() - 1;
+
+    std::vector<glm::dvec3> acc;
+    double U = accelerations(y, acc);
+    double dt = ds / U;
+
+    for (size_t k = 0; k < links; ++k) {
+        glm::dvec3 dW = (acc[k + 1] - acc[k]) * dt;
+        y[3 * (links + k) + 0] += dW.x;
+        y[3 * (links + k) + 1] += dW.y;
+        y[3 * (links + k) + 2] += dW.z;
+    }
+}
+
+double ChainIntegrator::accelerations(const std::vector<double>& y, std::vector<glm::dvec3>& acc) const {
+    const size_t n = Chain.size();
+    const size_t links = n - 1;
+
+    std::vector<glm::dvec3> X(links), q(n);
+    q[0] = glm::dvec3(0.0);
+    for (size_t k = 0; k < links; ++k) {
+        X[k] = glm::dvec3(y[3 * k], y[3 * k + 1], y[3 * k + 2]);
+        q[k + 1] = q[k] + X[k];
+    }
+
+    acc.assign(n, glm::dvec3(0.0));
+    double U = 0.0;
+
+    for (size_t k = 0; k < n; ++k) {
+        for (size_t l = k + 1; l < n; ++l) {
+            // Near neighbours in the chain take their separation from chain sums
+            glm::dvec3 r;
+            if (l - k == 1) {
+                r = X[k];
+            } else if (l - k == 2) {
+                r = X[k] + X[k + 1];
+            } else {
+                r = q[l] - q[k];
+            }
+
+            double fDistSq = glm::dot(r, r);
+            double fDist = std::sqrt(fDistSq);
+            double fInvDist3 = 1.0 / (fDistSq * fDist);
+
+            U += GRAV_CONST * Mass[k] * Mass[l] / fDist;
+            acc[k] += (GRAV_CONST * Mass[l] * fInvDist3) * r;
+            acc[l] -= (GRAV_CONST * Mass[k] * fInvDist3) * r;
+        }
+    }
+
+    return U;
+}
+
+ChainSubsystem::ChainSubsystem(const std::vector<Body*>& members) : Members(members), Last(members.back()) { }
+
+bool ChainSubsystem::contains(const Body* body) const {
+    return std::find(Members.begin(), Members.end(), body) != Members.end();
+}
+
+void ChainSubsystem::begin() {
+    StartPosition.resize(Members.size());
+    for (size_t i = 0; i < Members.size(); ++i) {
+        StartPosition[i] = glm::dvec3(Members[i]->Position);
+    }
+}
+
+void ChainSubsystem::finish(double interval) {
+    const size_t n = Members.size();
+
+    SystemState local;
+    local.resize(n);
+
+    // Centre of mass motion (after external forces) and the starting frame
+    double mTotal = 0.0;
+    glm::dvec3 vCentre(0.0), vCentreVel(0.0), vStartCentre(0.0);
+    for (size_t i = 0; i < n; ++i) {
+        double m = Members[i]->Mass;
+        mTotal += m;
+        vCentre += m * glm::dvec3(Members[i]->Position);
+        vCentreVel += m * glm::dvec3(Members[i]->Velocity);
+        vStartCentre += m * StartPosition[i];
+    }
+    vCentre /= mTotal;
+    vCentreVel /= mTotal;
+    vStartCentre /= mTotal;
+
+    // Internal state: start positions, velocities already kicked by external forces
+    for (size_t i = 0; i < n; ++i) {
+        local.Mass[i] = Members[i]->Mass;
+        local.Position[i] = StartPosition[i] - vStartCentre;
+        local.Velocity[i] = glm::dvec3(Members[i]->Velocity) - vCentreVel;
+    }
+
+    Integrator.integrate(local, interval);
+
+    for (size_t i = 0; i < n; ++i) {
+        Members[i]->Position = glm::vec3(vCentre + local.Position[i]);
+        Members[i]->Velocity = glm::vec3(vCentreVel + local.Velocity[i]);
+    }
+}
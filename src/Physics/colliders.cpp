@@ -0,0 +1,179 @@
+#include "Physics/colliders.h"
+#include "Physics/physics.h"
+#include "Physics/ccd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const float UNBOUNDED = std::numeric_limits<float>::infinity();
+
+ColliderSet::ColliderSet() { }
+
+size_t ColliderSet::addFace(const glm::vec3& normal, float offset, bool sided, float depth, const glm::vec3& lower, const glm::vec3& upper) {
+    NormalX.push_back(normal.x);
+    NormalY.push_back(normal.y);
+    NormalZ.push_back(normal.z);
+    Offset.push_back(offset);
+    Sided.push_back(sided ? 1 : 0);
+    Depth.push_back(depth);
+    LowerX.push_back(lower.x);
+    LowerY.push_back(lower.y);
+    LowerZ.push_back(lower.z);
+    UpperX.push_back(upper.x);
+    UpperY.push_back(upper.y);
+    UpperZ.push_back(upper.z);
+    return Offset.size() - 1;
+}
+
+size_t ColliderSet::addPlane(const glm::vec3& point, const glm::vec3& normal) {
+    glm::vec3 n = glm::normalize(normal);
+    return addFace(n, glm::dot(n, point), true, UNBOUNDED, glm::vec3(-UNBOUNDED), glm::vec3(UNBOUNDED));
+}
+
+size_t ColliderSet::addSurface(const Surface3D& surface, int side) {
+    // Same layout as Surface3D::generateVertices(): a square of the surface's
+    // size centred on the axis, on the plane axis = distance
+    const float half = surface.getSize() * 0.5f;
+    const float distance = surface.getDistance();
+
+    int axis = 1;
+    switch (surface.getOrientation()) {
+        case surfaceOrientation::X: axis = 0; break;
+        case surfaceOrientation::Y: axis = 1; break;
+        case surfaceOrientation::Z: axis = 2; break;
+    }
+
+    glm::vec3 normal(0.0f), lower(-half), upper(half);
+    normal[axis] = side < 0 ? -1.0f : 1.0f;
+    lower[axis] = -UNBOUNDED;
+    upper[axis] = UNBOUNDED;
+
+    return addFace(normal, normal[axis] * distance, side != 0, UNBOUNDED, lower, upper);
+}
+
+void ColliderSet::addBox(const glm::vec3& lower, const glm::vec3& upper) {
+    glm::vec3 half = 0.5f * (upper - lower);
+
+    for (int axis = 0; axis < 3; ++axis) {
+        // The face acts over the box's other two extents
+        glm::vec3 faceLower = lower, faceUpper = upper;
+        faceLower[axis] = -UNBOUNDED;
+        faceUpper[axis] = UNBOUNDED;
+
+        glm::vec3 normal(0.0f);
+        normal[axis] = 1.0f;
+        addFace(normal, upper[axis], true, half[axis], faceLower, faceUpper);
+
+        normal[axis] = -1.0f;
+        addFace(normal, -lower[axis], true, half[axis], faceLower, faceUpper);
+    }
+}
+
+void ColliderSet::clear() {
+    for (std::vector<float>* column : { &NormalX, &NormalY, &NormalZ, &Offset, &Depth, &LowerX, &LowerY, &LowerZ, &UpperX, &UpperY, &UpperZ }) {
+        column->clear();
+    }
+    Sided.clear();
+}
+
+size_t ColliderSet::size() const {
+    return Offset.size();
+}
+
+bool ColliderSet::empty() const {
+    return Offset.empty();
+}
+
+bool ColliderSet::inside(size_t face, const glm::vec3& position) const {
+    return position.x >= LowerX[face] && position.x <= UpperX[face] &&
+           position.y >= LowerY[face] && position.y <= UpperY[face] &&
+           position.z >= LowerZ[face] && position.z <= UpperZ[face];
+}
+
+void ColliderSet::findContacts(const std::vector<Body*>& bodies, std::vector<std::pair<uint32_t, uint32_t>>& contacts) {
+    contacts.clear();
+    if (empty()) return;
+
+    BodyX.clear();
+    BodyY.clear();
+    BodyZ.clear();
+    BodyRadius.clear();
+    BodyIndex.clear();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Body* body = bodies[i];
+        if (body->sphere.mesh.source || body->Sleeping) continue;
+
+        BodyX.push_back(body->Position.x);
+        BodyY.push_back(body->Position.y);
+        BodyZ.push_back(body->Position.z);
+        BodyRadius.push_back(body->sphere.geometry.getRadius());
+        BodyIndex.push_back((uint32_t)i);
+    }
+
+    const size_t count = BodyIndex.size();
+    const float* x = BodyX.data();
+    const float* y = BodyY.data();
+    const float* z = BodyZ.data();
+    const float* r = BodyRadius.data();
+    const float tolerance = (float)EPSILON;
+    Hits.resize(count);
+    uint8_t* hits = Hits.data();
+
+    for (size_t f = 0; f < size(); ++f) {
+        const float nx = NormalX[f], ny = NormalY[f], nz = NormalZ[f], d = Offset[f];
+        const float depth = Sided[f] ? Depth[f] : UNBOUNDED;
+        const float lx = LowerX[f], ly = LowerY[f], lz = LowerZ[f];
+        const float ux = UpperX[f], uy = UpperY[f], uz = UpperZ[f];
+        const bool sided = Sided[f] != 0;
+
+        // Branch-free over the bodies: one SIMD lane per body
+        for (size_t i = 0; i < count; ++i) {
+            float dist = nx * x[i] + ny * y[i] + nz * z[i] - d;
+            float gap = (sided ? dist : std::fabs(dist)) - r[i];
+
+            hits[i] = (gap <= tolerance) & (dist >= -depth) &
+                      (x[i] >= lx) & (x[i] <= ux) &
+                      (y[i] >= ly) & (y[i] <= uy) &
+                      (z[i] >= lz) & (z[i] <= uz);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (hits[i]) contacts.emplace_back(BodyIndex[i], (uint32_t)f);
+        }
+    }
+
+    std::sort(contacts.begin(), contacts.end());
+}
+
+bool ColliderSet::touches(const glm::vec3& position, float radius) const {
+    for (size_t f = 0; f < size(); ++f) {
+        float dist = NormalX[f] * position.x + NormalY[f] * position.y + NormalZ[f] * position.z - Offset[f];
+        float gap = (Sided[f] ? dist : std::fabs(dist)) - radius;
+        float depth = Sided[f] ? Depth[f] : UNBOUNDED;
+
+        if (gap <= (float)EPSILON && dist >= -depth && inside(f, position)) return true;
+    }
+    return false;
+}
+
+void ColliderSet::facing(size_t face, const glm::vec3& position, glm::vec3& normal, float& offset) const {
+    normal = glm::vec3(NormalX[face], NormalY[face], NormalZ[face]);
+    offset = Offset[face];
+
+    // A sheet pushes towards whichever side the body is on
+    if (!Sided[face] && glm::dot(normal, position) < offset) {
+        normal = -normal;
+        offset = -offset;
+    }
+}
+
+bool ColliderSet::sweep(size_t face, const glm::vec3& start, const glm::vec3& end, float radius, float& s) const {
+    glm::vec3 normal;
+    float offset;
+    facing(face, start, normal, offset);
+
+    if (!planeImpact(start, end, radius, normal * offset, normal, s)) return false;
+
+    // Only where the face exists
+    return inside(face, start + s * (end - start));
+}
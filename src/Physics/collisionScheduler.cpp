@@ -0,0 +1,42 @@
+#include "Physics/collisionScheduler.h"
+
+CollisionScheduler::CollisionScheduler() : Processed(0), Stale(0) { }
+
+void CollisionScheduler::reset(size_t bodies) {
+    Queue = decltype(Queue)();
+    Counts.assign(bodies, 0);
+    Processed = 0;
+    Stale = 0;
+}
+
+void CollisionScheduler::schedule(float time, uint32_t one, uint32_t two, uint32_t pair) {
+    uint32_t countTwo = two == SCHEDULE_SURFACE ? 0 : Counts[two];
+    Queue.push({ time, one, two, pair, Counts[one], countTwo });
+}
+
+void CollisionScheduler::invalidate(uint32_t body) {
+    Counts[body]++;
+}
+
+bool CollisionScheduler::next(CollisionEvent& event) {
+    while (!Queue.empty()) {
+        event = Queue.top();
+        Queue.pop();
+
+        bool valid = event.CountOne == Counts[event.One] && (event.Two == SCHEDULE_SURFACE || event.CountTwo == Counts[event.Two]);
+        if (valid) {
+            Processed++;
+            return true;
+        }
+        Stale++;
+    }
+    return false;
+}
+
+size_t CollisionScheduler::getProcessed() const {
+    return Processed;
+}
+
+size_t CollisionScheduler::getStale() const {
+    return Stale;
+}
@@ -0,0 +1,92 @@
+#include "Physics/contactGraph.h"
+#include <algorithm>
+#include <thread>
+
+ContactGraph::ContactGraph() : Overflow(false) {
+    Threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ContactGraph::setThreads(unsigned threads) {
+    Threads = std::max(1u, threads);
+}
+
+size_t ContactGraph::getBatches() const {
+    return BatchStart.empty() ? 0 : BatchStart.size() - 1;
+}
+
+void ContactGraph::build(const std::vector<std::pair<uint32_t, uint32_t>>& contacts, size_t bodies) {
+    // Colours in use at each body, one bit per colour
+    std::vector<uint64_t> used(bodies, 0);
+    std::vector<int> colors(contacts.size());
+    std::vector<uint32_t> counts(MAX_CONTACT_COLORS + 1, 0);
+
+    for (size_t k = 0; k < contacts.size(); ++k) {
+        auto [one, two] = contacts[k];
+        uint64_t free = ~(used[one] | used[two]);
+
+        int color = MAX_CONTACT_COLORS;
+        if (free != 0) {
+            color = 0;
+            while (!(free & (1ull << color))) ++color;
+            used[one] |= 1ull << color;
+            used[two] |= 1ull << color;
+        }
+        colors[k] = color;
+        counts[color]++;
+    }
+
+    // Drop unused colours; greedy colouring fills them from the bottom
+    int last = 0;
+    while (last < MAX_CONTACT_COLORS && counts[last] > 0) ++last;
+    Overflow = counts[MAX_CONTACT_COLORS] > 0;
+    if (Overflow) {
+        counts[last] = counts[MAX_CONTACT_COLORS];
+        for (int& color : colors) {
+            if (color == MAX_CONTACT_COLORS) color = last;
+        }
+        ++last;
+    }
+
+    // Counting sort by colour, stable so each batch keeps the contact order
+    BatchStart.assign(last + 1, 0);
+    for (int c = 0; c < last; ++c) {
+        BatchStart[c + 1] = BatchStart[c] + counts[c];
+    }
+
+    std::vector<uint32_t> cursor(BatchStart.begin(), BatchStart.end() - 1);
+    Sorted.resize(contacts.size());
+    for (size_t k = 0; k < contacts.size(); ++k) {
+        Sorted[cursor[colors[k]]++] = (uint32_t)k;
+    }
+}
+
+void ContactGraph::resolve(const std::function<void(uint32_t contact)>& resolve) const {
+    for (size_t b = 0; b + 1 < BatchStart.size(); ++b) {
+        const uint32_t begin = BatchStart[b];
+        const uint32_t end = BatchStart[b + 1];
+
+        bool serial = (Overflow && b + 2 == BatchStart.size()) || end - begin < PARALLEL_CONTACTS || Threads == 1;
+        if (serial) {
+            for (uint32_t p = begin; p < end; ++p) resolve(Sorted[p]);
+            continue;
+        }
+
+        // Independent contacts: contiguous slices per thread
+        const uint32_t chunk = (end - begin + Threads - 1) / Threads;
+        auto worker = [&, chunk](unsigned t) {
+            uint32_t first = begin + t * chunk;
+            uint32_t last = std::min(end, first + chunk);
+            for (uint32_t p = first; p < last; ++p) resolve(Sorted[p]);
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < Threads; ++t) {
+            pool.emplace_back(worker, t);
+        }
+        worker(0u);
+
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+    }
+}
@@ -0,0 +1,196 @@
+#include "Physics/contactSolver.h"
+#include <algorithm>
+#include <functional>
+
+bool ContactSolver::Key::operator<(const Key& other) const {
+    // Handles of unrelated bodies only have a total order through std::less
+    std::less<const Body*> less;
+    if (One != other.One) return less(One, other.One);
+    if (Two != other.Two) return less(Two, other.Two);
+    return Face < other.Face;
+}
+
+bool ContactSolver::Key::operator==(const Key& other) const {
+    return One == other.One && Two == other.Two && Face == other.Face;
+}
+
+ContactSolver::ContactSolver() : Iterations(CONTACT_ITERATIONS), WarmStart(true), WarmStarted(0) { }
+
+void ContactSolver::setIterations(int iterations) {
+    Iterations = std::max(1, iterations);
+}
+
+int ContactSolver::getIterations() const {
+    return Iterations;
+}
+
+void ContactSolver::setWarmStart(bool enabled) {
+    WarmStart = enabled;
+}
+
+void ContactSolver::clear() {
+    Cache.clear();
+    WarmStarted = 0;
+}
+
+size_t ContactSolver::getWarmStarted() const {
+    return WarmStarted;
+}
+
+size_t ContactSolver::getCached() const {
+    return Cache.size();
+}
+
+float ContactSolver::cached(const Key& key) const {
+    auto it = std::lower_bound(Cache.begin(), Cache.end(), key, [](const std::pair<Key, float>& entry, const Key& k) {
+        return entry.first < k;
+    });
+    return (it != Cache.end() && it->first == key) ? it->second : -1.0f;
+}
+
+void ContactSolver::solve(const std::vector<Body*>& bodies,
+                          const std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                          const std::vector<std::pair<uint32_t, uint32_t>>& surface,
+                          const ColliderSet& colliders, ContactGraph& graph, float step) {
+    // Sleeping bodies hold still like the faces do
+    auto inverseMass = [](const Body& body) {
+        return body.Sleeping ? 0.0f : 1.0f / body.Mass;
+    };
+
+    // Separation speed asked of a contact approaching with vn. Only new
+    // contacts bounce; one that was there last step is resting, and the
+    // approach it shows is what the forces of this step added to it
+    auto target = [](float vn, float restitution, bool resting) {
+        float bounce = -restitution * vn;
+        return (resting || bounce < RESTING_SPEED) ? 0.0f : bounce;
+    };
+
+    WarmStarted = 0;
+
+    // Set up every contact and apply its impulse of the last step (-1: new
+    // contact). A resting contact that the position pass has just opened by a
+    // hair stays in, and may close the gap within the step but not overshoot it
+    Pairs.clear();
+    Links.clear();
+    for (const auto& [i, j] : pairs) {
+        Body& one = *bodies[i];
+        Body& two = *bodies[j];
+
+        glm::vec3 separation = two.Position - one.Position;
+        if (separation == glm::vec3(0)) separation = glm::vec3(0.0f, 1.0f, 0.0f);
+        float gap = glm::length(separation) - one.sphere.geometry.getRadius() - two.sphere.geometry.getRadius();
+
+        float last = cached({&one, &two, NO_FACE});
+        if (gap > CONTACT_MARGIN || (gap > 0.0f && last < 0.0f)) continue;
+
+        float wOne = inverseMass(one), wTwo = inverseMass(two);
+        Contact c;
+        c.One = i;
+        c.Two = j;
+        c.Normal = glm::normalize(separation);
+        c.Mass = (wOne + wTwo) > 0.0f ? 1.0f / (wOne + wTwo) : 0.0f;
+        c.Target = gap > 0.0f ? -gap / step : target(glm::dot(two.Velocity - one.Velocity, c.Normal), SPHERE_RESTITUTION, last >= 0.0f);
+        c.Impulse = WarmStart ? std::max(last, 0.0f) : 0.0f;
+        if (c.Impulse > 0.0f) ++WarmStarted;
+
+        one.Velocity -= (c.Impulse * wOne) * c.Normal;
+        two.Velocity += (c.Impulse * wTwo) * c.Normal;
+        Pairs.push_back(c);
+        Links.push_back({i, j});
+    }
+
+    Faces.resize(surface.size());
+    for (size_t k = 0; k < surface.size(); ++k) {
+        auto [i, face] = surface[k];
+        Body& body = *bodies[i];
+        Contact& c = Faces[k];
+
+        float offset;
+        colliders.facing(face, body.Position, c.Normal, offset);
+        c.One = i;
+        c.Two = face;
+        c.Mass = body.Mass;
+        float last = cached({&body, nullptr, face});
+        c.Target = target(glm::dot(body.Velocity, c.Normal), SURFACE_RESTITUTION, last >= 0.0f);
+        c.Impulse = WarmStart ? std::max(last, 0.0f) : 0.0f;
+        if (c.Impulse > 0.0f) ++WarmStarted;
+
+        body.Velocity += (c.Impulse / body.Mass) * c.Normal;
+    }
+
+    auto solvePair = [&](uint32_t k) {
+        Contact& c = Pairs[k];
+        Body& one = *bodies[c.One];
+        Body& two = *bodies[c.Two];
+
+        float vn = glm::dot(two.Velocity - one.Velocity, c.Normal);
+        float impulse = std::max(c.Impulse + c.Mass * (c.Target - vn), 0.0f);
+        float delta = impulse - c.Impulse;
+        c.Impulse = impulse;
+
+        one.Velocity -= (delta * inverseMass(one)) * c.Normal;
+        two.Velocity += (delta * inverseMass(two)) * c.Normal;
+    };
+
+    // Faces serially (a body may rest on several), spheres in independent batches
+    graph.build(Links, bodies.size());
+    for (int it = 0; it < Iterations; ++it) {
+        for (Contact& c : Faces) {
+            Body& body = *bodies[c.One];
+
+            float vn = glm::dot(body.Velocity, c.Normal);
+            float impulse = std::max(c.Impulse + c.Mass * (c.Target - vn), 0.0f);
+            body.Velocity += ((impulse - c.Impulse) / c.Mass) * c.Normal;
+            c.Impulse = impulse;
+        }
+
+        graph.resolve(solvePair);
+    }
+
+    // Remove the overlap beyond the slop by moving the bodies, as many sweeps
+    // as for the velocities. Faces last, so that a body pressed into the
+    // ground by its neighbours ends up on it
+    auto separatePair = [&](uint32_t k) {
+        const Contact& c = Pairs[k];
+        Body& one = *bodies[c.One];
+        Body& two = *bodies[c.Two];
+
+        float wOne = inverseMass(one), wTwo = inverseMass(two);
+        if (wOne + wTwo <= 0.0f) return;
+
+        float depth = one.sphere.geometry.getRadius() + two.sphere.geometry.getRadius() - glm::length(two.Position - one.Position);
+        if (depth <= CONTACT_SLOP) return;
+
+        glm::vec3 correction = ((depth - CONTACT_SLOP) / (wOne + wTwo)) * c.Normal;
+        one.Position -= wOne * correction;
+        two.Position += wTwo * correction;
+    };
+
+    for (int it = 0; it < Iterations; ++it) {
+        graph.resolve(separatePair);
+
+        for (const Contact& c : Faces) {
+            Body& body = *bodies[c.One];
+
+            float offset;
+            glm::vec3 normal;
+            colliders.facing(c.Two, body.Position, normal, offset);
+            float depth = offset + body.sphere.geometry.getRadius() - glm::dot(body.Position, normal);
+            if (depth > CONTACT_SLOP) body.Position += (depth - CONTACT_SLOP) * normal;
+        }
+    }
+
+    // Keep the impulses for the next step
+    std::vector<std::pair<Key, float>> next;
+    next.reserve(Pairs.size() + Faces.size());
+    for (size_t k = 0; k < Pairs.size(); ++k) {
+        next.push_back({{bodies[Pairs[k].One], bodies[Pairs[k].Two], NO_FACE}, Pairs[k].Impulse});
+    }
+    for (size_t k = 0; k < Faces.size(); ++k) {
+        next.push_back({{bodies[Faces[k].One], nullptr, Faces[k].Two}, Faces[k].Impulse});
+    }
+    std::sort(next.begin(), next.end(), [](const std::pair<Key, float>& a, const std::pair<Key, float>& b) {
+        return a.first < b.first;
+    });
+    Cache.swap(next);
+}
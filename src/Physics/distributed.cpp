@@ -0,0 +1,475 @@
+#include "Physics/distributed.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <glm/gtc/type_precision.hpp>
+
+namespace {
+
+// Send outgoing[r] to rank r and collect what every rank sent here, in rank order
+template <class T>
+void exchange(const std::vector<std::vector<T>>& outgoing, std::vector<T>& incoming, MPI_Datatype type, MPI_Comm comm) {
+    const int ranks = (int)outgoing.size();
+    std::vector<int> sendCounts(ranks), receiveCounts(ranks), sendOffsets(ranks), receiveOffsets(ranks);
+    for (int r = 0; r < ranks; ++r) sendCounts[r] = (int)outgoing[r].size();
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT, receiveCounts.data(), 1, MPI_INT, comm);
+
+    int sent = 0, received = 0;
+    for (int r = 0; r < ranks; ++r) {
+        sendOffsets[r] = sent;
+        receiveOffsets[r] = received;
+        sent += sendCounts[r];
+        received += receiveCounts[r];
+    }
+
+    std::vector<T> buffer;
+    buffer.reserve(sent);
+    for (const std::vector<T>& bucket : outgoing) buffer.insert(buffer.end(), bucket.begin(), bucket.end());
+
+    incoming.resize(received);
+    MPI_Alltoallv(buffer.data(), sendCounts.data(), sendOffsets.data(), type,
+                  incoming.data(), receiveCounts.data(), receiveOffsets.data(), type, comm);
+}
+
+// Weight of a body in the decomposition: its interactions, plus its own update
+double weight(const Particle& particle) {
+    return 1.0 + particle.Cost;
+}
+
+// Velocity and position changes of both bodies of a touching pair (index 0:
+// a, 1: b), or false if they do not touch. Worked out with the lower id
+// first, so the two ranks of a pair split across a cut get the same numbers
+bool contact(const Particle& a, const Particle& b, glm::dvec3 velocity[2], glm::dvec3 position[2]) {
+    const bool swapped = b.Id < a.Id;
+    const Particle& one = swapped ? b : a;
+    const Particle& two = swapped ? a : b;
+
+    glm::dvec3 normal = two.Position - one.Position;
+    double distance2 = glm::dot(normal, normal);
+    double reach = one.Radius + two.Radius;
+    if (distance2 >= reach * reach || distance2 == 0.0) return false;
+
+    double distance = std::sqrt(distance2);
+    normal /= distance;
+    double wOne = 1.0 / one.Mass, wTwo = 1.0 / two.Mass;
+
+    glm::dvec3 kickOne(0.0), kickTwo(0.0);
+    double vn = glm::dot(two.Velocity - one.Velocity, normal);
+    if (vn < 0.0) {
+        double impulse = -(1.0 + SPHERE_RESTITUTION) * vn / (wOne + wTwo);
+        kickOne = (-impulse * wOne) * normal;
+        kickTwo = (impulse * wTwo) * normal;
+    }
+
+    glm::dvec3 correction = ((reach - distance) / (wOne + wTwo)) * normal;
+    velocity[swapped ? 1 : 0] = kickOne;
+    velocity[swapped ? 0 : 1] = kickTwo;
+    position[swapped ? 1 : 0] = -wOne * correction;
+    position[swapped ? 0 : 1] = wTwo * correction;
+    return true;
+}
+
+// Key of a collision cell; coordinates wrap at 2^21 cells, which only adds candidates
+uint64_t cellKey(int64_t x, int64_t y, int64_t z) {
+    const uint64_t mask = (1u << 21) - 1;
+    return (((uint64_t)x & mask) << 42) | (((uint64_t)y & mask) << 21) | ((uint64_t)z & mask);
+}
+
+bool empty(const glm::dvec3& lower, const glm::dvec3& upper) {
+    return lower.x > upper.x;
+}
+
+}
+
+DistributedSystem::DistributedSystem(MPI_Comm comm) : Comm(comm), Step(1.0 / 60.0), Imbalance(DISTRIBUTED_IMBALANCE), Threads(1), Time(0.0), Imported(0), Balanced(1.0) {
+    MPI_Comm_rank(Comm, &Rank);
+    MPI_Comm_size(Comm, &Ranks);
+
+    // Both are plain data; sent as opaque blocks so the counts stay in bodies, not bytes
+    MPI_Type_contiguous((int)sizeof(Particle), MPI_BYTE, &ParticleType);
+    MPI_Type_commit(&ParticleType);
+    MPI_Type_contiguous((int)sizeof(PointMass), MPI_BYTE, &MassType);
+    MPI_Type_commit(&MassType);
+}
+
+DistributedSystem::~DistributedSystem() {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        MPI_Type_free(&ParticleType);
+        MPI_Type_free(&MassType);
+    }
+}
+
+void DistributedSystem::setStep(double step) {
+    Step = step;
+}
+
+void DistributedSystem::setTheta(double theta) {
+    Tree.setTheta(theta);
+}
+
+void DistributedSystem::setSoftening(double softening) {
+    Tree.setSoftening(softening);
+}
+
+void DistributedSystem::setImbalance(double threshold) {
+    Imbalance = std::max(1.0, threshold);
+}
+
+void DistributedSystem::setThreads(unsigned threads) {
+    Threads = std::max(1u, threads);
+}
+
+std::vector<Particle>& DistributedSystem::getParticles() {
+    return Local;
+}
+
+double DistributedSystem::getTime() const {
+    return Time;
+}
+
+const DistributedStats& DistributedSystem::getStats() const {
+    return Stats;
+}
+
+int DistributedSystem::getRank() const {
+    return Rank;
+}
+
+int DistributedSystem::getRanks() const {
+    return Ranks;
+}
+
+int DistributedSystem::owner(const glm::dvec3& position) const {
+    if (Domains.empty()) return Rank;
+    int d = 0;
+    while (Domains[d].Count > 1) {
+        d = position[Domains[d].Axis] < Domains[d].Cut ? Domains[d].Lower : Domains[d].Upper;
+    }
+    return Domains[d].First;
+}
+
+void DistributedSystem::decompose() {
+    Domains.assign(1, {0, Ranks, 0, 0.0, -1, -1});
+    std::vector<int> where(Local.size(), 0);     // Domain of each local body
+    std::vector<int> level(1, 0);
+
+    // All domains of a level are cut together, so every reduction serves all of them
+    while (!level.empty()) {
+        std::vector<int> split;
+        for (int d : level) {
+            if (Domains[d].Count > 1) split.push_back(d);
+        }
+        if (split.empty()) break;
+
+        const size_t m = split.size();
+        std::vector<int> slot(Domains.size(), -1);
+        for (size_t s = 0; s < m; ++s) slot[split[s]] = (int)s;
+
+        // Extent of each domain (minima of x and of -x) and its work
+        std::vector<double> extent(6 * m, INFINITY), work(m, 0.0);
+        for (size_t i = 0; i < Local.size(); ++i) {
+            int s = slot[where[i]];
+            if (s < 0) continue;
+            for (int a = 0; a < 3; ++a) {
+                extent[6 * s + a] = std::min(extent[6 * s + a], Local[i].Position[a]);
+                extent[6 * s + 3 + a] = std::min(extent[6 * s + 3 + a], -Local[i].Position[a]);
+            }
+            work[s] += weight(Local[i]);
+        }
+        MPI_Allreduce(MPI_IN_PLACE, extent.data(), (int)extent.size(), MPI_DOUBLE, MPI_MIN, Comm);
+        MPI_Allreduce(MPI_IN_PLACE, work.data(), (int)m, MPI_DOUBLE, MPI_SUM, Comm);
+
+        // Cut across the longest extent, where the work splits like the ranks
+        std::vector<double> low(m), high(m), target(m), below(m);
+        for (size_t s = 0; s < m; ++s) {
+            Domain& domain = Domains[split[s]];
+            domain.Axis = 0;
+            for (int a = 1; a < 3; ++a) {
+                double length = -extent[6 * s + 3 + a] - extent[6 * s + a];
+                double longest = -extent[6 * s + 3 + domain.Axis] - extent[6 * s + domain.Axis];
+                if (length > longest) domain.Axis = a;
+            }
+            low[s] = extent[6 * s + domain.Axis];
+            high[s] = -extent[6 * s + 3 + domain.Axis];
+            if (!(low[s] <= high[s])) low[s] = high[s] = 0.0;     // No bodies: any cut will do
+            target[s] = work[s] * (double)(domain.Count / 2) / (double)domain.Count;
+        }
+
+        for (int it = 0; it < ORB_ITERATIONS; ++it) {
+            std::fill(below.begin(), below.end(), 0.0);
+            for (size_t i = 0; i < Local.size(); ++i) {
+                int s = slot[where[i]];
+                if (s < 0) continue;
+                if (Local[i].Position[Domains[split[s]].Axis] < 0.5 * (low[s] + high[s])) below[s] += weight(Local[i]);
+            }
+            MPI_Allreduce(MPI_IN_PLACE, below.data(), (int)m, MPI_DOUBLE, MPI_SUM, Comm);
+            for (size_t s = 0; s < m; ++s) {
+                double mid = 0.5 * (low[s] + high[s]);
+                if (below[s] < target[s]) low[s] = mid;
+                else high[s] = mid;
+            }
+        }
+
+        level.clear();
+        for (size_t s = 0; s < m; ++s) {
+            const int d = split[s];
+            const int first = Domains[d].First, count = Domains[d].Count;
+            Domains[d].Cut = 0.5 * (low[s] + high[s]);
+            Domains[d].Lower = (int)Domains.size();
+            Domains.push_back({first, count / 2, 0, 0.0, -1, -1});
+            Domains[d].Upper = (int)Domains.size();
+            Domains.push_back({first + count / 2, count - count / 2, 0, 0.0, -1, -1});
+            level.push_back(Domains[d].Lower);
+            level.push_back(Domains[d].Upper);
+        }
+
+        for (size_t i = 0; i < Local.size(); ++i) {
+            const Domain& domain = Domains[where[i]];
+            if (domain.Count <= 1) continue;
+            where[i] = Local[i].Position[domain.Axis] < domain.Cut ? domain.Lower : domain.Upper;
+        }
+    }
+}
+
+size_t DistributedSystem::migrate() {
+    std::vector<std::vector<Particle>> outgoing(Ranks);
+    size_t kept = 0;
+    for (size_t i = 0; i < Local.size(); ++i) {
+        int r = owner(Local[i].Position);
+        if (r == Rank) Local[kept++] = Local[i];
+        else outgoing[r].push_back(Local[i]);
+    }
+    const size_t moved = Local.size() - kept;
+    Local.resize(kept);
+
+    std::vector<Particle> incoming;
+    exchange(outgoing, incoming, ParticleType, Comm);
+    Local.insert(Local.end(), incoming.begin(), incoming.end());
+    return moved;
+}
+
+void DistributedSystem::exchangeBoxes() {
+    Box mine = {glm::dvec3(INFINITY), glm::dvec3(-INFINITY), 0.0};
+    for (const Particle& particle : Local) {
+        mine.Lower = glm::min(mine.Lower, particle.Position);
+        mine.Upper = glm::max(mine.Upper, particle.Position);
+        mine.Radius = std::max(mine.Radius, particle.Radius);
+    }
+    Boxes.resize(Ranks);
+    MPI_Allgather(&mine, (int)sizeof(Box), MPI_BYTE, Boxes.data(), (int)sizeof(Box), MPI_BYTE, Comm);
+}
+
+void DistributedSystem::exchangeHalo() {
+    std::vector<std::vector<Particle>> outgoing(Ranks);
+    for (int r = 0; r < Ranks; ++r) {
+        const Box& box = Boxes[r];
+        if (r == Rank || empty(box.Lower, box.Upper) || box.Radius <= 0.0) continue;
+
+        // Bodies that can touch one of the bodies in the box
+        for (const Particle& particle : Local) {
+            if (particle.Radius <= 0.0) continue;
+            glm::dvec3 d = particle.Position - glm::clamp(particle.Position, box.Lower, box.Upper);
+            double reach = particle.Radius + box.Radius;
+            if (glm::dot(d, d) < reach * reach) outgoing[r].push_back(particle);
+        }
+    }
+    exchange(outgoing, Ghosts, ParticleType, Comm);
+}
+
+size_t DistributedSystem::collide() {
+    double largest = 0.0;
+    for (const Box& box : Boxes) largest = std::max(largest, box.Radius);
+    if (largest <= 0.0) return 0;
+
+    // Cells as wide as the largest contact distance: touching bodies are in neighbouring cells
+    const double cell = 2.0 * largest;
+    const size_t n = Local.size();
+    auto at = [&](size_t k) -> const Particle& {
+        return k < n ? Local[k] : Ghosts[k - n];
+    };
+    auto coordinates = [cell](const glm::dvec3& p) {
+        return glm::i64vec3((int64_t)std::floor(p.x / cell), (int64_t)std::floor(p.y / cell), (int64_t)std::floor(p.z / cell));
+    };
+
+    std::vector<std::pair<uint64_t, uint32_t>> cells;
+    cells.reserve(n + Ghosts.size());
+    for (size_t k = 0; k < n + Ghosts.size(); ++k) {
+        if (at(k).Radius <= 0.0) continue;
+        glm::i64vec3 c = coordinates(at(k).Position);
+        cells.push_back({cellKey(c.x, c.y, c.z), (uint32_t)k});
+    }
+    std::sort(cells.begin(), cells.end());
+
+    // Every contact from the state before the pass, summed
+    std::vector<glm::dvec3> velocity(n, glm::dvec3(0.0)), position(n, glm::dvec3(0.0));
+    size_t contacts = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (Local[i].Radius <= 0.0) continue;
+        glm::i64vec3 c = coordinates(Local[i].Position);
+
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    uint64_t key = cellKey(c.x + dx, c.y + dy, c.z + dz);
+                    auto range = std::equal_range(cells.begin(), cells.end(), std::make_pair(key, 0u),
+                        [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+                            return a.first < b.first;
+                        });
+
+                    for (auto it = range.first; it != range.second; ++it) {
+                        const size_t j = it->second;
+                        // Local pairs once; with a ghost only this side is updated here
+                        if (j <= i) continue;
+
+                        glm::dvec3 kick[2], shift[2];
+                        if (!contact(Local[i], at(j), kick, shift)) continue;
+
+                        velocity[i] += kick[0];
+                        position[i] += shift[0];
+                        if (j < n) {
+                            velocity[j] += kick[1];
+                            position[j] += shift[1];
+                        }
+                        // A split pair is counted by the rank of its lower id
+                        if (j < n || Local[i].Id < at(j).Id) ++contacts;
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        Local[i].Velocity += velocity[i];
+        Local[i].Position += position[i];
+    }
+    return contacts;
+}
+
+void DistributedSystem::computeForces() {
+    std::vector<PointMass> points(Local.size());
+    for (size_t i = 0; i < Local.size(); ++i) {
+        points[i] = {Local[i].Position, Local[i].Mass};
+    }
+
+    // Cut the locally essential tree of every other rank out of the local tree
+    Tree.build(points);
+    std::vector<std::vector<PointMass>> outgoing(Ranks);
+    for (int r = 0; r < Ranks; ++r) {
+        if (r == Rank || empty(Boxes[r].Lower, Boxes[r].Upper)) continue;
+        Tree.essential(Boxes[r].Lower, Boxes[r].Upper, outgoing[r]);
+    }
+    std::vector<PointMass> imported;
+    exchange(outgoing, imported, MassType, Comm);
+    Imported = imported.size();
+
+    // Local bodies first, so their indices stay those of Local
+    points.insert(points.end(), imported.begin(), imported.end());
+    Tree.build(points);
+
+    auto evaluate = [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Particle& particle = Local[i];
+            particle.Cost = (double)Tree.evaluate(particle.Position, i, particle.Acceleration, particle.Potential);
+        }
+    };
+
+    const size_t count = Local.size();
+    const unsigned threads = (unsigned)std::min<size_t>(Threads, std::max<size_t>(1, count / 1024));
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(evaluate, count * t / threads, count * (t + 1) / threads);
+    }
+    evaluate(0, count / threads);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+void DistributedSystem::balance(size_t migrated, size_t contacts) {
+    double work = 0.0;
+    for (const Particle& particle : Local) work += weight(particle);
+
+    std::vector<double> works(Ranks);
+    MPI_Allgather(&work, 1, MPI_DOUBLE, works.data(), 1, MPI_DOUBLE, Comm);
+    double total = 0.0, busiest = 0.0;
+    for (double w : works) {
+        total += w;
+        busiest = std::max(busiest, w);
+    }
+    Stats.Imbalance = total > 0.0 ? busiest * Ranks / total : 1.0;
+
+    uint64_t counts[5] = {Local.size(), Imported, Ghosts.size(), migrated, contacts};
+    MPI_Allreduce(MPI_IN_PLACE, counts, 5, MPI_UINT64_T, MPI_SUM, Comm);
+    Stats.Bodies = counts[0];
+    Stats.Imported = counts[1];
+    Stats.Ghosts = counts[2];
+    Stats.Migrated = counts[3];
+    Stats.Contacts = counts[4];
+}
+
+void DistributedSystem::initialize() {
+    for (Particle& particle : Local) {
+        particle.Cost = 0.0;
+    }
+    Ghosts.clear();
+    Stats = DistributedStats();
+
+    decompose();
+    size_t migrated = migrate();
+    exchangeBoxes();
+    computeForces();
+    balance(migrated, 0);
+    Balanced = Stats.Imbalance;
+}
+
+void DistributedSystem::step() {
+    // Relative to the balance of the last redraw: a few bodies on many ranks
+    // cannot be balanced, and redrawing would not help
+    const bool redraw = Stats.Imbalance > Imbalance * Balanced;
+    if (redraw) {
+        decompose();
+        ++Stats.Rebalances;
+    }
+
+    const double half = 0.5 * Step;
+    for (Particle& particle : Local) {
+        particle.Velocity += half * particle.Acceleration;
+        particle.Position += Step * particle.Velocity;
+    }
+
+    size_t migrated = migrate();
+    exchangeBoxes();
+    exchangeHalo();
+    size_t contacts = collide();
+
+    // Contacts move bodies a little; the trees need the boxes they ended up in
+    exchangeBoxes();
+    computeForces();
+
+    for (Particle& particle : Local) {
+        particle.Velocity += half * particle.Acceleration;
+    }
+    Time += Step;
+
+    balance(migrated, contacts);
+    if (redraw) Balanced = Stats.Imbalance;
+}
+
+void DistributedSystem::totals(double& kinetic, double& potential, glm::dvec3& momentum) const {
+    double sums[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+    for (const Particle& particle : Local) {
+        sums[0] += 0.5 * particle.Mass * glm::dot(particle.Velocity, particle.Velocity);
+        // Every pair appears in the potential of both bodies
+        sums[1] += 0.5 * particle.Mass * particle.Potential;
+        sums[2] += particle.Mass * particle.Velocity.x;
+        sums[3] += particle.Mass * particle.Velocity.y;
+        sums[4] += particle.Mass * particle.Velocity.z;
+    }
+    MPI_Allreduce(MPI_IN_PLACE, sums, 5, MPI_DOUBLE, MPI_SUM, Comm);
+    kinetic = sums[0];
+    potential = sums[1];
+    momentum = glm::dvec3(sums[2], sums[3], sums[4]);
+}
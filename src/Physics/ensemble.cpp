@@ -0,0 +1,323 @@
+#include "Physics/ensemble.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr size_t L = ENSEMBLE_LANES;
+constexpr int B = ENSEMBLE_BODIES;
+constexpr size_t NO_SYSTEM = SIZE_MAX;
+
+// One block of systems, structure of arrays: [body][lane]
+struct Block {
+    alignas(64) double X[B][L], Y[B][L], Z[B][L];
+    alignas(64) double VX[B][L], VY[B][L], VZ[B][L];
+    alignas(64) double AX[B][L], AY[B][L], AZ[B][L];
+    alignas(64) double M[B][L];
+    alignas(64) double Elapsed[L];          ///< Time integrated so far
+    alignas(64) double Active[L];           ///< 1 while the system is running, 0 once it stopped
+    alignas(64) double Collided[L];         ///< 1 once two bodies came within the collision distance
+    alignas(64) double H[L];                ///< Step of the lane in the current step
+    alignas(64) double Busy[L];             ///< Steps that advanced the system
+
+    size_t System[L];                       ///< System in each lane (NO_SYSTEM: empty)
+    int Escaped[L];                         ///< Body that escaped, or -1
+    double Start[L];                        ///< Start time of each system
+};
+
+// Squared distance between centres below which each pair has collided (0: never)
+using Contacts = double[B][B];
+
+// Gravity of the pair (i, j) in every lane, added to both bodies, and the
+// flag of lanes where the pair is within its collision distance
+void pair(Block& b, int i, int j, double collide2) {
+    for (size_t k = 0; k < L; ++k) {
+        double dx = b.X[j][k] - b.X[i][k];
+        double dy = b.Y[j][k] - b.Y[i][k];
+        double dz = b.Z[j][k] - b.Z[i][k];
+        double d2 = dx * dx + dy * dy + dz * dz;
+        double inv3 = GRAV_CONST / (d2 * std::sqrt(d2));
+
+        b.AX[i][k] += b.M[j][k] * inv3 * dx;
+        b.AY[i][k] += b.M[j][k] * inv3 * dy;
+        b.AZ[i][k] += b.M[j][k] * inv3 * dz;
+        b.AX[j][k] -= b.M[i][k] * inv3 * dx;
+        b.AY[j][k] -= b.M[i][k] * inv3 * dy;
+        b.AZ[j][k] -= b.M[i][k] * inv3 * dz;
+        b.Collided[k] = d2 < collide2 ? 1.0 : b.Collided[k];
+    }
+}
+
+// Accelerations of all lanes, and the flag of lanes with a pair closer than
+// its collision distance. Each loop runs over the lanes
+void accelerations(Block& b, const Contacts& collide2) {
+    for (int i = 0; i < B; ++i) {
+        for (size_t k = 0; k < L; ++k) {
+            b.AX[i][k] = b.AY[i][k] = b.AZ[i][k] = 0.0;
+        }
+    }
+
+    pair(b, 0, 1, collide2[0][1]);
+    pair(b, 0, 2, collide2[0][2]);
+    pair(b, 1, 2, collide2[1][2]);
+}
+
+// One kick-drift-kick step of every lane; stopped lanes take a zero step
+void step(Block& b, double h, double duration, const Contacts& collide2) {
+    for (size_t k = 0; k < L; ++k) {
+        double remaining = duration - b.Elapsed[k];
+        b.H[k] = b.Active[k] * (remaining < h ? remaining : h);
+    }
+
+    for (int i = 0; i < B; ++i) {
+        for (size_t k = 0; k < L; ++k) {
+            double half = 0.5 * b.H[k];
+            b.VX[i][k] += half * b.AX[i][k];
+            b.VY[i][k] += half * b.AY[i][k];
+            b.VZ[i][k] += half * b.AZ[i][k];
+            b.X[i][k] += b.H[k] * b.VX[i][k];
+            b.Y[i][k] += b.H[k] * b.VY[i][k];
+            b.Z[i][k] += b.H[k] * b.VZ[i][k];
+        }
+    }
+
+    accelerations(b, collide2);
+
+    for (int i = 0; i < B; ++i) {
+        for (size_t k = 0; k < L; ++k) {
+            double half = 0.5 * b.H[k];
+            b.VX[i][k] += half * b.AX[i][k];
+            b.VY[i][k] += half * b.AY[i][k];
+            b.VZ[i][k] += half * b.AZ[i][k];
+        }
+    }
+
+    // The last step is cut to the remaining time, so a lane is done once
+    // what is left is a rounding error of the step
+    const double tolerance = 1e-9 * h;
+    for (size_t k = 0; k < L; ++k) {
+        b.Elapsed[k] += b.H[k];
+        b.Busy[k] += b.Active[k];
+        bool stop = b.Collided[k] != 0.0 || duration - b.Elapsed[k] <= tolerance;
+        b.Active[k] = stop ? 0.0 : b.Active[k];
+    }
+}
+
+// Body that has left the other two for good, or -1
+int escaping(const Block& b, size_t k, double radius) {
+    for (int i = 0; i < B; ++i) {
+        // Centre of mass and mean velocity of the other two
+        double m = 0.0;
+        glm::dvec3 centre(0.0), drift(0.0);
+        for (int j = 0; j < B; ++j) {
+            if (j == i) continue;
+            m += b.M[j][k];
+            centre += b.M[j][k] * glm::dvec3(b.X[j][k], b.Y[j][k], b.Z[j][k]);
+            drift += b.M[j][k] * glm::dvec3(b.VX[j][k], b.VY[j][k], b.VZ[j][k]);
+        }
+        if (m <= 0.0) continue;
+        centre /= m;
+        drift /= m;
+
+        glm::dvec3 r = glm::dvec3(b.X[i][k], b.Y[i][k], b.Z[i][k]) - centre;
+        glm::dvec3 v = glm::dvec3(b.VX[i][k], b.VY[i][k], b.VZ[i][k]) - drift;
+        double distance = glm::length(r);
+        if (distance < radius || glm::dot(r, v) <= 0.0) continue;
+
+        // Unbound in the two-body problem of the body against the pair
+        double energy = 0.5 * glm::dot(v, v) - GRAV_CONST * (m + b.M[i][k]) / distance;
+        if (energy > 0.0) return i;
+    }
+    return -1;
+}
+
+// Put a system into a lane (or empty it), with its accelerations ready
+void load(Block& b, size_t k, size_t system, const SystemState* state) {
+    b.System[k] = system;
+    b.Escaped[k] = -1;
+    b.Elapsed[k] = 0.0;
+    b.Collided[k] = 0.0;
+    b.Busy[k] = 0.0;
+    b.Active[k] = state ? 1.0 : 0.0;
+    b.Start[k] = state ? state->Time : 0.0;
+
+    for (int i = 0; i < B; ++i) {
+        // Empty lanes hold massless bodies a unit apart, so they compute nothing worse than zero
+        glm::dvec3 p = state ? state->Position[i] : glm::dvec3((double)i, 0.0, 0.0);
+        glm::dvec3 v = state ? state->Velocity[i] : glm::dvec3(0.0);
+        b.X[i][k] = p.x; b.Y[i][k] = p.y; b.Z[i][k] = p.z;
+        b.VX[i][k] = v.x; b.VY[i][k] = v.y; b.VZ[i][k] = v.z;
+        b.M[i][k] = state ? state->Mass[i] : 0.0;
+    }
+}
+
+}
+
+Ensemble::Ensemble() : Step(1.0 / 60.0), Duration(60.0), CollisionDistance(0.0), EscapeRadius(0.0), LaneSteps(0), BusySteps(0) {
+    Threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void Ensemble::setStep(double step) {
+    // A step of zero would never reach the duration
+    Step = std::max(ENSEMBLE_MIN_STEP, step);
+}
+
+void Ensemble::setDuration(double duration) {
+    Duration = std::max(0.0, duration);
+}
+
+void Ensemble::setCollisionDistance(double distance) {
+    CollisionDistance = std::max(0.0, distance);
+}
+
+void Ensemble::setRadii(const std::vector<double>& radii) {
+    Radii.clear();
+    if (radii.size() != (size_t)B) return;
+    for (double radius : radii) Radii.push_back(std::max(0.0, radius));
+}
+
+void Ensemble::setEscapeRadius(double radius) {
+    EscapeRadius = std::max(0.0, radius);
+}
+
+void Ensemble::setThreads(unsigned threads) {
+    Threads = std::max(1u, threads);
+}
+
+double Ensemble::getUtilization() const {
+    return LaneSteps ? (double)BusySteps / (double)LaneSteps : 0.0;
+}
+
+void Ensemble::run(const std::vector<SystemState>& systems, const EnsembleHarvest& harvest) {
+    LaneSteps = BusySteps = 0;
+    if (systems.empty()) return;
+
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> laneSteps(0), busySteps(0);
+    std::mutex harvesting;
+
+    Contacts collide2;
+    for (int i = 0; i < B; ++i) {
+        for (int j = 0; j < B; ++j) {
+            double distance = Radii.empty() ? CollisionDistance : Radii[i] + Radii[j];
+            collide2[i][j] = distance * distance;
+        }
+    }
+
+    auto worker = [&]() {
+        // Too large for the stack of a worker thread
+        std::vector<Block> storage(1);
+        Block& b = storage[0];
+
+        auto refill = [&](size_t k) {
+            size_t system = next.fetch_add(1);
+            if (system < systems.size()) load(b, k, system, &systems[system]);
+            else load(b, k, NO_SYSTEM, nullptr);
+        };
+
+        for (size_t k = 0; k < L; ++k) refill(k);
+        accelerations(b, collide2);
+
+        size_t lanes = 0, busy = 0;
+        while (true) {
+            for (int s = 0; s < ENSEMBLE_CHECK; ++s) {
+                step(b, Step, Duration, collide2);
+            }
+            lanes += L * ENSEMBLE_CHECK;
+
+            // Escapes change slowly; look for them between the batches of steps
+            if (EscapeRadius > 0.0) {
+                for (size_t k = 0; k < L; ++k) {
+                    if (b.Active[k] == 0.0) continue;
+                    b.Escaped[k] = escaping(b, k, EscapeRadius);
+                    if (b.Escaped[k] >= 0) b.Active[k] = 0.0;
+                }
+            }
+
+            // Harvest the stopped lanes and load the next systems into them
+            bool running = false, loaded = false;
+            for (size_t k = 0; k < L; ++k) {
+                if (b.System[k] == NO_SYSTEM) continue;
+                if (b.Active[k] != 0.0) {
+                    running = true;
+                    continue;
+                }
+
+                EnsembleResult result;
+                result.System = b.System[k];
+                result.Outcome = ensembleOutcome::TIMED_OUT;
+                result.Body = -1;
+
+                if (b.Collided[k] != 0.0) {
+                    // The body left out of the pair deepest inside its collision distance
+                    result.Outcome = ensembleOutcome::COLLIDED;
+                    double nearest = INFINITY;
+                    for (int i = 0; i < B; ++i) {
+                        int one = (i + 1) % B, two = (i + 2) % B;
+                        glm::dvec3 d(b.X[one][k] - b.X[two][k], b.Y[one][k] - b.Y[two][k], b.Z[one][k] - b.Z[two][k]);
+                        double depth = collide2[one][two] > 0.0 ? glm::dot(d, d) / collide2[one][two] : INFINITY;
+                        if (depth < nearest) {
+                            nearest = depth;
+                            result.Body = i;
+                        }
+                    }
+                } else if (b.Escaped[k] >= 0) {
+                    result.Outcome = ensembleOutcome::ESCAPED;
+                    result.Body = b.Escaped[k];
+                }
+
+                result.Final.resize(B);
+                result.Final.Time = b.Start[k] + b.Elapsed[k];
+                for (int i = 0; i < B; ++i) {
+                    result.Final.Mass[i] = b.M[i][k];
+                    result.Final.Position[i] = glm::dvec3(b.X[i][k], b.Y[i][k], b.Z[i][k]);
+                    result.Final.Velocity[i] = glm::dvec3(b.VX[i][k], b.VY[i][k], b.VZ[i][k]);
+                }
+                busy += (size_t)b.Busy[k];
+
+                {
+                    std::lock_guard<std::mutex> lock(harvesting);
+                    harvest(result);
+                }
+
+                refill(k);
+                if (b.System[k] != NO_SYSTEM) running = loaded = true;
+            }
+
+            if (!running) break;
+
+            // New lanes need their first accelerations; the others recompute the same values
+            if (loaded) accelerations(b, collide2);
+        }
+
+        laneSteps += lanes;
+        busySteps += busy;
+    };
+
+    std::vector<std::thread> pool;
+    const unsigned threads = (unsigned)std::min<size_t>(Threads, (systems.size() + L - 1) / L);
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    LaneSteps = laneSteps;
+    BusySteps = busySteps;
+}
+
+std::vector<EnsembleResult> Ensemble::run(const std::vector<SystemState>& systems) {
+    std::vector<EnsembleResult> results(systems.size());
+    run(systems, [&results](const EnsembleResult& result) {
+        results[result.System] = result;
+    });
+    return results;
+}
@@ -0,0 +1,203 @@
+#include "Physics/events.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+
+EventDetector::EventDetector() : Samples(4) { }
+
+size_t EventDetector::add(const Event& event) {
+    Events.push_back(event);
+    return Events.size() - 1;
+}
+
+void EventDetector::remove(size_t id) {
+    if (id < Events.size()) Events[id] = Event();
+}
+
+void EventDetector::clear() {
+    Events.clear();
+}
+
+bool EventDetector::empty() const {
+    for (const Event& event : Events) {
+        if (event.Function) return false;
+    }
+    return true;
+}
+
+void EventDetector::setSamples(unsigned samples) {
+    Samples = std::max(1u, samples);
+}
+
+// Sign change from a to b in the requested direction. A crossing that lands
+// exactly on zero counts at the end of its step and not again at the next start.
+static bool crosses(double a, double b, eventDirection direction) {
+    bool rising = a < 0.0 && b >= 0.0;
+    bool falling = a > 0.0 && b <= 0.0;
+
+    switch (direction) {
+        case RISING:  return rising;
+        case FALLING: return falling;
+        default:      return rising || falling;
+    }
+}
+
+bool EventDetector::locate(const SystemState& start, const SystemState& end, const Interpolator& interpolate, SystemState& terminal) {
+    if (empty() || end.Time <= start.Time) return false;
+
+    // Event values on the sample grid, one row per sample point
+    const double h = (end.Time - start.Time) / Samples;
+    std::vector<std::vector<double>> values(Samples + 1, std::vector<double>(Events.size(), 0.0));
+
+    SystemState sample;
+    for (unsigned k = 0; k <= Samples; ++k) {
+        const SystemState* state = &sample;
+        if (k == 0) {
+            state = &start;
+        } else if (k == Samples) {
+            state = &end;
+        } else {
+            interpolate(start.Time + k * h, sample);
+        }
+
+        for (size_t e = 0; e < Events.size(); ++e) {
+            if (Events[e].Function) values[k][e] = Events[e].Function(*state);
+        }
+    }
+
+    struct Hit { double Time; size_t Index; };
+
+    for (unsigned k = 0; k < Samples; ++k) {
+        double tA = k == 0 ? start.Time : start.Time + k * h;
+        double tB = k + 1 == Samples ? end.Time : start.Time + (k + 1) * h;
+
+        std::vector<Hit> hits;
+        for (size_t e = 0; e < Events.size(); ++e) {
+            if (!Events[e].Function) continue;
+            if (!crosses(values[k][e], values[k + 1][e], Events[e].Direction)) continue;
+
+            hits.push_back({ findRoot(Events[e], interpolate, tA, values[k][e], tB, values[k + 1][e]), e });
+        }
+
+        std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.Time < b.Time; });
+
+        for (const Hit& hit : hits) {
+            const Event& event = Events[hit.Index];
+
+            SystemState state;
+            interpolate(hit.Time, state);
+            state.Time = hit.Time;
+            if (event.Callback) event.Callback(state);
+
+            if (event.Terminal) {
+                terminal = state;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+double EventDetector::findRoot(const Event& event, const Interpolator& interpolate, double tA, double gA, double tB, double gB) const {
+    const double tolerance = 1e-12 * std::max(1.0, std::abs(tB));
+    SystemState state;
+
+    // Illinois: regula falsi that halves the stale endpoint's value when the
+    // same side is kept twice, restoring superlinear convergence
+    int side = 0;
+    double t = tB;
+    for (int iter = 0; iter < 100 && tB - tA > tolerance; ++iter) {
+        t = (tA * gB - tB * gA) / (gB - gA);
+        t = std::clamp(t, tA, tB);
+
+        interpolate(t, state);
+        double g = event.Function(state);
+
+        if (g == 0.0) return t;
+
+        if ((g < 0.0) == (gA < 0.0)) {
+            tA = t;
+            gA = g;
+            if (side == -1) gB *= 0.5;
+            side = -1;
+        } else {
+            tB = t;
+            gB = g;
+            if (side == 1) gA *= 0.5;
+            side = 1;
+        }
+    }
+
+    // The crossing lies in [tA, tB]; report the side past the crossing
+    return tB;
+}
+
+void EventDetector::hermite(const SystemState& start, const SystemState& end, double t, SystemState& out) {
+    const double h = end.Time - start.Time;
+    const double s = h > 0.0 ? (t - start.Time) / h : 0.0;
+    const double s2 = s * s, s3 = s2 * s;
+
+    // Cubic Hermite basis and derivatives (per unit s)
+    double h00 = 2.0 * s3 - 3.0 * s2 + 1.0, h10 = s3 - 2.0 * s2 + s;
+    double h01 = -2.0 * s3 + 3.0 * s2,      h11 = s3 - s2;
+    double d00 = 6.0 * s2 - 6.0 * s,        d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    double d01 = -6.0 * s2 + 6.0 * s,       d11 = 3.0 * s2 - 2.0 * s;
+
+    out = start;
+    out.Time = t;
+    for (size_t i = 0; i < start.size(); ++i) {
+        const glm::dvec3& p0 = start.Position[i];
+        const glm::dvec3& p1 = end.Position[i];
+        const glm::dvec3& v0 = start.Velocity[i];
+        const glm::dvec3& v1 = end.Velocity[i];
+
+        out.Position[i] = h00 * p0 + h10 * h * v0 + h01 * p1 + h11 * h * v1;
+        out.Velocity[i] = h > 0.0 ? (d00 * p0 + d10 * h * v0 + d01 * p1 + d11 * h * v1) / h : v0;
+    }
+}
+
+Event EventDetector::pairDistance(size_t one, size_t two, double distance, eventDirection direction) {
+    Event event;
+    event.Direction = direction;
+    event.Function = [one, two, distance](const SystemState& state) {
+        return glm::length(state.Position[two] - state.Position[one]) - distance;
+    };
+    return event;
+}
+
+Event EventDetector::escape(size_t body) {
+    Event event;
+    event.Direction = RISING;
+    event.Function = [body](const SystemState& state) {
+        double mRest = 0.0;
+        glm::dvec3 vCentre(0.0), vCentreVel(0.0);
+        for (size_t j = 0; j < state.size(); ++j) {
+            if (j == body) continue;
+            mRest += state.Mass[j];
+            vCentre += state.Mass[j] * state.Position[j];
+            vCentreVel += state.Mass[j] * state.Velocity[j];
+        }
+        if (mRest <= 0.0) return 1.0;
+
+        glm::dvec3 r = state.Position[body] - vCentre / mRest;
+        glm::dvec3 v = state.Velocity[body] - vCentreVel / mRest;
+        return 0.5 * glm::dot(v, v) - GRAV_CONST * (mRest + state.Mass[body]) / glm::length(r);
+    };
+    return event;
+}
+
+Event EventDetector::planeCrossing(size_t body, const glm::dvec3& point, const glm::dvec3& normal, eventDirection direction) {
+    Event event;
+    event.Direction = direction;
+    event.Function = [body, point, normal](const SystemState& state) {
+        return glm::dot(state.Position[body] - point, normal);
+    };
+    return event;
+}
+
+Event EventDetector::poincareSection(size_t body, const glm::dvec3& point, const glm::dvec3& normal, const EventCallback& callback) {
+    Event event = planeCrossing(body, point, normal, RISING);
+    event.Callback = callback;
+    return event;
+}
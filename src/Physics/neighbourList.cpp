@@ -0,0 +1,61 @@
+#include "Physics/neighbourList.h"
+#include <algorithm>
+
+NeighbourList::NeighbourList() : Skin(0.0f), Builds(0) { }
+
+void NeighbourList::setSkin(float skin) {
+    Skin = std::max(0.0f, skin);
+    invalidate();
+}
+
+float NeighbourList::getSkin() const {
+    return Skin;
+}
+
+void NeighbourList::invalidate() {
+    Tracked.clear();
+    Pairs.clear();
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>>& NeighbourList::getPairs() const {
+    return Pairs;
+}
+
+size_t NeighbourList::getBuilds() const {
+    return Builds;
+}
+
+bool NeighbourList::valid(const std::vector<Body*>& bodies, const std::vector<glm::vec3>& start) const {
+    if (Skin <= 0.0f || Tracked.empty() || bodies != Tracked) return false;
+
+    const float limit = 0.25f * Skin * Skin;
+    const bool swept = start.size() == bodies.size();
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Body* body = bodies[i];
+        if (body->sphere.mesh.source) continue;
+        if (body->sphere.geometry.getRadius() != Radius[i]) return false;
+
+        glm::vec3 d = body->Position - Reference[i];
+        if (glm::dot(d, d) > limit) return false;
+
+        if (swept) {
+            d = start[i] - Reference[i];
+            if (glm::dot(d, d) > limit) return false;
+        }
+    }
+    return true;
+}
+
+void NeighbourList::store(const std::vector<Body*>& bodies, const std::vector<std::pair<uint32_t, uint32_t>>& pairs) {
+    Tracked = bodies;
+    Pairs = pairs;
+    Builds++;
+
+    Reference.resize(bodies.size());
+    Radius.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Reference[i] = bodies[i]->Position;
+        Radius[i] = bodies[i]->sphere.geometry.getRadius();
+    }
+}
@@ -0,0 +1,165 @@
+#include "Physics/octree.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+
+Octree::Octree() : Theta(OCTREE_THETA), Softening(0.0) { }
+
+void Octree::setTheta(double theta) {
+    // Beyond 1 a cube could be accepted by a point inside it
+    Theta = std::clamp(theta, 1e-6, 1.0);
+}
+
+double Octree::getTheta() const {
+    return Theta;
+}
+
+void Octree::setSoftening(double softening) {
+    Softening = std::max(0.0, softening);
+}
+
+size_t Octree::getNodes() const {
+    return Nodes.size();
+}
+
+bool Octree::far(const Node& node, double d2) const {
+    double reach = node.Size / Theta + node.Offset;
+    return d2 > reach * reach;
+}
+
+void Octree::build(const std::vector<PointMass>& points) {
+    Nodes.clear();
+    Points = points;
+    Index.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) Index[i] = i;
+    if (points.empty()) return;
+
+    // Root: the bounding cube of the points
+    glm::dvec3 lower(INFINITY), upper(-INFINITY);
+    for (const PointMass& point : points) {
+        lower = glm::min(lower, point.Position);
+        upper = glm::max(upper, point.Position);
+    }
+    glm::dvec3 extent = upper - lower;
+    double size = std::max({extent.x, extent.y, extent.z});
+    // Slightly larger, so the points on the upper faces fall inside
+    size = size > 0.0 ? size * (1.0 + 1e-9) : 1.0;
+
+    Scratch.resize(points.size());
+    ScratchIndex.resize(points.size());
+    Nodes.reserve(2 * points.size() / OCTREE_LEAF + 1);
+    subdivide(0, (uint32_t)points.size(), 0.5 * (lower + upper), size, 0);
+}
+
+uint32_t Octree::subdivide(uint32_t begin, uint32_t end, const glm::dvec3& centre, double size, int depth) {
+    const uint32_t index = (uint32_t)Nodes.size();
+    Nodes.push_back(Node());
+
+    double mass = 0.0;
+    glm::dvec3 com(0.0);
+    for (uint32_t k = begin; k < end; ++k) {
+        mass += Points[k].Mass;
+        com += Points[k].Mass * Points[k].Position;
+    }
+    com = mass > 0.0 ? com / mass : centre;
+
+    {
+        Node& node = Nodes[index];
+        node.Centre = centre;
+        node.Size = size;
+        node.Com = com;
+        node.Mass = mass;
+        node.Offset = glm::length(com - centre);
+        node.First = begin;
+        node.Count = end - begin;
+        node.Leaf = end - begin <= OCTREE_LEAF || depth >= OCTREE_DEPTH;
+    }
+
+    if (!Nodes[index].Leaf) {
+        // Counting sort of the points by octant (bit 0: x, 1: y, 2: z above the centre)
+        auto octant = [&centre](const glm::dvec3& p) {
+            return (p.x >= centre.x ? 1 : 0) | (p.y >= centre.y ? 2 : 0) | (p.z >= centre.z ? 4 : 0);
+        };
+        uint32_t counts[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (uint32_t k = begin; k < end; ++k) ++counts[octant(Points[k].Position)];
+
+        uint32_t starts[9];
+        starts[0] = begin;
+        for (int o = 0; o < 8; ++o) starts[o + 1] = starts[o] + counts[o];
+
+        uint32_t fill[8];
+        std::copy(starts, starts + 8, fill);
+        for (uint32_t k = begin; k < end; ++k) {
+            uint32_t to = fill[octant(Points[k].Position)]++;
+            Scratch[to] = Points[k];
+            ScratchIndex[to] = Index[k];
+        }
+        std::copy(Scratch.begin() + begin, Scratch.begin() + end, Points.begin() + begin);
+        std::copy(ScratchIndex.begin() + begin, ScratchIndex.begin() + end, Index.begin() + begin);
+
+        const double quarter = 0.25 * size;
+        for (int o = 0; o < 8; ++o) {
+            if (counts[o] == 0) continue;
+            glm::dvec3 offset((o & 1) ? quarter : -quarter, (o & 2) ? quarter : -quarter, (o & 4) ? quarter : -quarter);
+            subdivide(starts[o], starts[o + 1], centre + offset, 0.5 * size, depth + 1);
+        }
+    }
+
+    Nodes[index].Next = (uint32_t)Nodes.size();
+    return index;
+}
+
+size_t Octree::evaluate(const glm::dvec3& position, size_t self, glm::dvec3& acceleration, double& potential) const {
+    const double soft2 = Softening * Softening;
+    size_t interactions = 0;
+    acceleration = glm::dvec3(0.0);
+    potential = 0.0;
+
+    auto attract = [&](const glm::dvec3& at, double mass) {
+        glm::dvec3 r = at - position;
+        double r2 = glm::dot(r, r) + soft2;
+        if (r2 <= 0.0) return;
+        double inverse = 1.0 / std::sqrt(r2);
+        acceleration += (GRAV_CONST * mass * inverse * inverse * inverse) * r;
+        potential -= GRAV_CONST * mass * inverse;
+        ++interactions;
+    };
+
+    const uint32_t count = (uint32_t)Nodes.size();
+    uint32_t i = 0;
+    while (i < count) {
+        const Node& node = Nodes[i];
+        glm::dvec3 d = node.Com - position;
+        if (far(node, glm::dot(d, d))) {
+            attract(node.Com, node.Mass);
+            i = node.Next;
+        } else if (node.Leaf) {
+            for (uint32_t k = node.First; k < node.First + node.Count; ++k) {
+                if (Index[k] != self) attract(Points[k].Position, Points[k].Mass);
+            }
+            i = node.Next;
+        } else {
+            ++i;
+        }
+    }
+    return interactions;
+}
+
+void Octree::essential(const glm::dvec3& lower, const glm::dvec3& upper, std::vector<PointMass>& out) const {
+    const uint32_t count = (uint32_t)Nodes.size();
+    uint32_t i = 0;
+    while (i < count) {
+        const Node& node = Nodes[i];
+        // Nearest point of the box to the centre of mass: no point of the box is closer
+        glm::dvec3 d = node.Com - glm::clamp(node.Com, lower, upper);
+        if (far(node, glm::dot(d, d))) {
+            out.push_back({node.Com, node.Mass});
+            i = node.Next;
+        } else if (node.Leaf) {
+            out.insert(out.end(), Points.begin() + node.First, Points.begin() + node.First + node.Count);
+            i = node.Next;
+        } else {
+            ++i;
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#include "Physics/pairKernel.h"
+#include "Physics/physics.h"
+#include <cmath>
+#include <climits>
+
+// Largest float below 1 + EPSILON: the clamp d² < 1 + EPSILON of gravityBetween() as !(d² > limit)
+static float clampLimit() {
+    float limit = (float)(1.0 + EPSILON);
+    while ((double)limit >= 1.0 + EPSILON) limit = std::nextafter(limit, 0.0f);
+    return limit;
+}
+
+// Force on a body from one at separation (dx, dy, dz), as gravityBetween()
+static inline void pairForce(float dx, float dy, float dz, float mOne, float mTwo, float limit, float& fx, float& fy, float& fz) {
+    float d2 = dx * dx + dy * dy + dz * dz;
+    float inv = 1.0f / std::sqrt(d2);
+    float f = GRAV_CONST * ((mOne * mTwo) / d2);
+    bool keep = d2 > limit;
+
+    fx = keep ? f * (dx * inv) : 0.0f;
+    fy = keep ? f * (dy * inv) : 0.0f;
+    fz = keep ? f * (dz * inv) : 0.0f;
+}
+
+// Pairs (i, j) for j in [begin, n): forces into the row buffers, reactions
+// on body j and contact flags. Branch-free and free of aliasing, so the
+// compiler vectorizes it
+static void row(size_t begin, size_t n,
+                const float* __restrict x, const float* __restrict y, const float* __restrict z,
+                const float* __restrict m, const float* __restrict r, const int* __restrict g, const float* __restrict awake,
+                float* __restrict rowX, float* __restrict rowY, float* __restrict rowZ,
+                float* __restrict forceX, float* __restrict forceY, float* __restrict forceZ, float* __restrict close,
+                float xi, float yi, float zi, float mi, float ri, int gi, float active, float limit) {
+    for (size_t j = begin; j < n; ++j) {
+        float dx = x[j] - xi, dy = y[j] - yi, dz = z[j] - zi;
+        float d2 = dx * dx + dy * dy + dz * dz;
+        float inv = 1.0f / std::sqrt(d2);
+        float f = GRAV_CONST * ((mi * m[j]) / d2);
+        float fx = f * (dx * inv), fy = f * (dy * inv), fz = f * (dz * inv);
+
+        // Clamped or coincident, or both in one KS pair / chain
+        float keep = d2 > limit ? active : 0.0f;
+        keep = g[j] == gi ? keep * (1.0f - awake[j]) : keep;
+        fx = keep != 0.0f ? fx : 0.0f;
+        fy = keep != 0.0f ? fy : 0.0f;
+        fz = keep != 0.0f ? fz : 0.0f;
+        rowX[j] = fx;
+        rowY[j] = fy;
+        rowZ[j] = fz;
+
+        // Reaction on awake bodies only (awake is 0 or 1)
+        forceX[j] -= awake[j] * fx;
+        forceY[j] -= awake[j] * fy;
+        forceZ[j] -= awake[j] * fz;
+
+        float contact = ri + r[j];
+        close[j] = d2 <= contact * contact ? 1.0f : 0.0f;
+    }
+}
+
+PairKernel::PairKernel() { }
+
+void PairKernel::run(std::vector<Body*>& bodies, const std::vector<int>& group, float skin, std::vector<std::pair<uint32_t, uint32_t>>* candidates) {
+    X.clear(); Y.clear(); Z.clear(); Mass.clear(); Radius.clear();
+    ForceX.clear(); ForceY.clear(); ForceZ.clear();
+    Group.clear(); Awake.clear(); Index.clear();
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Body* body = bodies[i];
+        if (body->sphere.mesh.source) continue;
+
+        X.push_back(body->Position.x);
+        Y.push_back(body->Position.y);
+        Z.push_back(body->Position.z);
+        Mass.push_back(body->Mass);
+        Radius.push_back(body->sphere.geometry.getRadius());
+        ForceX.push_back(body->vForceAccumulator.x);
+        ForceY.push_back(body->vForceAccumulator.y);
+        ForceZ.push_back(body->vForceAccumulator.z);
+        Group.push_back(i < group.size() ? group[i] : -1);
+        Awake.push_back(body->Sleeping ? 0.0f : 1.0f);
+        Index.push_back((uint32_t)i);
+    }
+
+    const size_t n = Index.size();
+    RowX.resize(n); RowY.resize(n); RowZ.resize(n);
+    Close.resize(n);
+    if (candidates) candidates->clear();
+
+    const float limit = clampLimit();
+    const float reach = std::sqrt((float)EPSILON) + skin;
+    std::vector<uint32_t> sleepers;
+
+    const float* x = X.data();
+    const float* y = Y.data();
+    const float* z = Z.data();
+    const float* m = Mass.data();
+    const float* r = Radius.data();
+    const int* g = Group.data();
+    const float* awake = Awake.data();
+    float* rowX = RowX.data();
+    float* rowY = RowY.data();
+    float* rowZ = RowZ.data();
+    float* forceX = ForceX.data();
+    float* forceY = ForceY.data();
+    float* forceZ = ForceZ.data();
+    float* close = Close.data();
+
+    for (size_t i = 0; i < n; ++i) {
+        const float xi = x[i], yi = y[i], zi = z[i], mi = m[i], ri = r[i] + reach;
+        // Ungrouped bodies (-1) must not match each other
+        const int gi = g[i] >= 0 ? g[i] : INT_MIN;
+        const float active = awake[i];
+
+        if (active != 0.0f) {
+            // Sleeping bodies before this one only pull
+            for (uint32_t k : sleepers) {
+                float fx, fy, fz;
+                pairForce(x[k] - xi, y[k] - yi, z[k] - zi, mi, m[k], limit, fx, fy, fz);
+                forceX[i] += fx;
+                forceY[i] += fy;
+                forceZ[i] += fz;
+            }
+        } else {
+            sleepers.push_back((uint32_t)i);
+        }
+
+        // The row: one separation per pair for both the force and the contact test
+        row(i + 1, n, x, y, z, m, r, g, awake, rowX, rowY, rowZ, forceX, forceY, forceZ, close, xi, yi, zi, mi, ri, gi, active, limit);
+
+        if (active != 0.0f) {
+            // Summed in pair order, as the accumulator did
+            for (size_t j = i + 1; j < n; ++j) {
+                forceX[i] += rowX[j];
+                forceY[i] += rowY[j];
+                forceZ[i] += rowZ[j];
+            }
+        }
+
+        if (!candidates) continue;
+
+        // Two sleepers never collide; a sleeper and an awake body may
+        for (size_t j = i + 1; j < n; ++j) {
+            if (close[j] != 0.0f && (active != 0.0f || awake[j] != 0.0f)) candidates->emplace_back(Index[i], Index[j]);
+        }
+    }
+
+    // Sleepers are pulled by nobody; their accumulators are left as they were
+    for (size_t i = 0; i < n; ++i) {
+        if (awake[i] != 0.0f) bodies[Index[i]]->vForceAccumulator = glm::vec3(forceX[i], forceY[i], forceZ[i]);
+    }
+}
@@ -0,0 +1,127 @@
+#include "Physics/parareal.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+Parareal::Parareal(Propagator coarse, Propagator fine)
+    : Coarse(coarse), Fine(fine), Tolerance(1e-10), MaxIterations(0), Correction(0.0) {
+    Threads = std::max(1u, std::thread::hardware_concurrency());
+}
+
+void Parareal::setTolerance(double tolerance) {
+    Tolerance = tolerance;
+}
+
+void Parareal::setThreads(unsigned threads) {
+    Threads = std::max(1u, threads);
+}
+
+void Parareal::setMaxIterations(unsigned iterations) {
+    MaxIterations = iterations;
+}
+
+double Parareal::getCorrection() const {
+    return Correction;
+}
+
+unsigned Parareal::integrate(SystemState& state, double interval, unsigned slices) {
+    if (slices == 0 || interval <= 0.0) return 0;
+
+    const double slice = interval / slices;
+    const unsigned maxIterations = MaxIterations > 0 ? std::min(MaxIterations, slices) : slices;
+
+    // U[n] is the current guess at the start of slice n, G[n] the coarse
+    // prediction made from it in the previous iteration
+    std::vector<SystemState> U(slices + 1, state);
+    std::vector<SystemState> G(slices, state);
+    std::vector<SystemState> F(slices, state);
+
+    // Initial serial coarse sweep
+    for (unsigned n = 0; n < slices; ++n) {
+        G[n] = U[n];
+        Coarse(G[n], slice);
+        U[n + 1] = G[n];
+    }
+
+    unsigned iteration = 0;
+    Correction = 0.0;
+
+    while (iteration < maxIterations) {
+        // Slices before `iteration` are already exact and need no fine solve
+        fineSweep(U, F, iteration, slice);
+
+        Correction = 0.0;
+        for (unsigned n = iteration; n < slices; ++n) {
+            SystemState predicted = U[n];
+            Coarse(predicted, slice);
+
+            SystemState corrected = predicted;
+            for (size_t b = 0; b < corrected.size(); ++b) {
+                corrected.Position[b] += F[n].Position[b] - G[n].Position[b];
+                corrected.Velocity[b] += F[n].Velocity[b] - G[n].Velocity[b];
+            }
+            corrected.Time = F[n].Time;
+
+            Correction = std::max(Correction, difference(corrected, U[n + 1]));
+
+            G[n] = predicted;
+            U[n + 1] = corrected;
+        }
+
+        iteration++;
+        if (Correction <= Tolerance) break;
+    }
+
+    state = U[slices];
+    return iteration;
+}
+
+void Parareal::fineSweep(const std::vector<SystemState>& start, std::vector<SystemState>& out, unsigned first, double slice) {
+    const unsigned slices = (unsigned)out.size();
+    std::atomic<unsigned> next(first);
+    std::exception_ptr error;
+    std::mutex failing;
+
+    auto worker = [&]() {
+        for (unsigned n = next++; n < slices; n = next++) {
+            out[n] = start[n];
+            try {
+                Fine(out[n], slice);
+            } catch (...) {
+                // Handed to the caller once every worker is done; the rest is skipped
+                std::lock_guard<std::mutex> lock(failing);
+                if (!error) error = std::current_exception();
+                next = slices;
+            }
+        }
+    };
+
+    unsigned workers = std::min(Threads, slices - first);
+    std::vector<std::thread> pool;
+    for (unsigned w = 1; w < workers; ++w) {
+        pool.emplace_back(worker);
+    }
+    worker();
+
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+double Parareal::difference(const SystemState& a, const SystemState& b) {
+    double diff = 0.0;
+
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (int c = 0; c < 3; ++c) {
+            double dp = std::abs(a.Position[i][c] - b.Position[i][c]) / (1.0 + std::abs(a.Position[i][c]));
+            double dv = std::abs(a.Velocity[i][c] - b.Velocity[i][c]) / (1.0 + std::abs(a.Velocity[i][c]));
+            diff = std::max({diff, dp, dv});
+        }
+    }
+
+    return diff;
+}
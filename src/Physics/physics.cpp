@@ -1,51 +1,306 @@
 #include "Physics/physics.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
 
-Physics::Physics() : Speed(3.0f), endSim(false) {
-    dt = 1.0 / 60.0;
+Physics::Physics() : Physics(1.0f / 60.0f, 3.0f) {
 }
 
-Physics::Physics(float speed) : Speed(speed), endSim(false) {
-    dt = 1.0 / 60.0;
+Physics::Physics(float speed) : Physics(1.0f / 60.0f, speed) {
 }
 
-Physics::Physics(float timeStep, float speed) : Speed(speed), endSim(false) {
+Physics::Physics(float timeStep, float speed) : Speed(speed), endSim(false), Failed(false), Integrator(integratorType::EULER), Tolerance(1e-12), KSThreshold(0.0f), ChainRadius(0.0f), Adaptive(false), SecularMode(false), inSecular(false), ContactSubsteps(1), Chaos(false), simTime(0.0), BroadPhase(broadPhaseType::SPATIAL_HASH), Continuous(false), sweepInterval(0.0f), EventDriven(false), Policy(collisionPolicy::BOUNCE), MergeDensity(0.0f), Solver(contactSolverType::ELASTIC), Sleep(false) {
     dt = timeStep;
 }
 
-void Physics::processFrame(std::vector<Body*> bodies) {
+void Physics::setIntegrator(integratorType type) {
+    Integrator = type;
+    // Sleeping is an EULER feature; the mirror integrates every body
+    sleepIslands.wakeAll();
+    // Force a full resync so the new scheme starts from the current body state
+    stateBodies.clear();
+}
 
-    for (int i = 0; i < bodies.size(); ++i) {
+void Physics::setTolerance(double tolerance) {
+    Tolerance = tolerance;
+    bsIntegrator.setTolerance(tolerance);
+    taylorIntegrator.setTolerance(tolerance);
+}
 
-        Body* body = bodies[i];
-        body->Force = glm::vec3(0);
+integratorType Physics::getIntegrator() const {
+    return Integrator;
+}
 
-        if (body->sphere.mesh.source) continue;
+double Physics::getTolerance() const {
+    return Tolerance;
+}
 
-        // Calculate gravitational forces between this body and all later bodies
-        for(int j = i + 1; j < bodies.size(); ++j) {
-            Body* sBody = bodies[j];
-            // Skip if the other body is a light source
-            if (sBody->sphere.mesh.source) continue;
+void Physics::setRegularization(float distance) {
+    KSThreshold = distance;
+    ksPairs.clear();
+}
 
-            calculateGravForce(*body, *sBody);
-        }
+void Physics::setChainRegularization(float radius) {
+    ChainRadius = radius;
+    chains.clear();
+}
 
-        calculateForce(*body);
-        updateState(*body);
+void Physics::setSecularMode(bool enabled) {
+    SecularMode = enabled;
+    inSecular = false;
+}
 
-        if (onSurface(*body))
-            processSurfaceCollision(*body);
+bool Physics::isSecular() const {
+    return inSecular;
+}
 
-        for (int j = i + 1; j < bodies.size(); ++j) {
-            Body* colBody = bodies[j];
-            if (colBody->sphere.mesh.source == true) continue;
+void Physics::setContactSubsteps(int substeps) {
+    ContactSubsteps = std::max(1, substeps);
+    multirateBodies.clear();
+}
 
-            if (areColliding(*colBody, *body) && !((isZero(body->Velocity) && isZero(colBody->Velocity)))) {
-                // endSim = true;
-                
-                processCollision(*colBody, *body);
-            }
+void Physics::setBroadPhase(broadPhaseType type) {
+    BroadPhase = type;
+}
+
+void Physics::setContinuousCollisions(bool enabled) {
+    Continuous = enabled;
+    sweepStart.clear();
+}
+
+void Physics::setEventDriven(bool enabled) {
+    EventDriven = enabled;
+    sweepStart.clear();
+}
+
+void Physics::setSleeping(bool enabled) {
+    Sleep = enabled;
+    if (!enabled) sleepIslands.wakeAll();
+}
+
+size_t Physics::getSleeping() const {
+    return sleepIslands.getSleeping();
+}
+
+void Physics::setNeighbourSkin(float skin) {
+    neighbourList.setSkin(skin);
+}
+
+size_t Physics::getNeighbourBuilds() const {
+    return neighbourList.getBuilds();
+}
+
+void Physics::setCollisionPolicy(collisionPolicy policy, float density) {
+    Policy = policy;
+    MergeDensity = std::max(0.0f, density);
+}
+
+void Physics::setRemovalCallback(const std::function<void(Body&)>& callback) {
+    onRemove = callback;
+}
+
+void Physics::setContactSolver(contactSolverType solver, int iterations, bool warmStart) {
+    Solver = solver;
+    contactSolver.setIterations(iterations);
+    contactSolver.setWarmStart(warmStart);
+    contactSolver.clear();
+}
+
+size_t Physics::getWarmStartedContacts() const {
+    return contactSolver.getWarmStarted();
+}
+
+void Physics::addSurface(const Surface& surface, int side) {
+    colliders.addSurface(surface.geometry, side);
+}
+
+void Physics::addPlane(const glm::vec3& point, const glm::vec3& normal) {
+    colliders.addPlane(point, normal);
+}
+
+void Physics::addBox(const glm::vec3& lower, const glm::vec3& upper) {
+    colliders.addBox(lower, upper);
+}
+
+void Physics::clearColliders() {
+    colliders.clear();
+}
+
+void Physics::setThreads(unsigned threads) {
+    spatialHash.setThreads(threads);
+    contactGraph.setThreads(threads);
+}
+
+void Physics::setChaosIndicators(bool enabled) {
+    Chaos = enabled;
+    // Sized (with a fresh random tangent) on the next frame
+    chaosIndicator.reset(0);
+}
+
+double Physics::getMegno() const {
+    return chaosIndicator.getMegno();
+}
+
+double Physics::getLyapunov() const {
+    return chaosIndicator.getLyapunov();
+}
+
+Propagator Physics::makePropagator(integratorType type, double tolerance, double timeStep) {
+    switch (type) {
+        case integratorType::BULIRSCH_STOER:
+            return [tolerance](SystemState& state, double interval) {
+                BulirschStoer integrator(tolerance);
+                std::vector<double> y;
+                state.pack(y);
+                bool done = integrator.integrate([&state](const std::vector<double>& yIn, std::vector<double>& dydt) {
+                    computeDerivative(state.Mass, yIn, dydt);
+                }, y, interval);
+                if (!done) throw std::runtime_error("Bulirsch-Stoer step collapsed after t = " + std::to_string(state.Time));
+                state.unpack(y);
+                state.Time += interval;
+            };
+        case integratorType::TAYLOR:
+            return [tolerance](SystemState& state, double interval) {
+                TaylorIntegrator integrator(tolerance);
+                if (!integrator.integrate(state, interval)) throw std::runtime_error("Taylor series not finite after t = " + std::to_string(state.Time));
+            };
+        default:
+            // Same semi-implicit Euler as updateState(), in double precision
+            return [timeStep](SystemState& state, double interval) {
+                std::vector<glm::dvec3> acc;
+                double remaining = interval;
+                while (remaining > 0.0) {
+                    double h = std::min((double)timeStep, remaining);
+                    computeAccelerations(state, acc);
+                    for (size_t i = 0; i < state.size(); ++i) {
+                        state.Velocity[i] += acc[i] * h;
+                        state.Position[i] += state.Velocity[i] * h;
+                    }
+                    remaining -= h;
+                }
+                state.Time += interval;
+            };
+    }
+}
+
+bool Physics::interpolateState(double time, SystemState& out) const {
+    if (Integrator != integratorType::TAYLOR) return false;
+
+    return taylorIntegrator.evaluate(time, out);
+}
+
+void Physics::processFrame(std::vector<Body*>& bodies) {
+    if (events.empty()) {
+        stepFrame(bodies);
+        if (!Failed) simTime += dt;
+        return;
+    }
+
+    SystemState start, end;
+    collectState(bodies, start);
+    start.Time = simTime;
+
+    stepFrame(bodies);
+    if (Failed) return;
+    simTime += dt;
+
+    collectState(bodies, end);
+    end.Time = simTime;
+
+    // A merger changed the bodies during the frame; there is no common state to interpolate
+    if (end.size() != start.size()) return;
+
+    // Dense output: the last Taylor series where it covers t (the mirror keeps
+    // its own clock), a cubic Hermite interpolant of the frame otherwise
+    double mirrorOffset = State.Time - simTime;
+    auto interpolate = [&](double t, SystemState& out) {
+        if (Integrator == integratorType::TAYLOR && !inSecular && taylorIntegrator.evaluate(t + mirrorOffset, out) && out.size() == end.size()) {
+            out.Time = t;
+            return;
+        }
+        EventDetector::hermite(start, end, t, out);
+    };
+
+    SystemState terminal;
+    if (events.locate(start, end, interpolate, terminal)) {
+        // Stop exactly at the event
+        size_t k = 0;
+        for (Body* body : bodies) {
+            if (body->sphere.mesh.source) continue;
+            body->Position = glm::vec3(terminal.Position[k]);
+            body->Velocity = glm::vec3(terminal.Velocity[k]);
+            ++k;
         }
+        simTime = terminal.Time;
+        endSim = true;
+    }
+}
+
+void Physics::stepFrame(std::vector<Body*>& bodies) {
+
+    if (SecularMode && processSecular(bodies)) {
+        processContacts(bodies, dt);
+        return;
+    }
+
+    if (Integrator != integratorType::EULER) {
+        beginSweep(bodies, dt);
+        integrateSystem(bodies);
+        if (Failed) return;
+        processContacts(bodies, dt);
+        return;
+    }
+
+    if (Chaos) {
+        // The tangent only needs the state at the start of the frame
+        SystemState start;
+        collectState(bodies, start);
+        chaosIndicator.eulerStep(start, dt);
+    }
+
+    auto pull = [this](Body& one, Body& two) {
+        return gravityBetween(one, two);
+    };
+
+    if (Sleep) {
+        sleepIslands.wakeChanged(bodies, pull);
+        // A settled scene has nothing to move or test
+        if (sleepIslands.allAsleep()) return;
+    }
+
+    if (ContactSubsteps > 1 || EventDriven) {
+        processMultirate(bodies);
+        if (Sleep) sleepIslands.update(bodies, touchingPairs, dt, [this](Body& body) { return onSurface(body); }, pull);
+        return;
+    }
+
+    updateRegularization(bodies);
+    beginSweep(bodies, dt);
+
+    // Gravity of every pair and the contact candidates in one pass over the
+    // start positions. The candidates hold while no body moves more than half
+    // the skin, which is sized from the fastest body
+    float vMax = 0.0f;
+    for (Body* body : bodies) {
+        if (!body->sphere.mesh.source && !body->Sleeping) vMax = std::max(vMax, glm::length(body->Velocity));
+    }
+    float skin = std::max(2.0f * FUSED_REACH * vMax * dt, FUSED_MIN_SKIN);
+
+    pairKernel.run(bodies, regularizationGroups(bodies), skin, &fusedPairs);
+    fusedList.setSkin(skin);
+    fusedList.store(bodies, fusedPairs);
+
+    for (int i = 0; i < bodies.size(); ++i) {
+
+        Body* body = bodies[i];
+        if (body->Sleeping) continue;
+        body->Force = glm::vec3(0);
+
+        if (body->sphere.mesh.source) continue;
+
+        calculateForce(*body);
+        updateState(*body);
+        finishRegularization(*body);
         
         // Natural exponential velocity decay: v(t) = v₀ * e^(-λt)
         // λ (lambda) controls decay rate: higher = faster decay
@@ -55,6 +310,79 @@ void Physics::processFrame(std::vector<Body*> bodies) {
             body->Velocity *= vDecayFactor;
         }
     }
+
+    // Contacts once every body has moved
+    processContacts(bodies, dt);
+
+    if (Sleep) sleepIslands.update(bodies, touchingPairs, dt, [this](Body& body) { return onSurface(body); }, pull);
+}
+
+void Physics::advance(std::vector<Body*>& bodies, double interval) {
+    // The caller's frame step, which the steps below only borrow
+    const float frame = dt;
+
+    if (!Adaptive) {
+        // Whole steps of dt (an interval within EPSILON of one counts as whole),
+        // then one short step for the rest
+        long steps = (long)std::floor(interval / dt + EPSILON);
+        for (long k = 0; k < steps && !endSim; ++k) {
+            processFrame(bodies);
+        }
+        double rest = interval - (double)steps * frame;
+        if (rest > EPSILON * frame && !endSim) {
+            dt = (float)rest;
+            processFrame(bodies);
+            dt = frame;
+        }
+        return;
+    }
+
+    auto regularized = [this](Body& one, Body& two) {
+        return isRegularized(one, two);
+    };
+
+    double remaining = interval;
+    double step = dt;
+
+    while (remaining > 0.0 && !endSim) {
+        // Orbit-averaged evolution has no short time scale to resolve
+        step = inSecular ? remaining : stepController.suggest(bodies, regularized);
+
+        // The last step is shortened to land exactly on the frame time
+        bool last = step >= remaining;
+        dt = last ? remaining : step;
+        processFrame(bodies);
+
+        remaining = last ? 0.0 : remaining - step;
+    }
+
+    dt = frame;
+}
+
+void Physics::setAdaptiveStep(bool enabled, float minStep, float maxStep) {
+    Adaptive = enabled;
+    stepController.setBounds(minStep, maxStep);
+    stepController.reset();
+}
+
+void Physics::setStepAccuracy(float eta) {
+    stepController.setAccuracy(eta);
+}
+
+bool Physics::isAdaptive() const {
+    return Adaptive;
+}
+
+size_t Physics::addEvent(const Event& event) {
+    return events.add(event);
+}
+
+void Physics::removeEvent(size_t id) {
+    events.remove(id);
+}
+
+double Physics::getTime() const {
+    return simTime;
 }
 
 void Physics::wait(float sec) {
@@ -64,6 +392,15 @@ bool Physics::shouldClose() {
     return endSim;
 }
 
+bool Physics::hasFailed() const {
+    return Failed;
+}
+
+void Physics::fail() {
+    Failed = true;
+    endSim = true;
+}
+
 void Physics::push(Body& sphere, glm::vec3 impulse) {
     sphere.Velocity += impulse;
 }
@@ -87,29 +424,742 @@ void Physics::updateState(Body& body) {
     body.Position += body.Velocity * dt;
 }
 
+void Physics::integrateSystem(std::vector<Body*>& bodies) {
+    if (syncState(bodies)) {
+        // Something outside the integrator changed the state (collision, push),
+        // so the step size history no longer describes a smooth trajectory
+        bsIntegrator.reset();
+    }
+
+    switch (Integrator) {
+        case integratorType::BULIRSCH_STOER: {
+            if (Chaos) {
+                // Tangent rides along in the same extrapolation
+                if (!chaosIndicator.propagate(State, dt, bsIntegrator)) {
+                    fail();
+                    return;
+                }
+                break;
+            }
+
+            std::vector<double> y;
+            State.pack(y);
+
+            auto derivative = [this](const std::vector<double>& yIn, std::vector<double>& dydt) {
+                computeDerivative(State.Mass, yIn, dydt);
+            };
+            // A collapsed step (singular forces): the frame is lost, stop the
+            // simulation at its start
+            if (!bsIntegrator.integrate(derivative, y, dt)) {
+                fail();
+                return;
+            }
+
+            State.unpack(y);
+            State.Time += dt;
+            break;
+        }
+        case integratorType::TAYLOR:
+            if (Chaos) {
+                // Tangent rides along in the same series
+                if (!chaosIndicator.propagate(State, dt, taylorIntegrator)) {
+                    fail();
+                    return;
+                }
+                break;
+            }
+            // Coincident bodies or an overflow: no series, stop at the start of the frame
+            if (!taylorIntegrator.integrate(State, dt)) {
+                fail();
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+
+    writeState();
+}
+
+void Physics::collectState(std::vector<Body*>& bodies, SystemState& out) {
+    out = SystemState();
+    for (Body* body : bodies) {
+        if (body->sphere.mesh.source) continue;
+        out.Mass.push_back(body->Mass);
+        out.Position.push_back(glm::dvec3(body->Position));
+        out.Velocity.push_back(glm::dvec3(body->Velocity));
+    }
+}
+
+bool Physics::syncState(std::vector<Body*>& bodies) {
+    std::vector<Body*> active;
+    for (Body* body : bodies) {
+        if (!body->sphere.mesh.source && !body->Sleeping) active.push_back(body);
+    }
+
+    bool modified = false;
+
+    // Rebuild the mirror from scratch whenever the set of bodies changes
+    if (active != stateBodies) {
+        stateBodies = active;
+        State.resize(active.size());
+        syncedPosition.assign(active.size(), glm::vec3(NAN));
+        syncedVelocity.assign(active.size(), glm::vec3(NAN));
+        modified = true;
+    }
+
+    for (size_t i = 0; i < stateBodies.size(); ++i) {
+        Body* body = stateBodies[i];
+        State.Mass[i] = body->Mass;
+
+        if (body->Position != syncedPosition[i]) {
+            State.Position[i] = glm::dvec3(body->Position);
+            modified = true;
+        }
+        if (body->Velocity != syncedVelocity[i]) {
+            State.Velocity[i] = glm::dvec3(body->Velocity);
+            modified = true;
+        }
+    }
+
+    return modified;
+}
+
+void Physics::writeState() {
+    std::vector<glm::dvec3> acc;
+    computeAccelerations(State, acc);
+
+    for (size_t i = 0; i < stateBodies.size(); ++i) {
+        Body* body = stateBodies[i];
+        body->Position = glm::vec3(State.Position[i]);
+        body->Velocity = glm::vec3(State.Velocity[i]);
+        body->Acceleration = glm::vec3(acc[i]);
+        body->Force = body->Mass * body->Acceleration;
+
+        syncedPosition[i] = body->Position;
+        syncedVelocity[i] = body->Velocity;
+    }
+}
+
+bool Physics::processSecular(std::vector<Body*>& bodies) {
+    if (inSecular && syncState(bodies)) {
+        // A collision or push changed the orbits; re-detect from the new state
+        inSecular = false;
+        bsIntegrator.reset();
+    }
+
+    if (!inSecular) {
+        SystemState current;
+        collectState(bodies, current);
+
+        if (!SecularTriple::detect(current, secularTriple)) return false;
+        // Close inner pericentre passages belong to KS regularization
+        if (secularTriple.getInnerPericenter() < KSThreshold) return false;
+
+        syncState(bodies);
+        ksPairs.clear();
+        chains.clear();
+        inSecular = true;
+    }
+
+    secularTriple.evolve(dt);
+    secularTriple.write(State);
+    State.Time += dt;
+    writeState();
+
+    // Hand back to direct integration once the averaging no longer applies; the
+    // orbital phases were kept up to date so the bodies continue consistently
+    if (!secularTriple.isValid() || secularTriple.getInnerPericenter() < KSThreshold) {
+        inSecular = false;
+        bsIntegrator.reset();
+    }
+
+    return true;
+}
+
+void Physics::processMultirate(std::vector<Body*>& bodies) {
+    updateRegularization(bodies);
+
+    // Gravity at the end of the last frame is still valid unless something moved
+    // a body or changed which pairs are regularized in the meantime
+    if (!gravityCached(bodies)) accumulateGravity(bodies);
+
+    for (Body* body : bodies) {
+        if (body->sphere.mesh.source || body->Sleeping) continue;
+        body->Velocity += body->Acceleration * (0.5f * dt);
+    }
+
+    // Fast inner loop: free drift with contacts and surface bounces resolved
+    // every substep, long-range forces held in the surrounding half kicks.
+    // Many small increments on float positions lose their low bits, so the
+    // drift uses compensated (Kahan) summation.
+    // Event-driven frames drift once over dt and sweep the contacts instead
+    int substeps = EventDriven ? 1 : ContactSubsteps;
+    float h = dt / substeps;
+    std::vector<glm::vec3> vCarry(bodies.size(), glm::vec3(0.0f));
+    for (int s = 0; s < substeps; ++s) {
+        beginSweep(bodies, h);
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            Body* body = bodies[i];
+            if (body->sphere.mesh.source || body->Sleeping) continue;
+
+            glm::vec3 vStep = body->Velocity * h - vCarry[i];
+            glm::vec3 vNext = body->Position + vStep;
+            vCarry[i] = (vNext - body->Position) - vStep;
+            body->Position = vNext;
+        }
+        processContacts(bodies, h);
+
+        // Mergers renumber the bodies; the carried rounding errors are dropped
+        if (vCarry.size() != bodies.size()) vCarry.assign(bodies.size(), glm::vec3(0.0f));
+    }
+
+    for (Body* body : bodies) {
+        if (!body->sphere.mesh.source) finishRegularization(*body);
+    }
+
+    accumulateGravity(bodies);
+
+    for (Body* body : bodies) {
+        if (body->sphere.mesh.source || body->Sleeping) continue;
+        body->Velocity += body->Acceleration * (0.5f * dt);
+    }
+
+    // Remember what the forces were computed for
+    multirateBodies = bodies;
+    multiratePosition.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        multiratePosition[i] = bodies[i]->Position;
+    }
+    multirateRegularized = regularizedBodies();
+}
+
+void Physics::accumulateGravity(std::vector<Body*>& bodies) {
+    // Contacts happen in the substeps, so only the forces are wanted here
+    pairKernel.run(bodies, regularizationGroups(bodies), 0.0f, nullptr);
+
+    for (Body* body : bodies) {
+        if (body->sphere.mesh.source || body->Sleeping) continue;
+
+        calculateForce(*body);
+        body->Acceleration = body->Force / body->Mass;
+    }
+}
+
+bool Physics::gravityCached(std::vector<Body*>& bodies) {
+    if (bodies != multirateBodies) return false;
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (bodies[i]->Position != multiratePosition[i]) return false;
+    }
+
+    return regularizedBodies() == multirateRegularized;
+}
+
+std::vector<const Body*> Physics::regularizedBodies() const {
+    std::vector<const Body*> key;
+    for (const RegularizedPair& pair : ksPairs) {
+        key.push_back(pair.One);
+        key.push_back(pair.Two);
+    }
+    for (const ChainSubsystem& chain : chains) {
+        key.push_back(nullptr);
+        key.insert(key.end(), chain.Members.begin(), chain.Members.end());
+    }
+    return key;
+}
+
+void Physics::processContacts(std::vector<Body*>& bodies, float step) {
+    bool swept = (Continuous || EventDriven) && sweepStart.size() == bodies.size();
+
+    // Swept contacts first; their last broad phase (boxes over what is left of
+    // each path) also covers the end positions for the discrete test
+    std::vector<bool> bounced(bodies.size(), false);
+    std::vector<std::pair<uint32_t, uint32_t>> resolved;
+    absorbed.assign(bodies.size(), false);
+    const std::vector<std::pair<uint32_t, uint32_t>>& pairs = swept ? processSweptContacts(bodies, bounced, resolved) : findPairs(bodies, {});
+    sweepStart.clear();
+    std::sort(resolved.begin(), resolved.end());
+
+    // Sequential impulses see every contact of the step, resting ones included
+    bool sequential = Solver == contactSolverType::SEQUENTIAL_IMPULSE && Policy == collisionPolicy::BOUNCE;
+
+    // All faces against all awake bodies, one vectorized pass per face
+    colliders.findContacts(bodies, surfaceContacts);
+    std::vector<std::pair<uint32_t, uint32_t>> faceContacts;
+    for (const auto& contact : surfaceContacts) {
+        if (bounced[contact.first] || absorbed[contact.first]) continue;
+
+        if (sequential) faceContacts.push_back(contact);
+        else processSurfaceCollision(*bodies[contact.first], contact.second);
+    }
+
+    auto touching = [this](Body& body, Body& colBody) {
+        return areColliding(colBody, body) && !((isZero(body.Velocity) && isZero(colBody.Velocity)));
+    };
+
+    auto pull = [this](Body& one, Body& two) {
+        return gravityBetween(one, two);
+    };
+
+    // Contact list, in pair order
+    std::vector<std::pair<uint32_t, uint32_t>> contacts;
+    touchingPairs.clear();
+    for (const auto& pair : pairs) {
+        if (std::binary_search(resolved.begin(), resolved.end(), pair)) continue;
+        if (absorbed[pair.first] || absorbed[pair.second]) continue;
+
+        Body* body = bodies[pair.first];
+        Body* colBody = bodies[pair.second];
+        if (body->Sleeping && colBody->Sleeping) continue;
+
+        // Islands for sleeping are built from every touching pair, moving or not
+        if (Sleep && areColliding(*colBody, *body)) touchingPairs.push_back(pair);
+
+        if (touching(*body, *colBody)) {
+            // An awake body running into a sleeping island wakes it
+            if (body->Sleeping) sleepIslands.wake(pair.first, pull);
+            if (colBody->Sleeping) sleepIslands.wake(pair.second, pull);
+
+            // Contact takes over from the Kepler solution for this frame
+            releasePair(*colBody, *body);
+            contacts.push_back(pair);
+        } else if (sequential) {
+            // Resting contacts too, and those just opened by the position pass
+            float reach = body->sphere.geometry.getRadius() + colBody->sphere.geometry.getRadius() + CONTACT_MARGIN;
+            glm::vec3 d = colBody->Position - body->Position;
+            if (glm::dot(d, d) > reach * reach) continue;
+
+            releasePair(*colBody, *body);
+            contacts.push_back(pair);
+        }
+    }
+
+    if (Policy == collisionPolicy::MERGE) {
+        // Serial, in pair order: a body merged away passes its contacts on to
+        // the body that absorbed it, so clusters end up as one body
+        std::vector<uint32_t> owner(bodies.size());
+        for (uint32_t i = 0; i < owner.size(); ++i) owner[i] = i;
+
+        auto find = [&owner](uint32_t i) {
+            while (owner[i] != i) i = owner[i] = owner[owner[i]];
+            return i;
+        };
+
+        for (const auto& [one, two] : contacts) {
+            uint32_t a = find(one), b = find(two);
+            if (a == b) continue;
+
+            uint32_t kept = mergePair(bodies, a, b);
+            owner[a] = owner[b] = kept;
+        }
+
+        removeAbsorbed(bodies);
+        return;
+    }
+
+    if (sequential) {
+        contactSolver.solve(bodies, contacts, faceContacts, colliders, contactGraph, step);
+        return;
+    }
+
+    // Batches of contacts sharing no body, resolved in colour order; an
+    // earlier batch may already have separated a pair, so test again
+    contactGraph.build(contacts, bodies.size());
+    contactGraph.resolve([&](uint32_t k) {
+        Body* body = bodies[contacts[k].first];
+        Body* colBody = bodies[contacts[k].second];
+
+        if (touching(*body, *colBody)) processCollision(*colBody, *body);
+    });
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>>& Physics::findPairs(std::vector<Body*>& bodies, const std::vector<glm::vec3>& start) {
+    // Candidates of the fused gravity pass, while every body is still within their skin
+    if (fusedList.valid(bodies, start)) return fusedList.getPairs();
+
+    // Nobody has left the skin since the last build: the stored pairs still cover every contact
+    const float skin = neighbourList.getSkin();
+    if (skin > 0.0f && neighbourList.valid(bodies, start)) return neighbourList.getPairs();
+
+    // Broad phase: only pairs whose bounding boxes (over the sweep, if any) overlap
+    if (BroadPhase == broadPhaseType::SWEEP_AND_PRUNE) {
+        sweepAndPrune.build(bodies, start, skin);
+        if (skin <= 0.0f) return sweepAndPrune.getPairs();
+        neighbourList.store(bodies, sweepAndPrune.getPairs());
+    } else {
+        spatialHash.build(bodies, start, skin);
+        if (skin <= 0.0f) return spatialHash.getPairs();
+        neighbourList.store(bodies, spatialHash.getPairs());
+    }
+
+    return neighbourList.getPairs();
+}
+
+void Physics::beginSweep(std::vector<Body*>& bodies, float interval) {
+    if (!Continuous && !EventDriven) return;
+
+    sweepStart.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        sweepStart[i] = bodies[i]->Position;
+    }
+    sweepInterval = interval;
+}
+
+const std::vector<std::pair<uint32_t, uint32_t>>& Physics::processSweptContacts(std::vector<Body*>& bodies, std::vector<bool>& bounced, std::vector<std::pair<uint32_t, uint32_t>>& resolved) {
+    // Every body moves in a straight line from vFrom (at step fraction fFrom)
+    // to its current position (at 1); a contact restarts the line at its time
+    std::vector<glm::vec3> vFrom = sweepStart;
+    std::vector<float> fFrom(bodies.size(), 0.0f);
+    const std::vector<std::pair<uint32_t, uint32_t>>* pairs = nullptr;
+
+    auto at = [&](size_t i, float s) {
+        if (fFrom[i] >= 1.0f) return bodies[i]->Position;
+        return vFrom[i] + ((s - fFrom[i]) / (1.0f - fFrom[i])) * (bodies[i]->Position - vFrom[i]);
+    };
+
+    // Candidates: pairs by index, then collider face f for body i as pairs.size() + i * faces + f
+    const size_t faces = colliders.size();
+    auto impact = [&](size_t k, float& s) {
+        float u;
+        if (k >= pairs->size()) {
+            size_t i = (k - pairs->size()) / faces;
+            size_t f = (k - pairs->size()) % faces;
+            if (absorbed[i]) return false;
+            if (!colliders.sweep(f, vFrom[i], bodies[i]->Position, bodies[i]->sphere.geometry.getRadius(), u)) return false;
+            s = fFrom[i] + u * (1.0f - fFrom[i]);
+            return true;
+        }
+
+        auto [i, j] = (*pairs)[k];
+        if (absorbed[i] || absorbed[j]) return false;
+        float s0 = std::max(fFrom[i], fFrom[j]);
+        float radius = bodies[i]->sphere.geometry.getRadius() + bodies[j]->sphere.geometry.getRadius();
+        if (!sphereImpact(at(i, s0), bodies[i]->Position, at(j, s0), bodies[j]->Position, radius, u)) return false;
+        s = s0 + u * (1.0f - s0);
+        return true;
+    };
+
+    auto predict = [&](size_t k) {
+        float s;
+        if (!impact(k, s)) return;
+
+        if (k >= pairs->size()) {
+            scheduler.schedule(s, (uint32_t)((k - pairs->size()) / faces), SCHEDULE_SURFACE, (uint32_t)k);
+        } else {
+            scheduler.schedule(s, (*pairs)[k].first, (*pairs)[k].second, (uint32_t)k);
+        }
+    };
+
+    // Continue from the contact with the new velocity for the rest of the step
+    auto restart = [&](size_t i, float s) {
+        Body* body = bodies[i];
+        vFrom[i] = body->Position;
+        fFrom[i] = s;
+        body->Position = vFrom[i] + body->Velocity * ((1.0f - s) * sweepInterval);
+
+        // Its other predictions are stale now
+        scheduler.invalidate((uint32_t)i);
+    };
+
+    auto pull = [this](Body& one, Body& two) {
+        return gravityBetween(one, two);
+    };
+
+    std::vector<std::vector<uint32_t>> partners;
+    auto repredict = [&](size_t i) {
+        for (uint32_t k : partners[i]) predict(k);
+        for (size_t f = 0; f < faces; ++f) predict(pairs->size() + i * faces + f);
+    };
+
+    // A collision can send a body outside the boxes its candidates came from,
+    // so the broad phase is redone over the remaining paths until a round
+    // finds nothing new
+    const size_t budget = MAX_EVENTS_PER_BODY * bodies.size();
+    size_t events = 0;
+
+    for (int round = 0; round < MAX_SWEEP_ROUNDS; ++round) {
+        pairs = &findPairs(bodies, vFrom);
+
+        // Candidate pairs of each body, for re-predicting after it collides
+        partners.assign(bodies.size(), {});
+        for (size_t k = 0; k < pairs->size(); ++k) {
+            partners[(*pairs)[k].first].push_back((uint32_t)k);
+            partners[(*pairs)[k].second].push_back((uint32_t)k);
+        }
+
+        scheduler.reset(bodies.size());
+        for (size_t k = 0; k < pairs->size(); ++k) {
+            predict(k);
+        }
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (bodies[i]->sphere.mesh.source) continue;
+            for (size_t f = 0; f < faces; ++f) predict(pairs->size() + i * faces + f);
+        }
+
+        // Collision to collision in time order
+        CollisionEvent hit;
+        while (events + scheduler.getProcessed() < budget && scheduler.next(hit)) {
+            float s = hit.Time;
+
+            if (hit.Two == SCHEDULE_SURFACE) {
+                Body* body = bodies[hit.One];
+
+                body->Position = at(hit.One, s);
+                processSurfaceCollision(*body, (hit.Pair - pairs->size()) % faces);
+                restart(hit.One, s);
+                bounced[hit.One] = true;
+                repredict(hit.One);
+                continue;
+            }
+
+            Body* body = bodies[hit.One];
+            Body* colBody = bodies[hit.Two];
+            if (body->Sleeping) sleepIslands.wake(hit.One, pull);
+            if (colBody->Sleeping) sleepIslands.wake(hit.Two, pull);
+
+            body->Position = at(hit.One, s);
+            colBody->Position = at(hit.Two, s);
+            releasePair(*colBody, *body);
+
+            if (Policy == collisionPolicy::MERGE) {
+                // The merged body carries on from the contact; the other one is gone
+                uint32_t kept = mergePair(bodies, hit.One, hit.Two);
+                restart(kept, s);
+                scheduler.invalidate(kept == hit.One ? hit.Two : hit.One);
+                repredict(kept);
+                continue;
+            }
+
+            processCollision(*colBody, *body);
+            restart(hit.One, s);
+            restart(hit.Two, s);
+            resolved.emplace_back(hit.One, hit.Two);
+            repredict(hit.One);
+            repredict(hit.Two);
+        }
+
+        if (scheduler.getProcessed() == 0) break;
+        events += scheduler.getProcessed();
+    }
+
+    return *pairs;
+}
+
+void Physics::updateRegularization(std::vector<Body*>& bodies) {
+    updateChains(bodies);
+
+    if (KSThreshold <= 0.0f) return;
+
+    // Release pairs that have separated (hysteresis avoids flickering at the
+    // threshold) or whose members went to sleep
+    float exitDistance = 1.5f * KSThreshold;
+    for (size_t p = 0; p < ksPairs.size();) {
+        if (ksPairs[p].getDistance() > exitDistance || ksPairs[p].One->Sleeping || ksPairs[p].Two->Sleeping) {
+            ksPairs.erase(ksPairs.begin() + p);
+        } else {
+            ++p;
+        }
+    }
+
+    // Chain members are already regularized as part of their subsystem
+    auto paired = [this](Body* body) {
+        for (const RegularizedPair& pair : ksPairs) {
+            if (pair.contains(body)) return true;
+        }
+        for (const ChainSubsystem& chain : chains) {
+            if (chain.contains(body)) return true;
+        }
+        return false;
+    };
+
+    // Collect new candidates and pair them up closest first
+    std::vector<std::pair<float, std::pair<size_t, size_t>>> candidates;
+    float thresholdSq = KSThreshold * KSThreshold;
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (bodies[i]->sphere.mesh.source || bodies[i]->Sleeping || paired(bodies[i])) continue;
+
+        for (size_t j = i + 1; j < bodies.size(); ++j) {
+            if (bodies[j]->sphere.mesh.source || bodies[j]->Sleeping || paired(bodies[j])) continue;
+
+            float fDistSq = calculateDistanceSquare(*bodies[i], *bodies[j]);
+            if (fDistSq < thresholdSq) {
+                candidates.push_back({fDistSq, {i, j}});
+            }
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    for (const auto& candidate : candidates) {
+        Body* one = bodies[candidate.second.first];
+        Body* two = bodies[candidate.second.second];
+        if (paired(one) || paired(two)) continue;
+
+        ksPairs.emplace_back(one, two);
+    }
+
+    // The pair is finished after whichever member the force loop moves last
+    for (RegularizedPair& pair : ksPairs) {
+        auto first = std::find(bodies.begin(), bodies.end(), pair.One);
+        auto second = std::find(bodies.begin(), bodies.end(), pair.Two);
+        if (first > second) std::swap(pair.One, pair.Two);
+
+        pair.begin();
+    }
+}
+
+void Physics::updateChains(std::vector<Body*>& bodies) {
+    if (ChainRadius <= 0.0f) {
+        chains.clear();
+        return;
+    }
+
+    std::vector<Body*> active;
+    for (Body* body : bodies) {
+        if (!body->sphere.mesh.source) active.push_back(body);
+    }
+
+    // Union-find over bodies linked closer than the radius; members of the
+    // same existing chain stay linked up to 1.5x the radius
+    std::vector<size_t> parent(active.size());
+    for (size_t i = 0; i < parent.size(); ++i) parent[i] = i;
+
+    auto root = [&parent](size_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    auto sameChain = [this](Body* a, Body* b) {
+        for (const ChainSubsystem& chain : chains) {
+            if (chain.contains(a) && chain.contains(b)) return true;
+        }
+        return false;
+    };
+
+    for (size_t i = 0; i < active.size(); ++i) {
+        for (size_t j = i + 1; j < active.size(); ++j) {
+            float limit = sameChain(active[i], active[j]) ? 1.5f * ChainRadius : ChainRadius;
+            if (calculateDistanceSquare(*active[i], *active[j]) < limit * limit) {
+                parent[root(i)] = root(j);
+            }
+        }
+    }
+
+    std::vector<std::vector<Body*>> groups(active.size());
+    for (size_t i = 0; i < active.size(); ++i) {
+        groups[root(i)].push_back(active[i]);
+    }
+
+    // Keep chains whose membership is unchanged so they retain their step history
+    std::vector<ChainSubsystem> next;
+    for (const std::vector<Body*>& group : groups) {
+        if (group.size() < 3 || group.size() > MAX_CHAIN_BODIES) continue;
+
+        auto existing = std::find_if(chains.begin(), chains.end(), [&group](const ChainSubsystem& chain) {
+            return chain.Members == group;
+        });
+
+        if (existing != chains.end()) {
+            next.push_back(*existing);
+        } else {
+            next.emplace_back(group);
+        }
+    }
+    chains.swap(next);
+
+    for (ChainSubsystem& chain : chains) {
+        chain.begin();
+    }
+}
+
+void Physics::finishRegularization(Body& body) {
+    for (RegularizedPair& pair : ksPairs) {
+        if (pair.Two == &body) pair.finish(dt);
+    }
+    for (ChainSubsystem& chain : chains) {
+        if (chain.Last == &body) chain.finish(dt);
+    }
+}
+
+void Physics::releasePair(Body& sphereOne, Body& sphereTwo) {
+    for (size_t p = 0; p < ksPairs.size(); ++p) {
+        if (ksPairs[p].matches(&sphereOne, &sphereTwo)) {
+            ksPairs.erase(ksPairs.begin() + p);
+            return;
+        }
+    }
+    for (size_t c = 0; c < chains.size(); ++c) {
+        if (chains[c].contains(&sphereOne) && chains[c].contains(&sphereTwo)) {
+            chains.erase(chains.begin() + c);
+            return;
+        }
+    }
+}
+
+void Physics::releaseBody(Body& body) {
+    ksPairs.erase(std::remove_if(ksPairs.begin(), ksPairs.end(), [&body](const RegularizedPair& pair) {
+        return pair.contains(&body);
+    }), ksPairs.end());
+    chains.erase(std::remove_if(chains.begin(), chains.end(), [&body](const ChainSubsystem& chain) {
+        return chain.contains(&body);
+    }), chains.end());
+}
+
+std::vector<int> Physics::regularizationGroups(const std::vector<Body*>& bodies) const {
+    std::vector<int> group(bodies.size(), -1);
+    if (ksPairs.empty() && chains.empty()) return group;
+
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        for (size_t p = 0; p < ksPairs.size(); ++p) {
+            if (ksPairs[p].contains(bodies[i])) group[i] = (int)p;
+        }
+        for (size_t c = 0; c < chains.size(); ++c) {
+            if (chains[c].contains(bodies[i])) group[i] = (int)(ksPairs.size() + c);
+        }
+    }
+    return group;
+}
+
+bool Physics::isRegularized(Body& sphereOne, Body& sphereTwo) {
+    for (const RegularizedPair& pair : ksPairs) {
+        if (pair.matches(&sphereOne, &sphereTwo)) return true;
+    }
+    for (const ChainSubsystem& chain : chains) {
+        if (chain.contains(&sphereOne) && chain.contains(&sphereTwo)) return true;
+    }
+    return false;
+}
+
 float Physics::calculateDistanceSquare(Body& sphereOne, Body& sphereTwo) {
     glm::vec3 vDistance = sphereTwo.Position - sphereOne.Position;
     float fDistSq = glm::dot(vDistance, vDistance);
     return fDistSq;
 }
 
-void Physics::calculateGravForce(Body& sphereOne, Body& sphereTwo) {
+glm::vec3 Physics::gravityBetween(Body& sphereOne, Body& sphereTwo) {
     float fDistanceSq = calculateDistanceSquare(sphereOne, sphereTwo);
     
-    // Clamp distance to prevent infinite forces when bodies are too close
-    float minDistSq = 1.0f;  // Minimum distance squared (1.0 unit²)
-    if (fDistanceSq < minDistSq + EPSILON) return;
+    // Ignore pairs closer than the minimum distance (1.0 unit²). KS-regularized
+    // pairs never come through here, so this only clamps the pairs left out
+    float minDistSq = 1.0f;
+    if (fDistanceSq < minDistSq + EPSILON) return glm::vec3(0);
     
     // Direction FROM sphereOne TO sphereTwo (attraction direction)
     glm::vec3 vDirOne = glm::normalize(sphereTwo.Position - sphereOne.Position);
-    glm::vec3 vDirTwo = -vDirOne;  // Opposite direction for sphereTwo
 
     // Use MUCH smaller gravitational constant to prevent runaway acceleration
     // The Speed multiplier (3.0x) amplifies motion, so G must be smaller
     float gravForce = GRAV_CONST * ((sphereOne.Mass * sphereTwo.Mass) / fDistanceSq);
 
-    sphereOne.vForceAccumulator += gravForce * vDirOne;
-    sphereTwo.vForceAccumulator += gravForce * vDirTwo;
+    return gravForce * vDirOne;
+}
+
+void Physics::calculateGravForce(Body& sphereOne, Body& sphereTwo) {
+    glm::vec3 vForce = gravityBetween(sphereOne, sphereTwo);
+
+    sphereOne.vForceAccumulator += vForce;
+    sphereTwo.vForceAccumulator -= vForce;
 }
 
 void Physics::calculateForce(Body& body) {
@@ -122,25 +1172,28 @@ void Physics::calculateForce(Body& body) {
 }
 
 bool Physics::onSurface(Body& body) {
-    float rad = body.sphere.geometry.getRadius();
-    float y = body.Position.y;
-    float surfaceY = -2.0f;
-
-    return y - rad <= surfaceY + EPSILON;
+    return colliders.touches(body.Position, body.sphere.geometry.getRadius());
 }
 
-void Physics::processSurfaceCollision(Body& body) {
-    // Apply coefficient of restitution (energy loss) and REVERSE direction
-    body.Velocity.y = body.Velocity.y * -0.8f;
-    // Clamp position to surface to prevent sinking
-    float rad = body.sphere.geometry.getRadius();
-    float surfaceY = -2.0f;
-    body.Position.y = surfaceY + rad;
-    
+void Physics::processSurfaceCollision(Body& body, size_t face) {
+    glm::vec3 normal;
+    float offset;
+    colliders.facing(face, body.Position, normal, offset);
+
+    // Apply coefficient of restitution (energy loss) and REVERSE the normal component
+    float vn = glm::dot(body.Velocity, normal);
+    float bounce = vn * -0.8f;
+
     // Stop micro-bouncing: if velocity is too small, set to zero (resting state)
-    if (glm::abs(body.Velocity.y) < 0.1f) {
-        body.Velocity.y = 0.0f;
+    if (glm::abs(bounce) < 0.1f) {
+        bounce = 0.0f;
     }
+    body.Velocity += (bounce - vn) * normal;
+
+    // Clamp position to surface to prevent sinking
+    float rad = body.sphere.geometry.getRadius();
+    float dist = glm::dot(body.Position, normal);
+    body.Position += (offset + rad - dist) * normal;
 }
 
 bool Physics::areColliding(Body& sphereOne, Body& sphereTwo) {
@@ -157,8 +1210,12 @@ bool Physics::areColliding(Body& sphereOne, Body& sphereTwo) {
 }
 
 void Physics::processCollision(Body& sphereOne, Body& sphereTwo) {
-    // Calculate collision normal (direction from one to two)
-    glm::vec3 collisionNormal = glm::normalize(sphereTwo.Position - sphereOne.Position);
+    // Calculate collision normal (direction from one to two). Coincident centres
+    // have no separation direction, so fall back to the direction of approach
+    glm::vec3 vSeparation = sphereTwo.Position - sphereOne.Position;
+    if (isZero(vSeparation)) vSeparation = sphereOne.Velocity - sphereTwo.Velocity;
+    if (vSeparation == glm::vec3(0)) vSeparation = glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 collisionNormal = glm::normalize(vSeparation);
     
     // Calculate overlap distance
     float distance = glm::length(sphereTwo.Position - sphereOne.Position);
@@ -181,6 +1238,62 @@ void Physics::processCollision(Body& sphereOne, Body& sphereTwo) {
     sphereTwo.Velocity = velTwo;
 }
 
+uint32_t Physics::mergePair(std::vector<Body*>& bodies, uint32_t one, uint32_t two) {
+    // The heavier body survives; on a tie the one earlier in the list
+    if (bodies[two]->Mass > bodies[one]->Mass) std::swap(one, two);
+    Body& kept = *bodies[one];
+    Body& gone = *bodies[two];
+
+    releaseBody(kept);
+    releaseBody(gone);
+
+    // Perfectly inelastic: mass and momentum are conserved, the merged body
+    // sits at the centre of mass
+    double mOne = kept.Mass, mTwo = gone.Mass;
+    double mTotal = mOne + mTwo;
+    glm::dvec3 vCentre = (mOne * glm::dvec3(kept.Position) + mTwo * glm::dvec3(gone.Position)) / mTotal;
+    glm::dvec3 vMomentum = mOne * glm::dvec3(kept.Velocity) + mTwo * glm::dvec3(gone.Velocity);
+
+    // Radius cubed: from the volume m / ρ = 4/3 π r³, or the summed volumes
+    double rOne = kept.sphere.geometry.getRadius();
+    double rTwo = gone.sphere.geometry.getRadius();
+    double rCube = MergeDensity > 0.0f ? 3.0 * mTotal / (4.0 * std::acos(-1.0) * MergeDensity) : rOne * rOne * rOne + rTwo * rTwo * rTwo;
+
+    kept.Mass = (float)mTotal;
+    kept.Position = glm::vec3(vCentre);
+    kept.Velocity = glm::vec3(vMomentum / mTotal);
+    kept.setRadius((float)std::cbrt(rCube));
+
+    absorbed[two] = true;
+    return one;
+}
+
+void Physics::removeAbsorbed(std::vector<Body*>& bodies) {
+    if (std::find(absorbed.begin(), absorbed.end(), true) == absorbed.end()) return;
+
+    // Stable in-place compaction; the vector only shrinks, so it keeps its storage
+    std::vector<uint32_t> index(bodies.size(), UINT32_MAX);
+    size_t kept = 0;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (absorbed[i]) {
+            if (onRemove) onRemove(*bodies[i]);
+            continue;
+        }
+        index[i] = (uint32_t)kept;
+        bodies[kept++] = bodies[i];
+    }
+    bodies.resize(kept);
+
+    size_t pairs = 0;
+    for (const auto& [one, two] : touchingPairs) {
+        if (index[one] == UINT32_MAX || index[two] == UINT32_MAX) continue;
+        touchingPairs[pairs++] = { index[one], index[two] };
+    }
+    touchingPairs.resize(pairs);
+
+    absorbed.assign(kept, false);
+}
+
 double Physics::getDistance(Body& sphereOne, Body& sphereTwo) {
     glm::vec3 d = sphereOne.Position - sphereTwo.Position;
     double sqDistance = glm::dot(d, d);
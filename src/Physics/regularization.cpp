@@ -0,0 +1,184 @@
+#include "Physics/regularization.h"
+#include "Physics/physics.h"
+#include <cmath>
+
+// Oscillator functions for u'' = -β u:  C = cos(√β s), S = sin(√β s)/√β
+// (hyperbolic for β < 0, polynomial for β = 0)
+static void oscillator(double beta, double s, double& C, double& S) {
+    if (beta > 0.0) {
+        double w = std::sqrt(beta);
+        C = std::cos(w * s);
+        S = std::sin(w * s) / w;
+    } else if (beta < 0.0) {
+        double w = std::sqrt(-beta);
+        C = std::cosh(w * s);
+        S = std::sinh(w * s) / w;
+    } else {
+        C = 1.0;
+        S = s;
+    }
+}
+
+// ∫₀ˢ S² ds = (s - C S) / 2β, with the series used where that cancels badly
+static double integralSS(double beta, double s, double C, double S) {
+    double x = beta * s * s;
+
+    if (std::abs(x) > 1.0) {
+        return (s - C * S) / (2.0 * beta);
+    }
+
+    // Σₖ (-1)ᵏ⁺¹ 2²ᵏ⁻¹ βᵏ⁻¹ s²ᵏ⁺¹ / (2k+1)!
+    double term = s * s * s / 3.0;
+    double sum = term;
+    for (int k = 2; k < 16; ++k) {
+        term *= -4.0 * x / ((2.0 * k) * (2.0 * k + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+RegularizedPair::RegularizedPair(Body* one, Body* two) : One(one), Two(two), StartSeparation(0.0) { }
+
+bool RegularizedPair::contains(const Body* body) const {
+    return One == body || Two == body;
+}
+
+bool RegularizedPair::matches(const Body* a, const Body* b) const {
+    return (One == a && Two == b) || (One == b && Two == a);
+}
+
+double RegularizedPair::getDistance() const {
+    return glm::length(glm::dvec3(Two->Position) - glm::dvec3(One->Position));
+}
+
+void RegularizedPair::begin() {
+    StartSeparation = glm::dvec3(Two->Position) - glm::dvec3(One->Position);
+}
+
+void RegularizedPair::finish(double interval) {
+    double mOne = One->Mass;
+    double mTwo = Two->Mass;
+    double mTotal = mOne + mTwo;
+
+    // Centre of mass motion already includes the external forces
+    glm::dvec3 vCentre = (mOne * glm::dvec3(One->Position) + mTwo * glm::dvec3(Two->Position)) / mTotal;
+    glm::dvec3 vCentreVel = (mOne * glm::dvec3(One->Velocity) + mTwo * glm::dvec3(Two->Velocity)) / mTotal;
+
+    // Kick (relative velocity after external forces), then exact Kepler drift
+    glm::dvec3 vRelVel = glm::dvec3(Two->Velocity) - glm::dvec3(One->Velocity);
+    KSState ks = toKS(StartSeparation, vRelVel, GRAV_CONST * mTotal);
+    propagate(ks, interval);
+
+    glm::dvec3 vRel, vKepler;
+    fromKS(ks, vRel, vKepler);
+
+    // A head-on orbit starting or ending exactly at r = 0 has no defined velocity
+    // there; the spheres overlap anyway, so drift and let the contact pass respond
+    if (std::isfinite(glm::dot(vKepler, vKepler)) && std::isfinite(glm::dot(vRel, vRel))) {
+        vRelVel = vKepler;
+    } else {
+        vRel = StartSeparation + vRelVel * interval;
+    }
+
+    One->Position = glm::vec3(vCentre - (mTwo / mTotal) * vRel);
+    Two->Position = glm::vec3(vCentre + (mOne / mTotal) * vRel);
+    One->Velocity = glm::vec3(vCentreVel - (mTwo / mTotal) * vRelVel);
+    Two->Velocity = glm::vec3(vCentreVel + (mOne / mTotal) * vRelVel);
+}
+
+KSState RegularizedPair::toKS(const glm::dvec3& r, const glm::dvec3& v, double mu) {
+    KSState ks;
+    double fDistance = glm::length(r);
+
+    // Pick the branch that avoids dividing by a vanishing component
+    if (r.x >= 0.0) {
+        double u1 = std::sqrt(0.5 * (fDistance + r.x));
+        ks.U = glm::dvec4(u1, r.y / (2.0 * u1), r.z / (2.0 * u1), 0.0);
+    } else {
+        double u2 = std::sqrt(0.5 * (fDistance - r.x));
+        ks.U = glm::dvec4(r.y / (2.0 * u2), u2, 0.0, r.z / (2.0 * u2));
+    }
+
+    // u' = ½ Lᵀ(u) v
+    const glm::dvec4& u = ks.U;
+    ks.UPrime = 0.5 * glm::dvec4(
+         u.x * v.x + u.y * v.y + u.z * v.z,
+        -u.y * v.x + u.x * v.y + u.w * v.z,
+        -u.z * v.x - u.w * v.y + u.x * v.z,
+         u.w * v.x - u.z * v.y + u.y * v.z
+    );
+
+    ks.Energy = 0.5 * glm::dot(v, v) - mu / fDistance;
+    return ks;
+}
+
+void RegularizedPair::fromKS(const KSState& ks, glm::dvec3& r, glm::dvec3& v) {
+    const glm::dvec4& u = ks.U;
+    const glm::dvec4& w = ks.UPrime;
+
+    // r = L(u) u
+    r = glm::dvec3(
+        u.x * u.x - u.y * u.y - u.z * u.z + u.w * u.w,
+        2.0 * (u.x * u.y - u.z * u.w),
+        2.0 * (u.x * u.z + u.y * u.w)
+    );
+
+    // v = (2/r) L(u) u'
+    double fDistance = glm::dot(u, u);
+    v = (2.0 / fDistance) * glm::dvec3(
+        u.x * w.x - u.y * w.y - u.z * w.z + u.w * w.w,
+        u.y * w.x + u.x * w.y - u.w * w.z - u.z * w.w,
+        u.z * w.x + u.w * w.y + u.x * w.z + u.y * w.w
+    );
+}
+
+void RegularizedPair::propagate(KSState& ks, double interval) {
+    if (interval <= 0.0) return;
+
+    const double beta = -0.5 * ks.Energy;
+    const double uu = glm::dot(ks.U, ks.U);
+    const double uw = glm::dot(ks.U, ks.UPrime);
+    const double ww = glm::dot(ks.UPrime, ks.UPrime);
+
+    // Physical time t(s) = ∫|u|² ds and its derivative r(s) = |u(s)|²
+    auto timeAt = [&](double s, double& r) {
+        double C, S;
+        oscillator(beta, s, C, S);
+        glm::dvec4 u = ks.U * C + ks.UPrime * S;
+        r = glm::dot(u, u);
+        return uu * 0.5 * (s + C * S) + uw * S * S + ww * integralSS(beta, s, C, S);
+    };
+
+    // Bracket the root of t(s) = interval; t is monotonic because r ≥ 0
+    double r;
+    double sLow = 0.0;
+    double sHigh = interval / uu;
+    while (timeAt(sHigh, r) < interval) {
+        sLow = sHigh;
+        sHigh *= 2.0;
+    }
+
+    // Newton iteration safeguarded by bisection
+    double s = 0.5 * (sLow + sHigh);
+    for (int it = 0; it < 100; ++it) {
+        double f = timeAt(s, r) - interval;
+        if (std::abs(f) <= 1e-15 * interval) break;
+
+        if (f < 0.0) sLow = s; else sHigh = s;
+
+        double sNext = s - f / r;
+        if (!(sNext > sLow && sNext < sHigh)) {
+            sNext = 0.5 * (sLow + sHigh);
+        }
+        if (sNext == s) break;
+        s = sNext;
+    }
+
+    double C, S;
+    oscillator(beta, s, C, S);
+    glm::dvec4 u = ks.U * C + ks.UPrime * S;
+    glm::dvec4 w = -beta * ks.U * S + ks.UPrime * C;
+
+    ks.U = u;
+    ks.UPrime = w;
+}
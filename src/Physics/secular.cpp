@@ -0,0 +1,277 @@
+#include "Physics/secular.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr double PI = 3.14159265358979323846;
+
+// Any unit vector perpendicular to n (reference direction for circular orbits)
+static glm::dvec3 perpendicular(const glm::dvec3& n) {
+    glm::dvec3 axis = std::abs(n.x) < 0.9 ? glm::dvec3(1.0, 0.0, 0.0) : glm::dvec3(0.0, 1.0, 0.0);
+    return glm::normalize(glm::cross(n, axis));
+}
+
+// Restore e·j = 0 and |e|² + |j|² = 1 after a step
+static void project(glm::dvec3& e, glm::dvec3& j) {
+    double fJ = glm::length(j);
+    glm::dvec3 vNormal = j / fJ;
+    e -= glm::dot(e, vNormal) * vNormal;
+
+    double fE = glm::length(e);
+    double fScale = 1.0 / std::sqrt(fE * fE + fJ * fJ);
+    e *= fScale;
+    j *= fScale;
+}
+
+Orbit Orbit::fromState(const glm::dvec3& r, const glm::dvec3& v, double mu) {
+    Orbit orbit;
+    double fDist = glm::length(r);
+    glm::dvec3 h = glm::cross(r, v);
+
+    orbit.SemiMajorAxis = 1.0 / (2.0 / fDist - glm::dot(v, v) / mu);
+    orbit.Eccentricity = glm::cross(v, h) / mu - r / fDist;
+    orbit.AngularMomentum = h / std::sqrt(mu * orbit.SemiMajorAxis);
+
+    double e = glm::length(orbit.Eccentricity);
+    if (e < 1e-12) {
+        // Circular: measure the phase from the reference direction used by toState
+        glm::dvec3 P = perpendicular(glm::normalize(h));
+        glm::dvec3 Q = glm::cross(glm::normalize(h), P);
+        orbit.MeanAnomaly = std::atan2(glm::dot(r, Q), glm::dot(r, P));
+        orbit.Eccentricity = glm::dvec3(0.0);
+        return orbit;
+    }
+
+    double a = orbit.SemiMajorAxis;
+    double fCosE = (1.0 - fDist / a) / e;
+    double fSinE = glm::dot(r, v) / (e * std::sqrt(mu * a));
+    double E = std::atan2(fSinE, fCosE);
+    orbit.MeanAnomaly = E - e * std::sin(E);
+    return orbit;
+}
+
+void Orbit::toState(double mu, glm::dvec3& r, glm::dvec3& v) const {
+    double a = SemiMajorAxis;
+    double e = glm::length(Eccentricity);
+    glm::dvec3 vNormal = glm::normalize(AngularMomentum);
+    glm::dvec3 P = e < 1e-12 ? perpendicular(vNormal) : Eccentricity / e;
+    glm::dvec3 Q = glm::cross(vNormal, P);
+
+    // Kepler's equation M = E - e sin E by Newton iteration
+    double M = std::remainder(MeanAnomaly, 2.0 * PI);
+    double E = e < 0.8 ? M : (M < 0.0 ? -PI : PI);
+    for (int k = 0; k < 50; ++k) {
+        double dE = (E - e * std::sin(E) - M) / (1.0 - e * std::cos(E));
+        E -= dE;
+        if (std::abs(dE) < 1e-15) break;
+    }
+
+    double fCosE = std::cos(E), fSinE = std::sin(E);
+    double fRoot = std::sqrt(std::max(0.0, 1.0 - e * e));
+    double fDist = a * (1.0 - e * fCosE);
+
+    r = a * (fCosE - e) * P + a * fRoot * fSinE * Q;
+    v = (std::sqrt(mu * a) / fDist) * (-fSinE * P + fRoot * fCosE * Q);
+}
+
+SecularTriple::SecularTriple()
+    : InnerOne(0), InnerTwo(1), Third(2), MassOne(0.0), MassTwo(0.0), MassThird(0.0),
+      Centre(0.0), CentreVelocity(0.0), Time(0.0) { }
+
+bool SecularTriple::detect(const SystemState& state, SecularTriple& triple) {
+    if (state.size() != 3) return false;
+
+    // Closest pair is the candidate inner binary
+    size_t one = 0, two = 1;
+    double best = glm::dot(state.Position[1] - state.Position[0], state.Position[1] - state.Position[0]);
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = i + 1; j < 3; ++j) {
+            glm::dvec3 d = state.Position[j] - state.Position[i];
+            if (glm::dot(d, d) < best) { best = glm::dot(d, d); one = i; two = j; }
+        }
+    }
+
+    SecularTriple candidate;
+    candidate.InnerOne = one;
+    candidate.InnerTwo = two;
+    candidate.Third = 3 - one - two;
+    candidate.MassOne = state.Mass[one];
+    candidate.MassTwo = state.Mass[two];
+    candidate.MassThird = state.Mass[candidate.Third];
+
+    double mInner = candidate.MassOne + candidate.MassTwo;
+    double mTotal = mInner + candidate.MassThird;
+    if (candidate.MassThird <= 0.0 || mInner <= 0.0) return false;
+
+    glm::dvec3 vInnerCentre = (candidate.MassOne * state.Position[one] + candidate.MassTwo * state.Position[two]) / mInner;
+    glm::dvec3 vInnerCentreVel = (candidate.MassOne * state.Velocity[one] + candidate.MassTwo * state.Velocity[two]) / mInner;
+
+    glm::dvec3 rIn = state.Position[two] - state.Position[one];
+    glm::dvec3 vIn = state.Velocity[two] - state.Velocity[one];
+    glm::dvec3 rOut = state.Position[candidate.Third] - vInnerCentre;
+    glm::dvec3 vOut = state.Velocity[candidate.Third] - vInnerCentreVel;
+
+    // Both orbits must be bound
+    if (glm::dot(vIn, vIn) >= 2.0 * candidate.innerMu() / glm::length(rIn)) return false;
+    if (glm::dot(vOut, vOut) >= 2.0 * candidate.outerMu() / glm::length(rOut)) return false;
+
+    candidate.Inner = Orbit::fromState(rIn, vIn, candidate.innerMu());
+    candidate.Outer = Orbit::fromState(rOut, vOut, candidate.outerMu());
+    candidate.Centre = (mInner * vInnerCentre + candidate.MassThird * state.Position[candidate.Third]) / mTotal;
+    candidate.CentreVelocity = (mInner * vInnerCentreVel + candidate.MassThird * state.Velocity[candidate.Third]) / mTotal;
+    candidate.Time = 0.0;
+
+    // Demand some margin on entry so that the switch does not flicker
+    if (!candidate.isValid(1.2)) return false;
+
+    triple = candidate;
+    return true;
+}
+
+double SecularTriple::innerMu() const {
+    return GRAV_CONST * (MassOne + MassTwo);
+}
+
+double SecularTriple::outerMu() const {
+    return GRAV_CONST * (MassOne + MassTwo + MassThird);
+}
+
+double SecularTriple::getTimescale() const {
+    double aIn = Inner.SemiMajorAxis;
+    double aOut = Outer.SemiMajorAxis;
+    double fRatio = aOut / aIn;
+    double fJOut = glm::length(Outer.AngularMomentum);
+    double nIn = std::sqrt(innerMu() / (aIn * aIn * aIn));
+
+    return (MassOne + MassTwo) / MassThird * fRatio * fRatio * fRatio * fJOut * fJOut * fJOut / nIn;
+}
+
+double SecularTriple::getInnerPericenter() const {
+    return Inner.SemiMajorAxis * (1.0 - glm::length(Inner.Eccentricity));
+}
+
+const Orbit& SecularTriple::getInner() const {
+    return Inner;
+}
+
+const Orbit& SecularTriple::getOuter() const {
+    return Outer;
+}
+
+bool SecularTriple::isValid(double margin) const {
+    double aIn = Inner.SemiMajorAxis;
+    double aOut = Outer.SemiMajorAxis;
+    if (aIn <= 0.0 || aOut <= 0.0) return false;
+
+    double eOut = glm::length(Outer.Eccentricity);
+    if (eOut >= 1.0) return false;
+
+    // Mardling & Aarseth (2001):
+    // R_p,out / a_in > 2.8 [(1 + q_out)(1 + e_out) / √(1 - e_out)]^(2/5) (1 - 0.3 i/π)
+    double qOut = MassThird / (MassOne + MassTwo);
+    double fCosI = glm::dot(glm::normalize(Inner.AngularMomentum), glm::normalize(Outer.AngularMomentum));
+    double fIncl = std::acos(std::clamp(fCosI, -1.0, 1.0));
+    double fCritical = 2.8 * std::pow((1.0 + qOut) * (1.0 + eOut) / std::sqrt(1.0 - eOut), 0.4) * (1.0 - 0.3 * fIncl / PI);
+
+    if (aOut * (1.0 - eOut) / aIn < margin * fCritical) return false;
+
+    // Double averaging needs the inner angular momentum to change little over one
+    // outer orbit; near maximum eccentricity that rate is t_LK |j_in|
+    double fPeriodOut = 2.0 * PI * std::sqrt(aOut * aOut * aOut / outerMu());
+    double fJIn = glm::length(Inner.AngularMomentum);
+    return getTimescale() * fJIn > margin * fPeriodOut;
+}
+
+void SecularTriple::derivative(const glm::dvec3 y[4], glm::dvec3 dydt[4]) const {
+    const glm::dvec3& eIn = y[0];
+    const glm::dvec3& jIn = y[1];
+    const glm::dvec3& eOut = y[2];
+    const glm::dvec3& jOut = y[3];
+
+    double fJOut = glm::length(jOut);
+    glm::dvec3 n = jOut / fJOut;
+
+    double fRate = 0.75 / getTimescale();
+    double fJn = glm::dot(jIn, n);
+    double fEn = glm::dot(eIn, n);
+
+    dydt[0] = fRate * (fJn * glm::cross(eIn, n) + 2.0 * glm::cross(jIn, eIn) - 5.0 * fEn * glm::cross(jIn, n));
+    dydt[1] = fRate * (fJn * glm::cross(jIn, n) - 5.0 * fEn * glm::cross(eIn, n));
+
+    // Circular angular momenta L = μ √(G M a) set how much the outer orbit reacts
+    double mInner = MassOne + MassTwo;
+    double mTotal = mInner + MassThird;
+    double fLIn = MassOne * MassTwo / mInner * std::sqrt(innerMu() * Inner.SemiMajorAxis);
+    double fLOut = mInner * MassThird / mTotal * std::sqrt(outerMu() * Outer.SemiMajorAxis);
+    double fOutRate = fRate * fLIn / fLOut;
+
+    double fShape = 0.5 - 3.0 * glm::dot(eIn, eIn) + 12.5 * fEn * fEn - 2.5 * fJn * fJn;
+
+    dydt[2] = (fOutRate / fJOut) * (fJn * glm::cross(eOut, jIn) - 5.0 * fEn * glm::cross(eOut, eIn) - fShape * glm::cross(n, eOut));
+    dydt[3] = fOutRate * (fJn * glm::cross(n, jIn) - 5.0 * fEn * glm::cross(n, eIn));
+}
+
+void SecularTriple::evolve(double interval) {
+    if (interval <= 0.0) return;
+
+    glm::dvec3 y[4] = { Inner.Eccentricity, Inner.AngularMomentum, Outer.Eccentricity, Outer.AngularMomentum };
+    const double tSecular = getTimescale();
+
+    // Classical RK4; the step resolves the fastest phase of a Kozai cycle,
+    // which is the eccentricity peak where |j_in| is smallest
+    double t = 0.0;
+    while (t < interval) {
+        double h = 0.02 * tSecular * std::max(glm::length(y[1]), 1e-3);
+        h = std::min(h, interval - t);
+
+        glm::dvec3 k1[4], k2[4], k3[4], k4[4], tmp[4];
+        derivative(y, k1);
+        for (int c = 0; c < 4; ++c) tmp[c] = y[c] + 0.5 * h * k1[c];
+        derivative(tmp, k2);
+        for (int c = 0; c < 4; ++c) tmp[c] = y[c] + 0.5 * h * k2[c];
+        derivative(tmp, k3);
+        for (int c = 0; c < 4; ++c) tmp[c] = y[c] + h * k3[c];
+        derivative(tmp, k4);
+
+        for (int c = 0; c < 4; ++c) {
+            y[c] += (h / 6.0) * (k1[c] + 2.0 * k2[c] + 2.0 * k3[c] + k4[c]);
+        }
+
+        project(y[0], y[1]);
+        project(y[2], y[3]);
+        t += h;
+    }
+
+    Inner.Eccentricity = y[0];
+    Inner.AngularMomentum = y[1];
+    Outer.Eccentricity = y[2];
+    Outer.AngularMomentum = y[3];
+
+    // Orbital phases advance at the (fixed) mean motions
+    double aIn = Inner.SemiMajorAxis;
+    double aOut = Outer.SemiMajorAxis;
+    Inner.MeanAnomaly = std::remainder(Inner.MeanAnomaly + std::sqrt(innerMu() / (aIn * aIn * aIn)) * interval, 2.0 * PI);
+    Outer.MeanAnomaly = std::remainder(Outer.MeanAnomaly + std::sqrt(outerMu() / (aOut * aOut * aOut)) * interval, 2.0 * PI);
+
+    Time += interval;
+}
+
+void SecularTriple::write(SystemState& state) const {
+    double mInner = MassOne + MassTwo;
+    double mTotal = mInner + MassThird;
+
+    glm::dvec3 rIn, vIn, rOut, vOut;
+    Inner.toState(innerMu(), rIn, vIn);
+    Outer.toState(outerMu(), rOut, vOut);
+
+    glm::dvec3 vCentre = Centre + CentreVelocity * Time;
+    glm::dvec3 vInnerCentre = vCentre - (MassThird / mTotal) * rOut;
+    glm::dvec3 vInnerCentreVel = CentreVelocity - (MassThird / mTotal) * vOut;
+
+    state.Position[Third] = vCentre + (mInner / mTotal) * rOut;
+    state.Velocity[Third] = CentreVelocity + (mInner / mTotal) * vOut;
+    state.Position[InnerOne] = vInnerCentre - (MassTwo / mInner) * rIn;
+    state.Velocity[InnerOne] = vInnerCentreVel - (MassTwo / mInner) * vIn;
+    state.Position[InnerTwo] = vInnerCentre + (MassOne / mInner) * rIn;
+    state.Velocity[InnerTwo] = vInnerCentreVel + (MassOne / mInner) * vIn;
+}
@@ -0,0 +1,204 @@
+#include "Physics/sleeping.h"
+#include <algorithm>
+
+SleepIslands::SleepIslands() : NextIsland(0), Active(0) { }
+
+void SleepIslands::track(const std::vector<Body*>& bodies) {
+    if (bodies == Tracked) return;
+
+    Tracked = bodies;
+    RestTime.assign(bodies.size(), 0.0f);
+    Island.assign(bodies.size(), -1);
+    StaticForce.assign(bodies.size(), glm::dvec3(0.0));
+    SleepForce.assign(bodies.size(), glm::dvec3(0.0));
+    SleepPosition.assign(bodies.size(), glm::vec3(0.0f));
+
+    Active = 0;
+    for (Body* body : bodies) {
+        body->Sleeping = false;
+        if (!body->sphere.mesh.source) Active++;
+    }
+}
+
+void SleepIslands::wakeAll() {
+    Active = 0;
+    for (size_t i = 0; i < Tracked.size(); ++i) {
+        Tracked[i]->Sleeping = false;
+        Island[i] = -1;
+        RestTime[i] = 0.0f;
+        StaticForce[i] = glm::dvec3(0.0);
+        if (!Tracked[i]->sphere.mesh.source) Active++;
+    }
+}
+
+bool SleepIslands::allAsleep() const {
+    return !Tracked.empty() && Active == 0;
+}
+
+size_t SleepIslands::getSleeping() const {
+    size_t count = 0;
+    for (int island : Island) {
+        if (island >= 0) count++;
+    }
+    return count;
+}
+
+void SleepIslands::wake(size_t body, const PairForce& force) {
+    if (body < Island.size() && Island[body] >= 0) wakeIslands({ Island[body] }, force);
+}
+
+void SleepIslands::wakeIslands(std::vector<int> islands, const PairForce& force) {
+    std::sort(islands.begin(), islands.end());
+    islands.erase(std::unique(islands.begin(), islands.end()), islands.end());
+
+    auto waking = [&](size_t i) {
+        return Island[i] >= 0 && std::binary_search(islands.begin(), islands.end(), Island[i]);
+    };
+
+    std::vector<size_t> woken, sleeping;
+    for (size_t i = 0; i < Tracked.size(); ++i) {
+        if (waking(i)) {
+            woken.push_back(i);
+        } else if (Island[i] >= 0) {
+            sleeping.push_back(i);
+        }
+    }
+
+    // The woken bodies no longer belong to the static part of the others' force
+    for (size_t k : sleeping) {
+        for (size_t j : woken) {
+            StaticForce[k] -= glm::dvec3(force(*Tracked[k], *Tracked[j]));
+        }
+    }
+
+    for (size_t i : woken) {
+        Body* body = Tracked[i];
+        body->Sleeping = false;
+        body->vForceAccumulator = glm::vec3(0);
+        Island[i] = -1;
+        RestTime[i] = 0.0f;
+        StaticForce[i] = glm::dvec3(0.0);
+        Active++;
+    }
+}
+
+void SleepIslands::wakeChanged(const std::vector<Body*>& bodies, const PairForce& force) {
+    track(bodies);
+
+    std::vector<size_t> awake;
+    for (size_t j = 0; j < bodies.size(); ++j) {
+        if (Island[j] < 0 && !bodies[j]->sphere.mesh.source) awake.push_back(j);
+    }
+
+    std::vector<int> disturbed;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (Island[i] < 0) continue;
+        Body* body = bodies[i];
+
+        // Moved or pushed from outside
+        if (body->Position != SleepPosition[i] || body->Velocity != glm::vec3(0)) {
+            disturbed.push_back(Island[i]);
+            continue;
+        }
+
+        // Pull of the awake bodies on top of the frozen part
+        glm::dvec3 vForce = StaticForce[i];
+        for (size_t j : awake) {
+            vForce += glm::dvec3(force(*body, *bodies[j]));
+        }
+
+        double limit = WAKE_FORCE_FRACTION * glm::length(SleepForce[i]) + WAKE_ACCELERATION * body->Mass;
+        if (glm::length(vForce - SleepForce[i]) > limit) disturbed.push_back(Island[i]);
+    }
+
+    if (!disturbed.empty()) wakeIslands(disturbed, force);
+}
+
+void SleepIslands::update(const std::vector<Body*>& bodies, const std::vector<std::pair<uint32_t, uint32_t>>& touching, float step, const Support& supported, const PairForce& force) {
+    track(bodies);
+    const size_t n = bodies.size();
+
+    for (size_t i = 0; i < n; ++i) {
+        Body* body = bodies[i];
+        if (body->sphere.mesh.source || Island[i] >= 0) continue;
+
+        bool resting = glm::dot(body->Velocity, body->Velocity) < SLEEP_VELOCITY * SLEEP_VELOCITY;
+        RestTime[i] = resting ? RestTime[i] + step : 0.0f;
+    }
+
+    // Islands of touching awake bodies; touching a sleeper counts as support
+    std::vector<uint32_t> parent(n);
+    for (uint32_t i = 0; i < n; ++i) parent[i] = i;
+
+    auto root = [&parent](uint32_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+
+    std::vector<bool> supportedBody(n, false);
+    for (const auto& [i, j] : touching) {
+        bool sleepI = Island[i] >= 0, sleepJ = Island[j] >= 0;
+        if (sleepI && sleepJ) continue;
+        if (sleepI) { supportedBody[j] = true; continue; }
+        if (sleepJ) { supportedBody[i] = true; continue; }
+
+        parent[root(i)] = root(j);
+    }
+
+    std::vector<bool> settled(n, true), grounded(n, false);
+    for (uint32_t i = 0; i < n; ++i) {
+        if (bodies[i]->sphere.mesh.source || Island[i] >= 0) continue;
+
+        uint32_t r = root(i);
+        if (RestTime[i] < SLEEP_TIME) settled[r] = false;
+        if (supportedBody[i] || supported(*bodies[i])) grounded[r] = true;
+    }
+
+    std::vector<size_t> asleep, falling;
+    std::vector<int> islandOf(n, -1);
+    for (size_t i = 0; i < n; ++i) {
+        if (Island[i] >= 0) {
+            asleep.push_back(i);
+            continue;
+        }
+        if (bodies[i]->sphere.mesh.source) continue;
+
+        uint32_t r = root((uint32_t)i);
+        if (!settled[r] || !grounded[r]) continue;
+
+        if (islandOf[r] < 0) islandOf[r] = NextIsland++;
+        Island[i] = islandOf[r];
+        falling.push_back(i);
+    }
+    if (falling.empty()) return;
+
+    // The newcomers join the static part of every sleeper's force
+    for (size_t k : asleep) {
+        for (size_t j : falling) {
+            StaticForce[k] += glm::dvec3(force(*bodies[k], *bodies[j]));
+        }
+    }
+
+    for (size_t i : falling) {
+        Body* body = bodies[i];
+        glm::dvec3 vStatic(0.0), vTotal(0.0);
+        for (size_t j = 0; j < n; ++j) {
+            if (j == i || bodies[j]->sphere.mesh.source) continue;
+
+            glm::dvec3 vPull(force(*body, *bodies[j]));
+            vTotal += vPull;
+            if (Island[j] >= 0) vStatic += vPull;
+        }
+
+        StaticForce[i] = vStatic;
+        SleepForce[i] = vTotal;
+        SleepPosition[i] = body->Position;
+
+        body->Sleeping = true;
+        body->Velocity = glm::vec3(0);
+        body->Acceleration = glm::vec3(0);
+        body->Force = glm::vec3(0);
+        body->vForceAccumulator = glm::vec3(0);
+        Active--;
+    }
+}
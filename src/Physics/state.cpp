@@ -0,0 +1,171 @@
+#include "Physics/state.h"
+#include "Physics/physics.h"
+
+void SystemState::pack(std::vector<double>& y) const {
+    const size_t n = size();
+    y.resize(6 * n);
+
+    for (size_t i = 0; i < n; ++i) {
+        y[3 * i + 0] = Position[i].x;
+        y[3 * i + 1] = Position[i].y;
+        y[3 * i + 2] = Position[i].z;
+        y[3 * (n + i) + 0] = Velocity[i].x;
+        y[3 * (n + i) + 1] = Velocity[i].y;
+        y[3 * (n + i) + 2] = Velocity[i].z;
+    }
+}
+
+void SystemState::unpack(const std::vector<double>& y) {
+    const size_t n = size();
+
+    for (size_t i = 0; i < n; ++i) {
+        Position[i] = glm::dvec3(y[3 * i], y[3 * i + 1], y[3 * i + 2]);
+        Velocity[i] = glm::dvec3(y[3 * (n + i)], y[3 * (n + i) + 1], y[3 * (n + i) + 2]);
+    }
+}
+
+void computeAccelerations(const SystemState& state, std::vector<glm::dvec3>& acc) {
+    const size_t n = state.size();
+    acc.assign(n, glm::dvec3(0.0));
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            glm::dvec3 vDistance = state.Position[j] - state.Position[i];
+            double fDistSq = glm::dot(vDistance, vDistance);
+            double fInvDist3 = 1.0 / (fDistSq * glm::sqrt(fDistSq));
+
+            acc[i] += (GRAV_CONST * state.Mass[j] * fInvDist3) * vDistance;
+            acc[j] -= (GRAV_CONST * state.Mass[i] * fInvDist3) * vDistance;
+        }
+    }
+}
+
+void computeDerivative(const std::vector<double>& mass, const std::vector<double>& y, std::vector<double>& dydt) {
+    const size_t n = mass.size();
+    dydt.resize(y.size());
+
+    // Position derivative is simply the velocity half of the state
+    for (size_t k = 0; k < 3 * n; ++k) {
+        dydt[k] = y[3 * n + k];
+    }
+
+    double* acc = dydt.data() + 3 * n;
+    for (size_t k = 0; k < 3 * n; ++k) {
+        acc[k] = 0.0;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            double dx = y[3 * j + 0] - y[3 * i + 0];
+            double dy = y[3 * j + 1] - y[3 * i + 1];
+            double dz = y[3 * j + 2] - y[3 * i + 2];
+            double fDistSq = dx * dx + dy * dy + dz * dz;
+            double fInvDist3 = 1.0 / (fDistSq * glm::sqrt(fDistSq));
+
+            double fOne = GRAV_CONST * mass[j] * fInvDist3;
+            double fTwo = GRAV_CONST * mass[i] * fInvDist3;
+
+            acc[3 * i + 0] += fOne * dx;
+            acc[3 * i + 1] += fOne * dy;
+            acc[3 * i + 2] += fOne * dz;
+            acc[3 * j + 0] -= fTwo * dx;
+            acc[3 * j + 1] -= fTwo * dy;
+            acc[3 * j + 2] -= fTwo * dz;
+        }
+    }
+}
+
+void computeVariations(const SystemState& state, const std::vector<glm::dvec3>& dPos,
+                       std::vector<glm::dvec3>& acc, std::vector<glm::dvec3>& dAcc) {
+    const size_t n = state.size();
+    acc.assign(n, glm::dvec3(0.0));
+    dAcc.assign(n, glm::dvec3(0.0));
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            glm::dvec3 vDistance = state.Position[j] - state.Position[i];
+            glm::dvec3 vDelta = dPos[j] - dPos[i];
+            double fDistSq = glm::dot(vDistance, vDistance);
+            double fInvDist3 = 1.0 / (fDistSq * glm::sqrt(fDistSq));
+            double fProjection = 3.0 * glm::dot(vDistance, vDelta) / fDistSq;
+
+            glm::dvec3 vVariation = fInvDist3 * (vDelta - fProjection * vDistance);
+
+            acc[i] += (GRAV_CONST * state.Mass[j] * fInvDist3) * vDistance;
+            acc[j] -= (GRAV_CONST * state.Mass[i] * fInvDist3) * vDistance;
+            dAcc[i] += (GRAV_CONST * state.Mass[j]) * vVariation;
+            dAcc[j] -= (GRAV_CONST * state.Mass[i]) * vVariation;
+        }
+    }
+}
+
+void computeVariationalDerivative(const std::vector<double>& mass, const std::vector<double>& y, std::vector<double>& dydt) {
+    const size_t n = mass.size();
+    dydt.resize(y.size());
+
+    const double* pos = y.data();
+    const double* dPos = y.data() + 6 * n;
+    double* acc = dydt.data() + 3 * n;
+    double* dAcc = dydt.data() + 9 * n;
+
+    // Position derivatives are the velocity halves of state and tangent
+    for (size_t k = 0; k < 3 * n; ++k) {
+        dydt[k] = y[3 * n + k];
+        dydt[6 * n + k] = y[9 * n + k];
+        acc[k] = 0.0;
+        dAcc[k] = 0.0;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            double dx = pos[3 * j + 0] - pos[3 * i + 0];
+            double dy = pos[3 * j + 1] - pos[3 * i + 1];
+            double dz = pos[3 * j + 2] - pos[3 * i + 2];
+            double ddx = dPos[3 * j + 0] - dPos[3 * i + 0];
+            double ddy = dPos[3 * j + 1] - dPos[3 * i + 1];
+            double ddz = dPos[3 * j + 2] - dPos[3 * i + 2];
+
+            double fDistSq = dx * dx + dy * dy + dz * dz;
+            double fInvDist3 = 1.0 / (fDistSq * glm::sqrt(fDistSq));
+            double fProjection = 3.0 * (dx * ddx + dy * ddy + dz * ddz) / fDistSq;
+
+            double fOne = GRAV_CONST * mass[j] * fInvDist3;
+            double fTwo = GRAV_CONST * mass[i] * fInvDist3;
+
+            double vx = ddx - fProjection * dx;
+            double vy = ddy - fProjection * dy;
+            double vz = ddz - fProjection * dz;
+
+            acc[3 * i + 0] += fOne * dx;
+            acc[3 * i + 1] += fOne * dy;
+            acc[3 * i + 2] += fOne * dz;
+            acc[3 * j + 0] -= fTwo * dx;
+            acc[3 * j + 1] -= fTwo * dy;
+            acc[3 * j + 2] -= fTwo * dz;
+
+            dAcc[3 * i + 0] += fOne * vx;
+            dAcc[3 * i + 1] += fOne * vy;
+            dAcc[3 * i + 2] += fOne * vz;
+            dAcc[3 * j + 0] -= fTwo * vx;
+            dAcc[3 * j + 1] -= fTwo * vy;
+            dAcc[3 * j + 2] -= fTwo * vz;
+        }
+    }
+}
+
+double totalEnergy(const SystemState& state) {
+    const size_t n = state.size();
+    double kinetic = 0.0;
+    double potential = 0.0;
+
+    for (size_t i = 0; i < n; ++i) {
+        kinetic += 0.5 * state.Mass[i] * glm::dot(state.Velocity[i], state.Velocity[i]);
+
+        for (size_t j = i + 1; j < n; ++j) {
+            double fDistance = glm::length(state.Position[j] - state.Position[i]);
+            potential -= GRAV_CONST * state.Mass[i] * state.Mass[j] / fDistance;
+        }
+    }
+
+    return kinetic + potential;
+}
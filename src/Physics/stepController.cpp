@@ -0,0 +1,70 @@
+#include "Physics/stepController.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <limits>
+
+StepController::StepController() : Eta(0.02), MinStep(1e-5), MaxStep(1.0 / 60.0), Step(0.0) { }
+
+StepController::StepController(double minStep, double maxStep) : Eta(0.02), MinStep(minStep), MaxStep(maxStep), Step(0.0) { }
+
+void StepController::setBounds(double minStep, double maxStep) {
+    MinStep = minStep;
+    MaxStep = maxStep;
+}
+
+void StepController::setAccuracy(double eta) {
+    Eta = eta;
+}
+
+void StepController::reset() {
+    Step = 0.0;
+}
+
+double StepController::suggest(const std::vector<Body*>& bodies, const PairFilter& exclude) {
+    const size_t n = bodies.size();
+    std::vector<glm::dvec3> acc(n, glm::dvec3(0.0));
+    std::vector<glm::dvec3> jerk(n, glm::dvec3(0.0));
+
+    // Acceleration and analytic jerk of every non-source body
+    for (size_t i = 0; i < n; ++i) {
+        Body* one = bodies[i];
+        if (one->sphere.mesh.source) continue;
+
+        for (size_t j = i + 1; j < n; ++j) {
+            Body* two = bodies[j];
+            if (two->sphere.mesh.source) continue;
+            if (exclude && exclude(*one, *two)) continue;
+
+            glm::dvec3 r = glm::dvec3(two->Position) - glm::dvec3(one->Position);
+            glm::dvec3 v = glm::dvec3(two->Velocity) - glm::dvec3(one->Velocity);
+            double fDistSq = glm::dot(r, r);
+            if (fDistSq == 0.0) continue;
+
+            double fInvDist3 = 1.0 / (fDistSq * glm::sqrt(fDistSq));
+            double rv = glm::dot(r, v) / fDistSq;
+
+            glm::dvec3 a = fInvDist3 * r;
+            glm::dvec3 da = fInvDist3 * (v - 3.0 * rv * r);
+
+            acc[i] += (GRAV_CONST * two->Mass) * a;
+            acc[j] -= (GRAV_CONST * one->Mass) * a;
+            jerk[i] += (GRAV_CONST * two->Mass) * da;
+            jerk[j] -= (GRAV_CONST * one->Mass) * da;
+        }
+    }
+
+    double h = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < n; ++i) {
+        double fJerk = glm::length(jerk[i]);
+        if (fJerk > 0.0) {
+            h = std::min(h, Eta * glm::length(acc[i]) / fJerk);
+        }
+    }
+
+    // Grow gradually, shrink immediately
+    if (Step > 0.0) h = std::min(h, 2.0 * Step);
+    h = std::clamp(h, MinStep, MaxStep);
+
+    Step = h;
+    return h;
+}
@@ -0,0 +1,335 @@
+#include "Physics/taylor.h"
+#include "Physics/physics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TaylorIntegrator::TaylorIntegrator() : Expansions(0), ValidStep(0.0), HasSeries(false) {
+    setTolerance(1e-12);
+}
+
+TaylorIntegrator::TaylorIntegrator(double tolerance) : Expansions(0), ValidStep(0.0), HasSeries(false) {
+    setTolerance(tolerance);
+}
+
+void TaylorIntegrator::setTolerance(double tolerance) {
+    Tolerance = tolerance;
+
+    // Jorba & Zou: the order minimising work per unit time is about -½ ln ε + 1.
+    // Only the order reported before the first step; expand() picks its own
+    double order = std::ceil(-0.5 * std::log(tolerance)) + 1.0;
+    Order = (unsigned)std::clamp(order, double(TAYLOR_MIN_ORDER), double(TAYLOR_MAX_ORDER));
+}
+
+double TaylorIntegrator::getStepStart() const {
+    return Start.Time;
+}
+
+double TaylorIntegrator::getStepEnd() const {
+    return Start.Time + ValidStep;
+}
+
+unsigned TaylorIntegrator::getOrder() const {
+    return Order;
+}
+
+unsigned long TaylorIntegrator::getExpansions() const {
+    return Expansions;
+}
+
+bool TaylorIntegrator::integrate(SystemState& state, double interval) {
+    // Advanced on a copy, so a failed step leaves the state as it was
+    SystemState current = state;
+    double remaining = interval;
+
+    while (remaining > 0.0) {
+        if (!expand(current, nullptr, nullptr)) return false;
+        double h = ValidStep;
+
+        bool last = h >= remaining;
+        double taken = last ? remaining : h;
+
+        sum(taken, current);
+        current.Time = Start.Time + taken;
+        remaining = last ? 0.0 : remaining - taken;
+    }
+
+    state = current;
+    return true;
+}
+
+bool TaylorIntegrator::integrate(SystemState& state, double interval, std::vector<glm::dvec3>& tangentPosition, std::vector<glm::dvec3>& tangentVelocity) {
+    SystemState current = state;
+    std::vector<glm::dvec3> position = tangentPosition, velocity = tangentVelocity;
+    double remaining = interval;
+
+    while (remaining > 0.0) {
+        if (!expand(current, &position, &velocity)) return false;
+        double h = ValidStep;
+
+        bool last = h >= remaining;
+        double taken = last ? remaining : h;
+
+        sum(taken, current);
+        sumTangent(taken, position, velocity);
+        current.Time = Start.Time + taken;
+        remaining = last ? 0.0 : remaining - taken;
+    }
+
+    state = current;
+    tangentPosition = position;
+    tangentVelocity = velocity;
+    return true;
+}
+
+double TaylorIntegrator::step(SystemState& state) {
+    if (!expand(state, nullptr, nullptr)) return 0.0;
+    double h = ValidStep;
+
+    sum(h, state);
+    state.Time = Start.Time + h;
+    return h;
+}
+
+bool TaylorIntegrator::evaluate(double t, SystemState& out) const {
+    if (!HasSeries) return false;
+
+    double h = t - Start.Time;
+    double slack = 1e-12 * std::max(1.0, std::abs(Start.Time));
+    if (h < -slack || h > ValidStep + slack) return false;
+
+    out = Start;
+    sum(h, out);
+    out.Time = t;
+    return true;
+}
+
+bool TaylorIntegrator::expand(const SystemState& state, const std::vector<glm::dvec3>* tangentPosition, const std::vector<glm::dvec3>* tangentVelocity) {
+    const size_t n = state.size();
+    const size_t pairs = n * (n - 1) / 2;
+    const size_t stride = TAYLOR_MAX_ORDER + 1;
+    const double alpha = -1.5;
+    const bool tangent = tangentPosition && tangentVelocity;
+
+    X.resize(TAYLOR_MAX_ORDER + 1);
+    V.resize(TAYLOR_MAX_ORDER + 1);
+    D.assign(pairs * stride, glm::dvec3(0.0));
+    S.assign(pairs * stride, 0.0);
+    Q.assign(pairs * stride, 0.0);
+
+    X[0] = state.Position;
+    V[0] = state.Velocity;
+
+    std::vector<glm::dvec3> acc(n);
+    std::vector<glm::dvec3> dAcc;
+    if (tangent) {
+        DX.resize(TAYLOR_MAX_ORDER + 1);
+        DV.resize(TAYLOR_MAX_ORDER + 1);
+        DD.assign(pairs * stride, glm::dvec3(0.0));
+        DS.assign(pairs * stride, 0.0);
+        W.assign(pairs * stride, 0.0);
+        DQ.assign(pairs * stride, 0.0);
+        DX[0] = *tangentPosition;
+        DV[0] = *tangentVelocity;
+        dAcc.resize(n);
+    }
+
+    // Order with the least work per unit time so far. The coefficients of order
+    // k cost O(k) per pair on top of a fixed overhead, so a series of order p
+    // costs about (p + 4)² for the step its last coefficients allow
+    unsigned best = 0;
+    double bestStep = 0.0;
+    double bestWork = std::numeric_limits<double>::max();
+
+    for (unsigned k = 0; k < TAYLOR_MAX_ORDER; ++k) {
+        std::fill(acc.begin(), acc.end(), glm::dvec3(0.0));
+        std::fill(dAcc.begin(), dAcc.end(), glm::dvec3(0.0));
+
+        size_t pair = 0;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j, ++pair) {
+                glm::dvec3* d = &D[pair * stride];
+                double* s = &S[pair * stride];
+                double* q = &Q[pair * stride];
+
+                d[k] = X[k][j] - X[k][i];
+
+                // s = d·d (Cauchy product)
+                double sk = 0.0;
+                for (unsigned l = 0; l <= k; ++l) {
+                    sk += glm::dot(d[l], d[k - l]);
+                }
+                s[k] = sk;
+
+                // q = s^α (power recurrence)
+                if (k == 0) {
+                    q[0] = std::pow(s[0], alpha);
+                } else {
+                    double qk = 0.0;
+                    for (unsigned l = 0; l < k; ++l) {
+                        qk += (alpha * (k - l) - l) * s[k - l] * q[l];
+                    }
+                    q[k] = qk / (k * s[0]);
+                }
+
+                // a = d q (Cauchy product)
+                glm::dvec3 a(0.0);
+                for (unsigned l = 0; l <= k; ++l) {
+                    a += d[l] * q[k - l];
+                }
+
+                acc[i] += (GRAV_CONST * state.Mass[j]) * a;
+                acc[j] -= (GRAV_CONST * state.Mass[i]) * a;
+
+                if (!tangent) continue;
+
+                // Variation of a = d q: δa = δd q + d δq, with δq = α s^(α-1) δs
+                // and δs = 2 d·δd, all as series in the same way
+                glm::dvec3* dd = &DD[pair * stride];
+                double* ds = &DS[pair * stride];
+                double* w = &W[pair * stride];
+                double* dq = &DQ[pair * stride];
+
+                dd[k] = DX[k][j] - DX[k][i];
+
+                double dsk = 0.0;
+                for (unsigned l = 0; l <= k; ++l) {
+                    dsk += glm::dot(d[l], dd[k - l]);
+                }
+                ds[k] = 2.0 * dsk;
+
+                // w = s^(α-1)
+                if (k == 0) {
+                    w[0] = q[0] / s[0];
+                } else {
+                    double wk = 0.0;
+                    for (unsigned l = 0; l < k; ++l) {
+                        wk += ((alpha - 1.0) * (k - l) - l) * s[k - l] * w[l];
+                    }
+                    w[k] = wk / (k * s[0]);
+                }
+
+                double dqk = 0.0;
+                for (unsigned l = 0; l <= k; ++l) {
+                    dqk += w[l] * ds[k - l];
+                }
+                dq[k] = alpha * dqk;
+
+                glm::dvec3 da(0.0);
+                for (unsigned l = 0; l <= k; ++l) {
+                    da += dd[l] * q[k - l] + d[l] * dq[k - l];
+                }
+
+                dAcc[i] += (GRAV_CONST * state.Mass[j]) * da;
+                dAcc[j] -= (GRAV_CONST * state.Mass[i]) * da;
+            }
+        }
+
+        X[k + 1].resize(n);
+        V[k + 1].resize(n);
+        for (size_t b = 0; b < n; ++b) {
+            X[k + 1][b] = V[k][b] / double(k + 1);
+            V[k + 1][b] = acc[b] / double(k + 1);
+        }
+        if (tangent) {
+            DX[k + 1].resize(n);
+            DV[k + 1].resize(n);
+            for (size_t b = 0; b < n; ++b) {
+                DX[k + 1][b] = DV[k][b] / double(k + 1);
+                DV[k + 1][b] = dAcc[b] / double(k + 1);
+            }
+        }
+
+        const unsigned p = k + 1;
+        if (p < TAYLOR_MIN_ORDER) continue;
+
+        double h = naturalStep(p);
+        double work = (double(p) + 4.0) * (double(p) + 4.0) / h;
+        if (work < bestWork) {
+            best = p;
+            bestStep = h;
+            bestWork = work;
+        } else {
+            // The coefficients have stopped decaying faster than the extra
+            // terms cost
+            break;
+        }
+    }
+
+    Expansions++;
+
+    // Coincident bodies (s₀ = 0) or an overflowing separation make the
+    // coefficients non-finite, and with them the step: no usable series
+    if (best == 0 || !std::isfinite(bestStep) || bestStep <= 0.0) {
+        HasSeries = false;
+        ValidStep = 0.0;
+        return false;
+    }
+
+    Start = state;
+    HasSeries = true;
+
+    Order = best;
+    ValidStep = bestStep;
+    return true;
+}
+
+double TaylorIntegrator::naturalStep(unsigned p) const {
+    // Infinite for a non-finite coefficient, which std::max would skip over as NaN
+    auto norm = [](const std::vector<glm::dvec3>& c) {
+        double m = 0.0;
+        for (const glm::dvec3& v : c) {
+            if (!std::isfinite(v.x + v.y + v.z)) return std::numeric_limits<double>::infinity();
+            m = std::max({m, std::abs(v.x), std::abs(v.y), std::abs(v.z)});
+        }
+        return m;
+    };
+
+    // Relative control for large states, absolute near zero
+    double scale = std::max({1.0, norm(X[0]), norm(V[0])});
+    double eps = Tolerance * scale;
+
+    double h = std::numeric_limits<double>::max();
+    double last = std::max(norm(X[p - 1]), norm(V[p - 1]));
+    double final = std::max(norm(X[p]), norm(V[p]));
+    if (!std::isfinite(scale) || !std::isfinite(last) || !std::isfinite(final)) return 0.0;
+
+    if (last > 0.0) h = std::min(h, std::pow(eps / last, 1.0 / (p - 1)));
+    if (final > 0.0) h = std::min(h, std::pow(eps / final, 1.0 / p));
+
+    // Jorba & Zou safety factor
+    return h * std::exp(-0.7 / (p - 1));
+}
+
+void TaylorIntegrator::sum(double h, SystemState& out) const {
+    const size_t n = Start.size();
+    const unsigned p = Order;
+
+    // Horner evaluation of both series
+    for (size_t b = 0; b < n; ++b) {
+        glm::dvec3 x = X[p][b];
+        glm::dvec3 v = V[p][b];
+        for (int k = int(p) - 1; k >= 0; --k) {
+            x = x * h + X[k][b];
+            v = v * h + V[k][b];
+        }
+        out.Position[b] = x;
+        out.Velocity[b] = v;
+    }
+}
+
+void TaylorIntegrator::sumTangent(double h, std::vector<glm::dvec3>& tangentPosition, std::vector<glm::dvec3>& tangentVelocity) const {
+    const size_t n = tangentPosition.size();
+    const unsigned p = Order;
+
+    for (size_t b = 0; b < n; ++b) {
+        glm::dvec3 x = DX[p][b];
+        glm::dvec3 v = DV[p][b];
+        for (int k = int(p) - 1; k >= 0; --k) {
+            x = x * h + DX[k][b];
+            v = v * h + DV[k][b];
+        }
+        tangentPosition[b] = x;
+        tangentVelocity[b] = v;
+    }
+}
@@ -0,0 +1,152 @@
+#include "Physics/variational.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+ChaosIndicator::ChaosIndicator() : Integrator(1e-12), Time(0.0), Growth(0.0), Weighted(0.0), Mean(0.0), LastY(0.0) { }
+
+ChaosIndicator::ChaosIndicator(double tolerance) : Integrator(tolerance), Time(0.0), Growth(0.0), Weighted(0.0), Mean(0.0), LastY(0.0) { }
+
+void ChaosIndicator::setTolerance(double tolerance) {
+    Integrator.setTolerance(tolerance);
+}
+
+void ChaosIndicator::reset(size_t bodies, unsigned seed) {
+    std::mt19937 generator(seed);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    TangentPosition.resize(bodies);
+    TangentVelocity.resize(bodies);
+
+    // Isotropic random direction in the 6N dimensional tangent space
+    double fNormSq = 0.0;
+    for (size_t i = 0; i < bodies; ++i) {
+        TangentPosition[i] = glm::dvec3(normal(generator), normal(generator), normal(generator));
+        TangentVelocity[i] = glm::dvec3(normal(generator), normal(generator), normal(generator));
+        fNormSq += glm::dot(TangentPosition[i], TangentPosition[i]) + glm::dot(TangentVelocity[i], TangentVelocity[i]);
+    }
+
+    double fScale = fNormSq > 0.0 ? 1.0 / std::sqrt(fNormSq) : 0.0;
+    for (size_t i = 0; i < bodies; ++i) {
+        TangentPosition[i] *= fScale;
+        TangentVelocity[i] *= fScale;
+    }
+
+    Time = Growth = Weighted = Mean = LastY = 0.0;
+    Integrator.reset();
+}
+
+size_t ChaosIndicator::size() const {
+    return TangentPosition.size();
+}
+
+bool ChaosIndicator::integrate(SystemState& state, double interval, double sample) {
+    if (sample <= 0.0 || sample > interval) sample = interval;
+
+    double t = 0.0;
+    while (t < interval) {
+        double h = std::min(sample, interval - t);
+        if (!propagate(state, h, Integrator)) return false;
+        t += h;
+    }
+    return true;
+}
+
+bool ChaosIndicator::propagate(SystemState& state, double interval, BulirschStoer& integrator) {
+    const size_t n = state.size();
+    if (n == 0 || interval <= 0.0) return true;
+    if (size() != n) reset(n);
+
+    // y = [r, v, δr, δv]
+    std::vector<double> y;
+    state.pack(y);
+    y.resize(12 * n);
+    for (size_t i = 0; i < n; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            y[3 * (2 * n + i) + c] = TangentPosition[i][c];
+            y[3 * (3 * n + i) + c] = TangentVelocity[i][c];
+        }
+    }
+
+    const std::vector<double>& mass = state.Mass;
+    bool done = integrator.integrate([&mass](const std::vector<double>& yIn, std::vector<double>& dydt) {
+        computeVariationalDerivative(mass, yIn, dydt);
+    }, y, interval);
+    if (!done) return false;
+
+    for (size_t i = 0; i < n; ++i) {
+        TangentPosition[i] = glm::dvec3(y[3 * (2 * n + i)], y[3 * (2 * n + i) + 1], y[3 * (2 * n + i) + 2]);
+        TangentVelocity[i] = glm::dvec3(y[3 * (3 * n + i)], y[3 * (3 * n + i) + 1], y[3 * (3 * n + i) + 2]);
+    }
+    y.resize(6 * n);
+    state.unpack(y);
+    state.Time += interval;
+
+    record(interval);
+    return true;
+}
+
+bool ChaosIndicator::propagate(SystemState& state, double interval, TaylorIntegrator& integrator) {
+    const size_t n = state.size();
+    if (n == 0 || interval <= 0.0) return true;
+    if (size() != n) reset(n);
+
+    if (!integrator.integrate(state, interval, TangentPosition, TangentVelocity)) return false;
+
+    record(interval);
+    return true;
+}
+
+void ChaosIndicator::eulerStep(const SystemState& start, double h) {
+    const size_t n = start.size();
+    if (n == 0 || h <= 0.0) return;
+    if (size() != n) reset(n);
+
+    std::vector<glm::dvec3> acc, dAcc;
+    computeVariations(start, TangentPosition, acc, dAcc);
+
+    for (size_t i = 0; i < n; ++i) {
+        TangentVelocity[i] += dAcc[i] * h;
+        TangentPosition[i] += TangentVelocity[i] * h;
+    }
+
+    record(h);
+}
+
+void ChaosIndicator::record(double interval) {
+    double fNormSq = 0.0;
+    for (size_t i = 0; i < size(); ++i) {
+        fNormSq += glm::dot(TangentPosition[i], TangentPosition[i]) + glm::dot(TangentVelocity[i], TangentVelocity[i]);
+    }
+    if (!(fNormSq > 0.0) || !std::isfinite(fNormSq)) return;
+
+    // The tangent had unit length at the start of the step
+    double fLog = 0.5 * std::log(fNormSq);
+
+    // ∫ s d ln|δ| with the midpoint time of the step (second order)
+    Growth += fLog;
+    Weighted += (Time + 0.5 * interval) * fLog;
+    Time += interval;
+
+    double Y = 2.0 * Weighted / Time;
+    Mean += 0.5 * (LastY + Y) * interval;
+    LastY = Y;
+
+    double fScale = 1.0 / std::sqrt(fNormSq);
+    for (size_t i = 0; i < size(); ++i) {
+        TangentPosition[i] *= fScale;
+        TangentVelocity[i] *= fScale;
+    }
+}
+
+double ChaosIndicator::getMegno() const {
+    return Time > 0.0 ? Mean / Time : 0.0;
+}
+
+double ChaosIndicator::getLyapunov() const {
+    return Time > 0.0 ? Growth / Time : 0.0;
+}
+
+double ChaosIndicator::getTime() const {
+    return Time;
+}
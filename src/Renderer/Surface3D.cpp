@@ -38,6 +38,18 @@ const int Surface3D::getIndexCount() {
     return Indices.size();
 }
 
+float Surface3D::getDistance() const {
+    return Distance;
+}
+
+float Surface3D::getSize() const {
+    return Size;
+}
+
+surfaceOrientation Surface3D::getOrientation() const {
+    return Orientation;
+}
+
 // Setter functions
 void Surface3D::setWireframe(bool wf) {
     Wireframe = wf;
@@ -38,6 +38,20 @@ void Renderer::drawSphere(Body& body) {
     if (body.sphere.mesh.source) lightSphere = &body; // remember light source sphere
 }
 
+// Unregister a sphere (merged away) and free its buffers
+void Renderer::removeSphere(Body& body) {
+    spheres.erase(std::remove(spheres.begin(), spheres.end(), &(body.sphere)), spheres.end());
+    if (lightSphere == &body) lightSphere = nullptr;
+
+    Mesh& mesh = body.sphere.mesh;
+    if (mesh.VAO != 0) {
+        glDeleteVertexArrays(1, &mesh.VAO);
+        glDeleteBuffers(1, &mesh.VBO);
+        glDeleteBuffers(1, &mesh.EBO);
+        mesh.VAO = mesh.VBO = mesh.EBO = 0;
+    }
+}
+
 void Renderer::drawSurface(Surface& surface) {
     baseSurface = &surface;
     setupSurfaceVertexBuffer(surface);
@@ -79,6 +93,7 @@ void Renderer::RenderFrame(std::vector<Body*> bodies) {
 
     // Draw all spheres
     for(Body* body : bodies) {
+        setupSphereVertexBuffer(body->sphere);  // re-uploads only if the radius changed (merger)
         glm::mat4 model = glm::translate(glm::mat4(1.0f), body->Position);
         ourShader.setBool("source", body->sphere.mesh.source);
         ourShader.setBool("inactive", body->sphere.mesh.inactive);
@@ -0,0 +1,239 @@
+/**
+ * @file cluster.cpp
+ * @author DotBox
+ * @brief MPI driver for large-N runs: a Plummer cluster (or a scenario) spread over the ranks
+ *
+ * Runs a DistributedSystem (see distributed.h) on every rank of
+ * MPI_COMM_WORLD. The bodies come either from a scenario file, read by rank
+ * 0 and spread by the first decomposition, or from a Plummer sphere that
+ * every rank samples its share of. Each body is drawn from a hash of the seed
+ * and its index, so the scene does not depend on the number of ranks.
+ *
+ * Usage:
+ *   mpirun -np <ranks> ThreeBodyMPI [--bodies N] [--scenario file] [--steps S] [--step dt]
+ *                                   [--mass M] [--scale a] [--radius r] [--seed s]
+ *                                   [--theta θ] [--softening ε] [--imbalance x]
+ *                                   [--threads T] [--every K] [--output prefix]
+ *
+ * Rank 0 prints the energy drift, contacts, load imbalance and exchange
+ * volumes every K steps. With --output every rank writes its bodies at the
+ * end to <prefix>-<rank>.csv.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include "Physics/distributed.h"
+#include "Physics/physics.h"
+#include "scenario.h"
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+// Draw k of body i, uniform in [0, 1)
+static double uniform(uint64_t seed, uint64_t i, uint64_t k) {
+    return (double)(splitmix64(seed ^ splitmix64(i * 64 + k)) >> 11) * 0x1.0p-53;
+}
+
+static glm::dvec3 direction(uint64_t seed, uint64_t i, uint64_t k) {
+    double z = 2.0 * uniform(seed, i, k) - 1.0;
+    double phi = 2.0 * M_PI * uniform(seed, i, k + 1);
+    double s = std::sqrt(1.0 - z * z);
+    return glm::dvec3(s * std::cos(phi), s * std::sin(phi), z);
+}
+
+// Body i of a Plummer sphere of total mass M and scale a (Aarseth, Hénon & Wielen 1974)
+static Particle plummer(uint64_t seed, uint64_t i, uint64_t bodies, double mass, double scale, double radius) {
+    // Radius from the cumulative mass, leaving out the outermost 0.1% of it
+    double m = 0.999 * uniform(seed, i, 0);
+    double r = scale / std::sqrt(std::pow(std::max(m, 1e-300), -2.0 / 3.0) - 1.0);
+
+    // Speed as a fraction q of the local escape speed, from g(q) = q² (1 - q²)^3.5 by rejection
+    double q = 0.0;
+    for (uint64_t k = 5; ; k += 2) {
+        q = uniform(seed, i, k);
+        if (0.1 * uniform(seed, i, k + 1) < q * q * std::pow(1.0 - q * q, 3.5)) break;
+    }
+    double escape = std::sqrt(2.0 * GRAV_CONST * mass / std::sqrt(r * r + scale * scale));
+
+    Particle particle = {};
+    particle.Position = r * direction(seed, i, 1);
+    particle.Velocity = q * escape * direction(seed, i, 3);
+    particle.Mass = mass / (double)bodies;
+    particle.Radius = radius;
+    particle.Id = i;
+    return particle;
+}
+
+static void usage() {
+    std::cerr << "usage: ThreeBodyMPI [--bodies N] [--scenario file] [--steps S] [--step dt] [--mass M] [--scale a]\n"
+                 "                    [--radius r] [--seed s] [--theta t] [--softening e] [--imbalance x]\n"
+                 "                    [--threads T] [--every K] [--output prefix]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+    int rank, ranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &ranks);
+
+    uint64_t bodies = 100000, seed = 1;
+    long steps = -1, every = 10;
+    double step = -1.0, mass = 1e12, scale = 100.0, radius = 0.1;
+    double theta = OCTREE_THETA, softening = 1.0, imbalance = DISTRIBUTED_IMBALANCE;
+    unsigned threads = 1;
+    std::string scenarioPath, output;
+
+    for (int a = 1; a < argc; ++a) {
+        bool value = a + 1 < argc;
+        if (!std::strcmp(argv[a], "--bodies") && value) bodies = std::strtoull(argv[++a], nullptr, 10);
+        else if (!std::strcmp(argv[a], "--scenario") && value) scenarioPath = argv[++a];
+        else if (!std::strcmp(argv[a], "--steps") && value) steps = std::atol(argv[++a]);
+        else if (!std::strcmp(argv[a], "--step") && value) step = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--mass") && value) mass = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--scale") && value) scale = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--radius") && value) radius = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--seed") && value) seed = std::strtoull(argv[++a], nullptr, 10);
+        else if (!std::strcmp(argv[a], "--theta") && value) theta = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--softening") && value) softening = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--imbalance") && value) imbalance = std::atof(argv[++a]);
+        else if (!std::strcmp(argv[a], "--threads") && value) threads = (unsigned)std::atoi(argv[++a]);
+        else if (!std::strcmp(argv[a], "--every") && value) every = std::max(1L, std::atol(argv[++a]));
+        else if (!std::strcmp(argv[a], "--output") && value) output = argv[++a];
+        else {
+            if (rank == 0) usage();
+            MPI_Finalize();
+            return 1;
+        }
+    }
+
+    int status = 0;
+    {
+        DistributedSystem system(MPI_COMM_WORLD);
+        std::vector<Particle>& particles = system.getParticles();
+
+        if (!scenarioPath.empty()) {
+            // Rank 0 reads the bodies; the first decomposition spreads them. Only
+            // the bodies, step and steps of the scenario apply here
+            double scenarioStep = 0.0;
+            long scenarioSteps = 0;
+            if (rank == 0) {
+                try {
+                    Scenario scenario = loadScenario(scenarioPath);
+                    for (const Body& body : scenario.Bodies) {
+                        if (body.sphere.mesh.source) continue;
+                        Particle particle = {};
+                        particle.Position = glm::dvec3(body.Position);
+                        particle.Velocity = glm::dvec3(body.Velocity);
+                        particle.Mass = body.Mass;
+                        particle.Radius = body.sphere.geometry.getRadius();
+                        particle.Id = particles.size();
+                        particles.push_back(particle);
+                    }
+                    scenarioStep = scenario.Step;
+                    scenarioSteps = scenario.Steps;
+                } catch (const std::exception& error) {
+                    std::cerr << scenarioPath << ": " << error.what() << std::endl;
+                    status = 1;
+                }
+            }
+            MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            MPI_Bcast(&scenarioStep, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            MPI_Bcast(&scenarioSteps, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+            if (step <= 0.0) step = scenarioStep;
+            if (steps < 0) steps = scenarioSteps;
+        } else {
+            const uint64_t first = bodies * (uint64_t)rank / (uint64_t)ranks;
+            const uint64_t last = bodies * (uint64_t)(rank + 1) / (uint64_t)ranks;
+            particles.reserve(last - first);
+            for (uint64_t i = first; i < last; ++i) {
+                particles.push_back(plummer(seed, i, bodies, mass, scale, radius));
+            }
+        }
+
+        if (status == 0) {
+            if (step <= 0.0) step = 1.0;
+            if (steps < 0) steps = 100;
+            system.setStep(step);
+            system.setTheta(theta);
+            system.setSoftening(softening);
+            system.setImbalance(imbalance);
+            system.setThreads(threads);
+
+            auto start = std::chrono::steady_clock::now();
+            system.initialize();
+
+            double kinetic, potential, energyStart;
+            glm::dvec3 momentum;
+            system.totals(kinetic, potential, momentum);
+            energyStart = kinetic + potential;
+
+            if (rank == 0) {
+                std::cout << system.getStats().Bodies << " bodies on " << ranks << " ranks, step " << step << " s\n"
+                          << std::setw(8) << "step" << std::setw(12) << "time" << std::setw(14) << "energy"
+                          << std::setw(13) << "drift" << std::setw(10) << "contacts" << std::setw(11) << "imbalance"
+                          << std::setw(11) << "rebalances" << std::setw(10) << "migrated" << std::setw(11) << "imported"
+                          << std::setw(9) << "ghosts" << std::setw(12) << "ms/step" << std::endl;
+            }
+
+            auto last = std::chrono::steady_clock::now();
+            for (long s = 1; s <= steps; ++s) {
+                system.step();
+                if (s % every != 0 && s != steps) continue;
+
+                system.totals(kinetic, potential, momentum);
+                const double energy = kinetic + potential;
+                const long batch = s % every != 0 ? s % every : every;
+                auto now = std::chrono::steady_clock::now();
+                const double ms = 1000.0 * std::chrono::duration<double>(now - last).count() / (double)batch;
+                last = now;
+
+                if (rank == 0) {
+                    const DistributedStats& stats = system.getStats();
+                    std::cout << std::setprecision(6) << std::setw(8) << s << std::setw(12) << system.getTime()
+                              << std::setw(14) << energy
+                              << std::setw(13) << (energyStart != 0.0 ? (energy - energyStart) / std::abs(energyStart) : 0.0)
+                              << std::setw(10) << stats.Contacts << std::setw(11) << stats.Imbalance
+                              << std::setw(11) << stats.Rebalances << std::setw(10) << stats.Migrated
+                              << std::setw(11) << stats.Imported << std::setw(9) << stats.Ghosts
+                              << std::setw(12) << ms << std::endl;
+                }
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (rank == 0) std::cout << "wall time " << seconds << " s, momentum " << glm::length(momentum) << std::endl;
+
+            if (!output.empty()) {
+                std::ofstream out(output + "-" + std::to_string(rank) + ".csv");
+                out << std::setprecision(12) << "id,x,y,z,vx,vy,vz,mass\n";
+                for (const Particle& p : particles) {
+                    out << p.Id << ',' << p.Position.x << ',' << p.Position.y << ',' << p.Position.z << ','
+                        << p.Velocity.x << ',' << p.Velocity.y << ',' << p.Velocity.z << ',' << p.Mass << '\n';
+                }
+                if (!out) {
+                    std::cerr << "rank " << rank << ": cannot write " << output << "-" << rank << ".csv" << std::endl;
+                    status = 1;
+                }
+            }
+        }
+    }
+
+    MPI_Finalize();
+    return status;
+}
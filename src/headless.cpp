@@ -0,0 +1,210 @@
+/**
+ * @file headless.cpp
+ * @author DotBox
+ * @brief Headless simulation driver: scenario in, trajectory and diagnostics out
+ *
+ * Runs the physics engine without a window, OpenGL context or frame clock,
+ * so it can be used on machines without a display (batch servers, CI). The
+ * scene is read from a scenario file, advanced by a fixed number of frames as
+ * fast as the engine goes, and reported as an optional CSV trajectory plus a
+ * summary of conservation and timing diagnostics on stdout.
+ *
+ * Usage:
+ *   ThreeBodyHeadless <scenario> [--steps N] [--output file.csv] [--every K] [--threads T]
+ *                                [--parareal S]
+ *
+ * With --parareal the whole run is integrated in one go by the Parareal
+ * driver over S time slices on T threads (see parareal.h), gravity only: no
+ * collisions, colliders or regularization. The fine propagator is the
+ * integrator of the scenario, the coarse one semi-implicit Euler with steps of
+ * PARAREAL_COARSENING frames. The same interval is then integrated serially
+ * with the fine propagator alone, and the wall times and the difference of the
+ * two results are reported. The trajectory holds the first and last frames.
+ *
+ * The scenario format is described in scenario.h.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "scenario.h"
+
+inline constexpr float PARAREAL_COARSENING = 10.0f;    ///< Frames per step of the coarse propagator
+
+static void writeFrame(std::ofstream& out, long step, double time, const std::vector<Body*>& bodies) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const Body& body = *bodies[i];
+        if (body.sphere.mesh.source) continue;
+        out << step << ',' << time << ',' << i << ',' << body.sphere.Name << ','
+            << body.Position.x << ',' << body.Position.y << ',' << body.Position.z << ','
+            << body.Velocity.x << ',' << body.Velocity.y << ',' << body.Velocity.z << ','
+            << body.Mass << '\n';
+    }
+}
+
+// Double precision copy of the non-source bodies, in order
+static SystemState collect(const std::vector<Body*>& bodies) {
+    SystemState state;
+    for (const Body* body : bodies) {
+        if (body->sphere.mesh.source) continue;
+        state.Mass.push_back(body->Mass);
+        state.Position.push_back(glm::dvec3(body->Position));
+        state.Velocity.push_back(glm::dvec3(body->Velocity));
+    }
+    return state;
+}
+
+static void writeBack(const SystemState& state, std::vector<Body*>& bodies) {
+    size_t k = 0;
+    for (Body* body : bodies) {
+        if (body->sphere.mesh.source) continue;
+        body->Position = glm::vec3(state.Position[k]);
+        body->Velocity = glm::vec3(state.Velocity[k]);
+        ++k;
+    }
+}
+
+static void usage() {
+    std::cerr << "usage: ThreeBodyHeadless <scenario> [--steps N] [--output file.csv] [--every K] [--threads T]\n"
+                 "                         [--parareal S]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    std::string output;
+    long steps = -1, every = 1;
+    unsigned threads = 0, slices = 0;
+    for (int a = 2; a < argc; ++a) {
+        bool value = a + 1 < argc;
+        if (!std::strcmp(argv[a], "--steps") && value) steps = std::atol(argv[++a]);
+        else if (!std::strcmp(argv[a], "--output") && value) output = argv[++a];
+        else if (!std::strcmp(argv[a], "--every") && value) every = std::max(1L, std::atol(argv[++a]));
+        else if (!std::strcmp(argv[a], "--threads") && value) threads = (unsigned)std::atoi(argv[++a]);
+        else if (!std::strcmp(argv[a], "--parareal") && value) slices = (unsigned)std::max(1, std::atoi(argv[++a]));
+        else {
+            usage();
+            return 1;
+        }
+    }
+
+    Scenario scenario;
+    try {
+        scenario = loadScenario(argv[1]);
+    } catch (const std::exception& error) {
+        std::cerr << argv[1] << ": " << error.what() << std::endl;
+        return 1;
+    }
+
+    Physics engine(scenario.Step, 1.0f);
+    try {
+        configureEngine(engine, scenario, &std::cout);
+    } catch (const std::exception& error) {
+        std::cerr << argv[1] << ": " << error.what() << std::endl;
+        return 1;
+    }
+    if (steps < 0) steps = scenario.Steps;
+    if (threads > 0) engine.setThreads(threads);
+
+    std::vector<Body*> bodies = scenario.pointers();
+
+    std::ofstream trajectory;
+    if (!output.empty()) {
+        trajectory.open(output);
+        if (!trajectory) {
+            std::cerr << "cannot write " << output << std::endl;
+            return 1;
+        }
+        trajectory << std::setprecision(9) << "step,time,body,name,x,y,z,vx,vy,vz,mass\n";
+        writeFrame(trajectory, 0, engine.getTime(), bodies);
+    }
+
+    double energyStart, energyEnd;
+    glm::dvec3 momentumStart, momentumEnd;
+    systemTotals(bodies, energyStart, momentumStart);
+    const size_t bodiesStart = bodies.size();
+
+    // No frame clock: every frame runs as soon as the previous one is done
+    auto start = std::chrono::steady_clock::now();
+    long done = 0;
+    double simulated = 0.0;
+    if (slices > 0) {
+        const double interval = (double)steps * scenario.Step;
+        Propagator fine = Physics::makePropagator(engine.getIntegrator(), engine.getTolerance(), scenario.Step);
+        Propagator coarse = Physics::makePropagator(integratorType::EULER, 0.0, PARAREAL_COARSENING * scenario.Step);
+
+        Parareal parareal(coarse, fine);
+        if (threads > 0) parareal.setThreads(threads);
+        SystemState state = collect(bodies);
+        SystemState serial = collect(bodies);
+        unsigned iterations;
+        double seconds, serialSeconds;
+        try {
+            iterations = parareal.integrate(state, interval, slices);
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            auto serialStart = std::chrono::steady_clock::now();
+            fine(serial, interval);
+            serialSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - serialStart).count();
+        } catch (const std::exception& error) {
+            std::cerr << argv[1] << ": " << error.what() << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setprecision(6)
+                  << "parareal          " << slices << " slices, " << iterations << " iterations, " << seconds << " s"
+                  << " (last correction " << parareal.getCorrection() << ")\n"
+                  << "serial fine       " << serialSeconds << " s (speed-up " << (seconds > 0.0 ? serialSeconds / seconds : 0.0) << ")\n"
+                  << "difference        " << Parareal::difference(state, serial) << '\n';
+
+        writeBack(state, bodies);
+        done = steps;
+        simulated = state.Time;
+        if (trajectory.is_open()) writeFrame(trajectory, done, simulated, bodies);
+    } else {
+        while (done < steps && !engine.shouldClose()) {
+            advanceFrame(engine, scenario, bodies);
+            // A frame the integrator gave up on is lost
+            if (engine.hasFailed()) break;
+            ++done;
+            if (trajectory.is_open() && done % every == 0) writeFrame(trajectory, done, engine.getTime(), bodies);
+        }
+        simulated = engine.getTime();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    systemTotals(bodies, energyEnd, momentumEnd);
+
+    std::cout << std::setprecision(6)
+              << "frames            " << done << " of " << steps << (engine.hasFailed() ? " (the integrator gave up on a step)" : engine.shouldClose() ? " (stopped by a boundary or an event)" : "") << '\n'
+              << "simulated time    " << simulated << " s\n"
+              << "wall time         " << seconds << " s (" << (seconds > 0.0 ? done / seconds : 0.0) << " frames/s)\n"
+              << "bodies            " << bodiesStart << " -> " << bodies.size() << '\n'
+              << "energy            " << energyStart << " -> " << energyEnd;
+    if (energyStart != 0.0) std::cout << " (relative drift " << (energyEnd - energyStart) / std::abs(energyStart) << ")";
+    std::cout << '\n'
+              << "momentum change   " << glm::length(momentumEnd - momentumStart) << '\n'
+              << "neighbour builds  " << engine.getNeighbourBuilds() << '\n';
+    if (engine.isSecular()) std::cout << "secular           orbit-averaged at the end\n";
+    if (engine.getMegno() != 0.0) {
+        std::cout << "MEGNO             " << engine.getMegno() << '\n'
+                  << "Lyapunov          " << engine.getLyapunov() << '\n';
+    }
+
+    engine.cleanup();
+    return 0;
+}
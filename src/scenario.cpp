@@ -0,0 +1,249 @@
+#include "scenario.h"
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+Body* Scenario::find(const std::string& name) {
+    for (Body& body : Bodies) {
+        if (body.sphere.Name == name) return &body;
+    }
+    return nullptr;
+}
+
+std::vector<Body*> Scenario::pointers() {
+    std::vector<Body*> bodies;
+    for (Body& body : Bodies) bodies.push_back(&body);
+    return bodies;
+}
+
+static void fail(int line, const std::string& message) {
+    throw std::runtime_error("line " + std::to_string(line) + ": " + message);
+}
+
+static bool onOff(std::istringstream& in, int line) {
+    std::string value;
+    in >> value;
+    if (value == "on") return true;
+    if (value != "off") fail(line, "expected on or off");
+    return false;
+}
+
+Scenario loadScenario(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("cannot open " + path);
+
+    Scenario scenario;
+    std::string text;
+    for (int line = 1; std::getline(file, text); ++line) {
+        text = text.substr(0, text.find('#'));
+        std::istringstream in(text);
+        std::string key;
+        if (!(in >> key)) continue;
+
+        if (key == "step") {
+            if (!(in >> scenario.Step) || scenario.Step <= 0.0f) fail(line, "step needs a positive length");
+        } else if (key == "steps") {
+            if (!(in >> scenario.Steps) || scenario.Steps < 0) fail(line, "steps needs a count");
+        } else if (key == "body") {
+            Body body;
+            float radius;
+            std::string flag;
+            in >> body.sphere.Name >> body.Mass >> radius >> body.Position.x >> body.Position.y >> body.Position.z;
+            if (!in) fail(line, "body needs a name, mass, radius and position");
+            body.setRadius(radius);
+
+            // Optional velocity, then an optional light flag
+            if (in >> flag) {
+                if (flag == "light") {
+                    body.sphere.mesh.source = true;
+                } else {
+                    std::istringstream velocity(flag);
+                    velocity >> body.Velocity.x;
+                    in >> body.Velocity.y >> body.Velocity.z;
+                    if (!velocity || !in) fail(line, "body velocity needs three components");
+                    if (in >> flag) {
+                        if (flag != "light") fail(line, "unknown body flag " + flag);
+                        body.sphere.mesh.source = true;
+                    }
+                }
+            }
+            scenario.Bodies.push_back(body);
+        } else {
+            scenario.Directives.push_back(text);
+            scenario.Lines.push_back(line);
+        }
+    }
+
+    return scenario;
+}
+
+void configureEngine(Physics& engine, const Scenario& scenario, std::ostream* log) {
+    // Events count the non-source bodies in scene order
+    auto index = [&scenario](const std::string& name, int line) {
+        size_t k = 0;
+        for (const Body& body : scenario.Bodies) {
+            if (body.sphere.mesh.source) continue;
+            if (body.sphere.Name == name) return k;
+            ++k;
+        }
+        fail(line, "no body named " + name);
+        return k;
+    };
+
+    for (size_t d = 0; d < scenario.Directives.size(); ++d) {
+        std::istringstream in(scenario.Directives[d]);
+        const int line = scenario.Lines[d];
+        std::string key, name;
+        in >> key;
+
+        if (key == "integrator") {
+            in >> name;
+            if (name == "euler") engine.setIntegrator(integratorType::EULER);
+            else if (name == "bulirsch_stoer") engine.setIntegrator(integratorType::BULIRSCH_STOER);
+            else if (name == "taylor") engine.setIntegrator(integratorType::TAYLOR);
+            else fail(line, "unknown integrator " + name);
+        } else if (key == "tolerance") {
+            double tolerance;
+            if (!(in >> tolerance)) fail(line, "tolerance needs a value");
+            engine.setTolerance(tolerance);
+        } else if (key == "regularization") {
+            float distance;
+            if (!(in >> distance)) fail(line, "regularization needs a distance");
+            engine.setRegularization(distance);
+        } else if (key == "adaptive") {
+            float minStep, maxStep, eta;
+            in >> name;
+            if (name == "off") {
+                engine.setAdaptiveStep(false, 0.0f, 0.0f);
+                continue;
+            }
+            std::istringstream bounds(name);
+            if (!(bounds >> minStep) || !(in >> maxStep) || minStep <= 0.0f || maxStep < minStep) {
+                fail(line, "adaptive needs off or a smallest and a largest step");
+            }
+            engine.setAdaptiveStep(true, minStep, maxStep);
+            if (in >> eta) engine.setStepAccuracy(eta);
+        } else if (key == "secular") {
+            engine.setSecularMode(onOff(in, line));
+        } else if (key == "chain") {
+            float radius;
+            if (!(in >> radius)) fail(line, "chain needs a radius");
+            engine.setChainRegularization(radius);
+        } else if (key == "broadphase") {
+            in >> name;
+            if (name == "hash") engine.setBroadPhase(broadPhaseType::SPATIAL_HASH);
+            else if (name == "sweep") engine.setBroadPhase(broadPhaseType::SWEEP_AND_PRUNE);
+            else fail(line, "unknown broad phase " + name);
+        } else if (key == "skin") {
+            float skin;
+            if (!(in >> skin)) fail(line, "skin needs a distance");
+            engine.setNeighbourSkin(skin);
+        } else if (key == "continuous") {
+            engine.setContinuousCollisions(onOff(in, line));
+        } else if (key == "eventdriven") {
+            engine.setEventDriven(onOff(in, line));
+        } else if (key == "substeps") {
+            int substeps;
+            if (!(in >> substeps)) fail(line, "substeps needs a count");
+            engine.setContactSubsteps(substeps);
+        } else if (key == "sleep") {
+            engine.setSleeping(onOff(in, line));
+        } else if (key == "merge") {
+            float density = 0.0f;
+            in >> density;
+            engine.setCollisionPolicy(collisionPolicy::MERGE, density);
+        } else if (key == "solver") {
+            int iterations;
+            in >> name;
+            if (!(in >> iterations)) iterations = CONTACT_ITERATIONS;
+            if (name == "elastic") engine.setContactSolver(contactSolverType::ELASTIC);
+            else if (name == "impulse") engine.setContactSolver(contactSolverType::SEQUENTIAL_IMPULSE, iterations);
+            else fail(line, "unknown contact solver " + name);
+        } else if (key == "chaos") {
+            engine.setChaosIndicators(onOff(in, line));
+        } else if (key == "event") {
+            std::string one, two;
+            Event event;
+            in >> name >> one;
+            if (name == "approach") {
+                double distance;
+                if (!(in >> two >> distance) || distance <= 0.0) fail(line, "event approach needs two bodies and a distance");
+                event = EventDetector::pairDistance(index(one, line), index(two, line), distance);
+            } else if (name == "escape") {
+                if (!in) fail(line, "event escape needs a body");
+                event = EventDetector::escape(index(one, line));
+            } else if (name == "plane") {
+                glm::dvec3 point, normal;
+                in >> point.x >> point.y >> point.z >> normal.x >> normal.y >> normal.z;
+                if (!in) fail(line, "event plane needs a body, a point and a normal");
+                event = EventDetector::planeCrossing(index(one, line), point, normal);
+            } else {
+                fail(line, "unknown event " + name);
+            }
+
+            std::string flag;
+            if (in >> flag) {
+                if (flag != "stop") fail(line, "unknown event flag " + flag);
+                event.Terminal = true;
+            }
+            if (log) {
+                std::string text = scenario.Directives[d];
+                text.erase(text.find_last_not_of(" \t\r") + 1);
+                event.Callback = [log, text](const SystemState& state) {
+                    *log << text << " at t = " << state.Time << " s\n";
+                };
+            }
+            engine.addEvent(event);
+        } else if (key == "plane") {
+            glm::vec3 point, normal;
+            in >> point.x >> point.y >> point.z >> normal.x >> normal.y >> normal.z;
+            if (!in) fail(line, "plane needs a point and a normal");
+            engine.addPlane(point, normal);
+        } else if (key == "box") {
+            glm::vec3 lower, upper;
+            in >> lower.x >> lower.y >> lower.z >> upper.x >> upper.y >> upper.z;
+            if (!in) fail(line, "box needs two corners");
+            engine.addBox(lower, upper);
+        } else if (key == "surface") {
+            float distance, size;
+            int side = 0;
+            in >> distance >> size >> name;
+            if (!in) fail(line, "surface needs a distance, size and orientation");
+            in >> side;
+
+            surfaceOrientation orientation;
+            if (name == "x") orientation = surfaceOrientation::X;
+            else if (name == "y") orientation = surfaceOrientation::Y;
+            else if (name == "z") orientation = surfaceOrientation::Z;
+            else fail(line, "unknown orientation " + name);
+            engine.addSurface(Surface(distance, size, orientation), side);
+        } else {
+            fail(line, "unknown directive " + key);
+        }
+    }
+}
+
+void advanceFrame(Physics& engine, const Scenario& scenario, std::vector<Body*>& bodies) {
+    if (engine.isAdaptive()) engine.advance(bodies, scenario.Step);
+    else engine.processFrame(bodies);
+}
+
+void systemTotals(const std::vector<Body*>& bodies, double& energy, glm::dvec3& momentum) {
+    energy = 0.0;
+    momentum = glm::dvec3(0.0);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const Body& one = *bodies[i];
+        if (one.sphere.mesh.source) continue;
+
+        glm::dvec3 velocity(one.Velocity);
+        energy += 0.5 * one.Mass * glm::dot(velocity, velocity);
+        momentum += (double)one.Mass * velocity;
+
+        for (size_t j = i + 1; j < bodies.size(); ++j) {
+            const Body& two = *bodies[j];
+            if (two.sphere.mesh.source) continue;
+            energy -= GRAV_CONST * one.Mass * two.Mass / glm::length(glm::dvec3(two.Position) - glm::dvec3(one.Position));
+        }
+    }
+}
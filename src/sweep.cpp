@@ -0,0 +1,825 @@
+/**
+ * @file sweep.cpp
+ * @author DotBox
+ * @brief Parameter-sweep driver: many variations of one scenario over a pool of worker processes
+ *
+ * A sweep runs one scenario (see scenario.h) many times, each time with some
+ * of its quantities changed, and records how every run ended. It is described
+ * by a spec file, one directive per line ('#' starts a comment):
+ *
+ *   scenario <path>                         Base scene (relative to the spec file)
+ *   design grid|random [samples] [seed]     Full grid, or uniform random samples
+ *   vary mass|x|y|z|vx|vy|vz <body> <min> <max> [count]
+ *   vary step <min> <max> [count]           Frame length
+ *   integrator <name> [<name> ...]          Integrators to try (one per run)
+ *   duration <seconds>                      Simulated time per run (default: the scenario's steps)
+ *   escape <radius>                         Stop a run once a body has escaped (0: never)
+ *   shard <runs>                            Runs per unit of work
+ *   engine scene|ensemble                   What runs the scenes (default: scene)
+ *
+ * A grid takes every combination of count evenly spaced values per quantity
+ * (SWEEP_GRID by default) and of the integrators. A random design draws each
+ * quantity of each run uniformly from its range; the draws are a hash of the
+ * seed and the run index, so a design is reproducible and independent of how
+ * it is split up.
+ *
+ * Runs are grouped into shards. The driver forks one worker process per core
+ * and hands each a shard; a worker runs its shard on a single thread and
+ * exits. Processes rather than threads, so that a run that crashes, hangs
+ * (see --timeout) or corrupts memory takes down one worker, not the sweep.
+ *
+ * Results go to a binary table that the driver and the workers map into
+ * memory (MAP_SHARED): a header, a done flag per shard and one fixed-size
+ * record per run (parameters, status, outcome, stop time, relative energy
+ * error). Workers write their records in place, so nothing is lost when one
+ * dies; the driver only reaps them. A worker flushes its records to disk
+ * before it sets the done flag of its shard, which makes every finished shard
+ * a checkpoint: running the same spec against an existing table skips the
+ * finished shards and the finished runs of the others.
+ *
+ * A worker marks a run as running before it starts and counts the attempt.
+ * When a worker dies, its shard goes back into the queue; the run it died in
+ * is retried up to SWEEP_ATTEMPTS times and then recorded as crashed, so one
+ * bad run cannot stall its shard.
+ *
+ * A run counts as hung once it has taken longer than --timeout seconds (0:
+ * never). By default that is SWEEP_FRAME_SECONDS per frame of the run, and at
+ * least SWEEP_MIN_TIMEOUT: far more than any integrator needs, but a bound.
+ *
+ * By default every run is a full engine on the scene, with its integrator,
+ * contacts and directives. With 'engine ensemble' the runs of a shard are
+ * instead integrated side by side by the ensemble engine (see ensemble.h),
+ * one batch per frame length: a fixed-step leapfrog in double precision that
+ * stops a run when two spheres touch (outcome collided) or a body escapes.
+ * Only the bodies, the step and the steps of the scenario apply then, and it
+ * must hold exactly three bodies that are not light sources. The timeout of
+ * a batch is the sum of the timeouts of its runs.
+ *
+ * Usage:
+ *   ThreeBodySweep <spec> <results> [--workers N] [--timeout S] [--csv file.csv]
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include "scenario.h"
+#include "Physics/ensemble.h"
+
+inline constexpr int SWEEP_PARAMETERS = 16;         ///< Quantities a sweep may vary, integrator included
+inline constexpr int SWEEP_GRID = 5;                ///< Default values per quantity of a grid
+inline constexpr uint32_t SWEEP_ATTEMPTS = 3;       ///< Worker deaths a run may cause before it is given up
+inline constexpr long SWEEP_CHECK = 16;             ///< Frames between escape checks
+inline constexpr uint64_t SWEEP_SHARD = 64;         ///< Default runs per shard
+inline constexpr double SWEEP_FRAME_SECONDS = 0.01; ///< Default timeout of a run per frame (s)
+inline constexpr unsigned SWEEP_MIN_TIMEOUT = 60;   ///< Least default timeout of a run (s)
+inline constexpr char SWEEP_MAGIC[8] = "3BSWEEP";   ///< First bytes of a results table
+
+/// Where a run stands in the results table
+enum runStatus : uint32_t {
+    PENDING,    ///< Not started
+    RUNNING,    ///< Started; left like this only by a worker that died
+    FINISHED,   ///< Outcome recorded
+    CRASHED     ///< Killed its worker SWEEP_ATTEMPTS times, or threw
+};
+
+/// How a finished run ended
+enum runOutcome : uint32_t {
+    TIMED_OUT,  ///< Ran for the whole duration
+    ESCAPED,    ///< A body left the others for good
+    MERGED,     ///< Two bodies merged
+    BOUNDARY,   ///< A terminal event stopped the engine
+    COLLIDED    ///< Two spheres touched (ensemble runs, which do not resolve contacts)
+};
+
+struct SweepHeader {
+    char Magic[8];
+    uint64_t Hash;          ///< Of the spec and scenario text, so a table is only resumed by its own sweep
+    uint64_t Runs;
+    uint64_t ShardRuns;
+    uint64_t Shards;
+    uint64_t Parameters;
+};
+
+struct SweepRecord {
+    uint32_t Status;        ///< runStatus
+    uint32_t Attempts;      ///< Times a worker started the run
+    uint32_t Outcome;       ///< runOutcome, once FINISHED
+    int32_t Body;           ///< Escaping body, or -1
+    double Time;            ///< Simulated time at the stop (the escape time for ESCAPED)
+    double EnergyError;     ///< |E_end - E_start| / |E_start|
+    double Parameters[SWEEP_PARAMETERS];
+};
+
+/// One varied quantity
+struct Dimension {
+    std::string Quantity;   ///< mass, x, y, z, vx, vy, vz, step or integrator
+    std::string Body;
+    double Min = 0.0, Max = 0.0;
+    uint64_t Count = SWEEP_GRID;
+};
+
+struct SweepSpec {
+    std::string ScenarioPath;
+    bool Random = false;
+    uint64_t Samples = 0;
+    uint64_t Seed = 1;
+    std::vector<Dimension> Dimensions;
+    std::vector<std::string> Integrators;
+    double Duration = 0.0;
+    double EscapeRadius = 0.0;
+    uint64_t ShardRuns = SWEEP_SHARD;
+    bool Ensemble = false;
+    uint64_t Hash = 0;
+};
+
+/// The results table as mapped into memory
+struct Table {
+    SweepHeader* Header = nullptr;
+    uint64_t* Done = nullptr;           ///< Per shard: 1 once its records are on disk
+    SweepRecord* Records = nullptr;
+    size_t Size = 0;
+};
+
+static void fail(int line, const std::string& message) {
+    throw std::runtime_error("line " + std::to_string(line) + ": " + message);
+}
+
+static uint64_t fnv1a(const std::string& text, uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static std::string readFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("cannot open " + path);
+    std::ostringstream text;
+    text << file.rdbuf();
+    return text.str();
+}
+
+static SweepSpec loadSpec(const std::string& path) {
+    SweepSpec spec;
+    const std::string text = readFile(path);
+    std::istringstream file(text);
+    std::string line;
+
+    for (int number = 1; std::getline(file, line); ++number) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key)) continue;
+
+        if (key == "scenario") {
+            if (!(in >> spec.ScenarioPath)) fail(number, "scenario needs a path");
+            size_t slash = path.find_last_of('/');
+            if (spec.ScenarioPath[0] != '/' && slash != std::string::npos) {
+                spec.ScenarioPath = path.substr(0, slash + 1) + spec.ScenarioPath;
+            }
+        } else if (key == "design") {
+            std::string kind;
+            uint64_t seed;
+            in >> kind;
+            if (kind == "random") {
+                spec.Random = true;
+                if (!(in >> spec.Samples) || spec.Samples == 0) fail(number, "a random design needs a sample count");
+                if (in >> seed) spec.Seed = seed;
+            } else if (kind != "grid") {
+                fail(number, "unknown design " + kind);
+            }
+        } else if (key == "vary") {
+            Dimension dimension;
+            in >> dimension.Quantity;
+            const std::string& q = dimension.Quantity;
+            if (q != "step") in >> dimension.Body;
+            in >> dimension.Min >> dimension.Max;
+            if (!in) fail(number, "vary needs a quantity, " + std::string(q == "step" ? "" : "a body, ") + "and a range");
+            if (q == "step" && !(dimension.Min > 0.0 && dimension.Max > 0.0)) fail(number, "vary step needs a positive range");
+            if (q != "mass" && q != "x" && q != "y" && q != "z" && q != "vx" && q != "vy" && q != "vz" && q != "step") {
+                fail(number, "cannot vary " + q);
+            }
+            if (!(in >> dimension.Count)) dimension.Count = SWEEP_GRID;
+            if (dimension.Count == 0) fail(number, "vary needs at least one value");
+            spec.Dimensions.push_back(dimension);
+        } else if (key == "integrator") {
+            std::string name;
+            while (in >> name) {
+                if (name != "euler" && name != "bulirsch_stoer" && name != "taylor") fail(number, "unknown integrator " + name);
+                spec.Integrators.push_back(name);
+            }
+            if (spec.Integrators.empty()) fail(number, "integrator needs a name");
+        } else if (key == "duration") {
+            if (!(in >> spec.Duration) || spec.Duration <= 0.0) fail(number, "duration needs a positive time");
+        } else if (key == "escape") {
+            if (!(in >> spec.EscapeRadius) || spec.EscapeRadius < 0.0) fail(number, "escape needs a radius");
+        } else if (key == "shard") {
+            if (!(in >> spec.ShardRuns) || spec.ShardRuns == 0) fail(number, "shard needs a run count");
+        } else if (key == "engine") {
+            std::string kind;
+            in >> kind;
+            if (kind != "scene" && kind != "ensemble") fail(number, "unknown engine " + kind);
+            spec.Ensemble = kind == "ensemble";
+        } else {
+            fail(number, "unknown directive " + key);
+        }
+    }
+
+    if (spec.ScenarioPath.empty()) throw std::runtime_error("no scenario given");
+    if (spec.Ensemble && !spec.Integrators.empty()) throw std::runtime_error("the ensemble engine has its own integrator");
+
+    // The integrator is one more dimension, with the index into the names as its value
+    if (!spec.Integrators.empty()) {
+        Dimension dimension;
+        dimension.Quantity = "integrator";
+        dimension.Max = (double)(spec.Integrators.size() - 1);
+        dimension.Count = spec.Integrators.size();
+        spec.Dimensions.push_back(dimension);
+    }
+    if (spec.Dimensions.size() > (size_t)SWEEP_PARAMETERS) {
+        throw std::runtime_error("at most " + std::to_string(SWEEP_PARAMETERS) + " quantities can be varied");
+    }
+
+    spec.Hash = fnv1a(readFile(spec.ScenarioPath), fnv1a(text));
+    return spec;
+}
+
+static uint64_t runCount(const SweepSpec& spec) {
+    if (spec.Random) return spec.Samples;
+    uint64_t runs = 1;
+    for (const Dimension& dimension : spec.Dimensions) runs *= dimension.Count;
+    return runs;
+}
+
+// Values of the varied quantities of one run
+static void design(const SweepSpec& spec, uint64_t run, double* parameters) {
+    const size_t count = spec.Dimensions.size();
+
+    // Grid: mixed-radix digits of the run index, the last quantity varying
+    // fastest. Random: a hash of the seed, the run and the quantity
+    uint64_t rest = run;
+    for (size_t d = count; d-- > 0;) {
+        const Dimension& dimension = spec.Dimensions[d];
+        double value;
+        if (spec.Random) {
+            double u = (double)(splitmix64(spec.Seed ^ splitmix64(run * SWEEP_PARAMETERS + d)) >> 11) * 0x1.0p-53;
+            value = dimension.Quantity == "integrator"
+                  ? std::min(std::floor(u * dimension.Count), dimension.Max)
+                  : dimension.Min + u * (dimension.Max - dimension.Min);
+        } else {
+            uint64_t k = rest % dimension.Count;
+            rest /= dimension.Count;
+            value = dimension.Count > 1 ? dimension.Min + (dimension.Max - dimension.Min) * (double)k / (double)(dimension.Count - 1) : dimension.Min;
+        }
+        parameters[d] = value;
+    }
+}
+
+static std::string parameterName(const Dimension& dimension) {
+    return dimension.Body.empty() ? dimension.Quantity : dimension.Quantity + ":" + dimension.Body;
+}
+
+// Change the base scene into the scene of one run
+static void apply(Scenario& scenario, const SweepSpec& spec, const double* parameters) {
+    for (size_t d = 0; d < spec.Dimensions.size(); ++d) {
+        const Dimension& dimension = spec.Dimensions[d];
+        const double value = parameters[d];
+
+        if (dimension.Quantity == "step") {
+            scenario.Step = (float)value;
+        } else if (dimension.Quantity == "integrator") {
+            // After the scenario's own directives, so it wins
+            scenario.Directives.push_back("integrator " + spec.Integrators[(size_t)value]);
+            scenario.Lines.push_back(0);
+        } else {
+            Body& body = *scenario.find(dimension.Body);
+            if (dimension.Quantity == "mass") body.Mass = (float)value;
+            else if (dimension.Quantity == "x") body.Position.x = (float)value;
+            else if (dimension.Quantity == "y") body.Position.y = (float)value;
+            else if (dimension.Quantity == "z") body.Position.z = (float)value;
+            else if (dimension.Quantity == "vx") body.Velocity.x = (float)value;
+            else if (dimension.Quantity == "vy") body.Velocity.y = (float)value;
+            else if (dimension.Quantity == "vz") body.Velocity.z = (float)value;
+        }
+    }
+}
+
+// Body that has left the others for good (beyond the radius from their centre
+// of mass, receding, unbound against them), or -1
+static int escaping(const std::vector<Body*>& bodies, double radius) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        const Body& body = *bodies[i];
+        if (body.sphere.mesh.source) continue;
+
+        double m = 0.0;
+        glm::dvec3 centre(0.0), drift(0.0);
+        for (size_t j = 0; j < bodies.size(); ++j) {
+            const Body& other = *bodies[j];
+            if (j == i || other.sphere.mesh.source) continue;
+            m += other.Mass;
+            centre += (double)other.Mass * glm::dvec3(other.Position);
+            drift += (double)other.Mass * glm::dvec3(other.Velocity);
+        }
+        if (m <= 0.0) continue;
+        centre /= m;
+        drift /= m;
+
+        glm::dvec3 r = glm::dvec3(body.Position) - centre;
+        glm::dvec3 v = glm::dvec3(body.Velocity) - drift;
+        double distance = glm::length(r);
+        if (distance < radius || glm::dot(r, v) <= 0.0) continue;
+
+        double energy = 0.5 * glm::dot(v, v) - GRAV_CONST * (m + body.Mass) / distance;
+        if (energy > 0.0) return (int)i;
+    }
+    return -1;
+}
+
+// Frames of a run: the duration of the sweep, or the steps of the scenario
+static long frames(const SweepSpec& spec, const Scenario& scenario) {
+    return spec.Duration > 0.0 ? (long)std::ceil(spec.Duration / scenario.Step) : scenario.Steps;
+}
+
+// Seconds a run may take before it counts as hung: --timeout if given, else a budget per frame
+static unsigned runTimeout(const SweepSpec& spec, const Scenario& scenario, long timeout) {
+    if (timeout >= 0) return (unsigned)std::min<long>(timeout, UINT32_MAX);
+    const double seconds = std::ceil(SWEEP_FRAME_SECONDS * (double)frames(spec, scenario));
+    return (unsigned)std::clamp(seconds, (double)SWEEP_MIN_TIMEOUT, (double)UINT32_MAX);
+}
+
+// Run one variation of the scene (see apply()) and fill in its outcome
+static void simulate(Scenario& scenario, const SweepSpec& spec, SweepRecord& record) {
+    Physics engine(scenario.Step, 1.0f);
+    configureEngine(engine, scenario);
+    // The workers are the parallelism; one thread each
+    engine.setThreads(1);
+
+    std::vector<Body*> bodies = scenario.pointers();
+    const long steps = frames(spec, scenario);
+    const size_t count = bodies.size();
+
+    double energyStart, energyEnd;
+    glm::dvec3 momentum;
+    systemTotals(bodies, energyStart, momentum);
+
+    record.Outcome = runOutcome::TIMED_OUT;
+    record.Body = -1;
+    for (long frame = 1; frame <= steps; ++frame) {
+        advanceFrame(engine, scenario, bodies);
+        if (bodies.size() < count) {
+            record.Outcome = runOutcome::MERGED;
+            break;
+        }
+        // A run the integrator gave up on has no outcome; it is recorded as crashed
+        if (engine.hasFailed()) throw std::runtime_error("the integrator gave up on a step");
+        if (engine.shouldClose()) {
+            record.Outcome = runOutcome::BOUNDARY;
+            break;
+        }
+        if (spec.EscapeRadius > 0.0 && frame % SWEEP_CHECK == 0) {
+            record.Body = escaping(bodies, spec.EscapeRadius);
+            if (record.Body >= 0) {
+                record.Outcome = runOutcome::ESCAPED;
+                break;
+            }
+        }
+    }
+
+    systemTotals(bodies, energyEnd, momentum);
+    record.Time = engine.getTime();
+    record.EnergyError = std::abs(energyEnd - energyStart) / (energyStart != 0.0 ? std::abs(energyStart) : 1.0);
+    engine.cleanup();
+}
+
+// Write a range of the mapping back to the file (msync wants page-aligned addresses)
+static void flush(const void* begin, size_t bytes) {
+    static const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)begin & ~(page - 1);
+    msync((void*)start, (uintptr_t)begin + bytes - start, MS_SYNC);
+}
+
+// True when a run still has to be started; gives up the runs that killed their worker too often
+static bool pending(SweepRecord& record) {
+    if (record.Status == runStatus::FINISHED || record.Status == runStatus::CRASHED) return false;
+
+    // Left running by a worker that died in it
+    if (record.Status == runStatus::RUNNING && record.Attempts >= SWEEP_ATTEMPTS) {
+        record.Status = runStatus::CRASHED;
+        return false;
+    }
+    return true;
+}
+
+// Double precision copy of the bodies of a scene that are not light sources
+static SystemState collect(const Scenario& scenario) {
+    SystemState state;
+    for (const Body& body : scenario.Bodies) {
+        if (body.sphere.mesh.source) continue;
+        state.Mass.push_back(body.Mass);
+        state.Position.push_back(glm::dvec3(body.Position));
+        state.Velocity.push_back(glm::dvec3(body.Velocity));
+    }
+    return state;
+}
+
+// Run the pending runs of a shard on the ensemble engine, one batch per frame length
+static void runEnsemble(const Table& table, const Scenario& base, const SweepSpec& spec, uint64_t first, uint64_t last, long timeout) {
+    // Scene index and radius of each body of a system
+    std::vector<int> scene;
+    std::vector<double> radii;
+    for (size_t i = 0; i < base.Bodies.size(); ++i) {
+        if (base.Bodies[i].sphere.mesh.source) continue;
+        scene.push_back((int)i);
+        radii.push_back(base.Bodies[i].sphere.geometry.getRadius());
+    }
+
+    struct Batch {
+        std::vector<uint64_t> Runs;
+        std::vector<SystemState> Systems;
+        uint64_t Timeout = 0;               ///< Sum of the timeouts of the runs
+    };
+    std::map<float, Batch> batches;
+    for (uint64_t run = first; run < last; ++run) {
+        SweepRecord& record = table.Records[run];
+        if (!pending(record)) continue;
+
+        Scenario scenario = base;
+        apply(scenario, spec, record.Parameters);
+        Batch& batch = batches[scenario.Step];
+        batch.Runs.push_back(run);
+        batch.Systems.push_back(collect(scenario));
+        batch.Timeout += runTimeout(spec, scenario, timeout);
+    }
+
+    for (const auto& [step, batch] : batches) {
+        Ensemble ensemble;
+        // The workers are the parallelism; one thread each
+        ensemble.setThreads(1);
+        ensemble.setStep(step);
+        ensemble.setDuration(spec.Duration > 0.0 ? spec.Duration : (double)base.Steps * step);
+        // Each pair touches at the sum of its radii
+        ensemble.setRadii(radii);
+        ensemble.setEscapeRadius(spec.EscapeRadius);
+
+        for (uint64_t run : batch.Runs) {
+            table.Records[run].Status = runStatus::RUNNING;
+            ++table.Records[run].Attempts;
+        }
+
+        if (batch.Timeout > 0) alarm((unsigned)std::min<uint64_t>(batch.Timeout, UINT32_MAX));
+        try {
+            std::vector<EnsembleResult> results = ensemble.run(batch.Systems);
+            for (size_t i = 0; i < results.size(); ++i) {
+                const EnsembleResult& result = results[i];
+                SweepRecord& record = table.Records[batch.Runs[i]];
+                record.Outcome = result.Outcome == ensembleOutcome::ESCAPED ? runOutcome::ESCAPED
+                               : result.Outcome == ensembleOutcome::COLLIDED ? runOutcome::COLLIDED
+                               : runOutcome::TIMED_OUT;
+                record.Body = result.Outcome == ensembleOutcome::ESCAPED ? scene[result.Body] : -1;
+                record.Time = result.Final.Time;
+                const double energyStart = totalEnergy(batch.Systems[i]);
+                record.EnergyError = std::abs(totalEnergy(result.Final) - energyStart) / (energyStart != 0.0 ? std::abs(energyStart) : 1.0);
+                record.Status = runStatus::FINISHED;
+            }
+        } catch (const std::exception&) {
+            for (uint64_t run : batch.Runs) table.Records[run].Status = runStatus::CRASHED;
+        }
+        alarm(0);
+    }
+}
+
+// Run the pending runs of a shard one after the other, each on a full engine
+static void runScenes(const Table& table, const Scenario& base, const SweepSpec& spec, uint64_t first, uint64_t last, long timeout) {
+    for (uint64_t run = first; run < last; ++run) {
+        SweepRecord& record = table.Records[run];
+        if (!pending(record)) continue;
+
+        record.Status = runStatus::RUNNING;
+        ++record.Attempts;
+
+        Scenario scenario = base;
+        apply(scenario, spec, record.Parameters);
+
+        // A hung run is ended by SIGALRM, which the driver treats as a crash
+        const unsigned limit = runTimeout(spec, scenario, timeout);
+        if (limit > 0) alarm(limit);
+        try {
+            simulate(scenario, spec, record);
+            record.Status = runStatus::FINISHED;
+        } catch (const std::exception&) {
+            record.Status = runStatus::CRASHED;
+        }
+        alarm(0);
+    }
+}
+
+// Body of a worker process
+static void runShard(const Table& table, const Scenario& base, const SweepSpec& spec, uint64_t shard, long timeout) {
+    const uint64_t first = shard * table.Header->ShardRuns;
+    const uint64_t last = std::min(table.Header->Runs, first + table.Header->ShardRuns);
+
+    if (spec.Ensemble) runEnsemble(table, base, spec, first, last, timeout);
+    else runScenes(table, base, spec, first, last, timeout);
+
+    flush(&table.Records[first], (last - first) * sizeof(SweepRecord));
+    table.Done[shard] = 1;
+    flush(&table.Done[shard], sizeof(uint64_t));
+}
+
+static size_t tableSize(uint64_t runs, uint64_t shards) {
+    return sizeof(SweepHeader) + shards * sizeof(uint64_t) + runs * sizeof(SweepRecord);
+}
+
+static Table mapTable(int fd, size_t size) {
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) throw std::runtime_error(std::string("cannot map the results: ") + std::strerror(errno));
+
+    Table table;
+    table.Size = size;
+    table.Header = (SweepHeader*)memory;
+    table.Done = (uint64_t*)(table.Header + 1);
+    table.Records = (SweepRecord*)(table.Done + table.Header->Shards);
+    return table;
+}
+
+// Map the results table of the sweep, creating it if there is none yet
+static Table openTable(const std::string& path, const SweepSpec& spec, bool& resumed) {
+    const uint64_t runs = runCount(spec);
+    const uint64_t shards = (runs + spec.ShardRuns - 1) / spec.ShardRuns;
+    const size_t size = tableSize(runs, shards);
+
+    int fd = open(path.c_str(), O_RDWR);
+    resumed = fd >= 0;
+    if (resumed) {
+        struct stat info;
+        SweepHeader header;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(header) || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)
+            || std::memcmp(header.Magic, SWEEP_MAGIC, sizeof(SWEEP_MAGIC)) != 0) {
+            close(fd);
+            throw std::runtime_error(path + " is not a sweep results table");
+        }
+        if (header.Hash != spec.Hash || header.Runs != runs || header.ShardRuns != spec.ShardRuns || (size_t)info.st_size != size) {
+            close(fd);
+            throw std::runtime_error(path + " holds the results of a different sweep; remove it to start over");
+        }
+        Table table = mapTable(fd, size);
+        close(fd);
+        return table;
+    }
+
+    // Built under a temporary name and renamed, so a table that exists is complete
+    const std::string building = path + ".new";
+    fd = open(building.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)size) != 0) {
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("cannot create " + building + ": " + std::strerror(errno));
+    }
+
+    SweepHeader header = {};
+    std::memcpy(header.Magic, SWEEP_MAGIC, sizeof(SWEEP_MAGIC));
+    header.Hash = spec.Hash;
+    header.Runs = runs;
+    header.ShardRuns = spec.ShardRuns;
+    header.Shards = shards;
+    header.Parameters = spec.Dimensions.size();
+    if (pwrite(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        close(fd);
+        throw std::runtime_error("cannot write " + building);
+    }
+
+    Table table = mapTable(fd, size);
+    close(fd);
+    for (uint64_t run = 0; run < runs; ++run) {
+        SweepRecord& record = table.Records[run];
+        record.Body = -1;
+        design(spec, run, record.Parameters);
+    }
+    msync(table.Header, size, MS_SYNC);
+    if (rename(building.c_str(), path.c_str()) != 0) {
+        munmap(table.Header, size);
+        throw std::runtime_error("cannot create " + path + ": " + std::strerror(errno));
+    }
+    return table;
+}
+
+static void writeCsv(std::ofstream& out, const Table& table, const SweepSpec& spec) {
+    static const char* statuses[] = {"pending", "running", "finished", "crashed"};
+    static const char* outcomes[] = {"timed_out", "escaped", "merged", "boundary", "collided"};
+
+    out << std::setprecision(9) << "run,status,attempts,outcome,body,time,energy_error";
+    for (const Dimension& dimension : spec.Dimensions) out << ',' << parameterName(dimension);
+    out << '\n';
+
+    for (uint64_t run = 0; run < table.Header->Runs; ++run) {
+        const SweepRecord& record = table.Records[run];
+        const bool finished = record.Status == runStatus::FINISHED;
+        out << run << ',' << statuses[std::min<uint32_t>(record.Status, 3)] << ',' << record.Attempts << ','
+            << (finished ? outcomes[std::min<uint32_t>(record.Outcome, 4)] : "") << ','
+            << (finished ? record.Body : -1) << ',' << (finished ? record.Time : 0.0) << ','
+            << (finished ? record.EnergyError : 0.0);
+        for (size_t d = 0; d < spec.Dimensions.size(); ++d) {
+            if (spec.Dimensions[d].Quantity == "integrator") out << ',' << spec.Integrators[(size_t)record.Parameters[d]];
+            else out << ',' << record.Parameters[d];
+        }
+        out << '\n';
+    }
+}
+
+static void usage() {
+    std::cerr << "usage: ThreeBodySweep <spec> <results> [--workers N] [--timeout S] [--csv file.csv]" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+
+    std::string csv;
+    long workers = sysconf(_SC_NPROCESSORS_ONLN);
+    long timeout = -1;      // Per run; -1: from the frames of the run
+    for (int a = 3; a < argc; ++a) {
+        bool value = a + 1 < argc;
+        if (!std::strcmp(argv[a], "--workers") && value) workers = std::atol(argv[++a]);
+        else if (!std::strcmp(argv[a], "--timeout") && value) timeout = std::max(0L, std::atol(argv[++a]));
+        else if (!std::strcmp(argv[a], "--csv") && value) csv = argv[++a];
+        else {
+            usage();
+            return 1;
+        }
+    }
+    workers = std::max(1L, workers);
+
+    // Everything that can be wrong with the spec shows up here, not in the workers
+    SweepSpec spec;
+    Scenario base;
+    try {
+        spec = loadSpec(argv[1]);
+        base = loadScenario(spec.ScenarioPath);
+        for (const Dimension& dimension : spec.Dimensions) {
+            if (!dimension.Body.empty() && !base.find(dimension.Body)) {
+                throw std::runtime_error("no body named " + dimension.Body + " in " + spec.ScenarioPath);
+            }
+        }
+        if (spec.Ensemble && collect(base).size() != (size_t)ENSEMBLE_BODIES) {
+            throw std::runtime_error("the ensemble engine needs exactly " + std::to_string(ENSEMBLE_BODIES) + " bodies in " + spec.ScenarioPath);
+        }
+        Physics engine(base.Step, 1.0f);
+        configureEngine(engine, base);
+    } catch (const std::exception& error) {
+        std::cerr << argv[1] << ": " << error.what() << std::endl;
+        return 1;
+    }
+
+    Table table;
+    bool resumed;
+    try {
+        table = openTable(argv[2], spec, resumed);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+
+    const uint64_t shards = table.Header->Shards;
+    std::deque<uint64_t> queue;
+    for (uint64_t shard = 0; shard < shards; ++shard) {
+        if (!table.Done[shard]) queue.push_back(shard);
+    }
+
+    std::cout << table.Header->Runs << " runs in " << shards << " shards";
+    if (resumed) std::cout << ", " << shards - queue.size() << " already done";
+    std::cout << ", " << workers << " workers" << std::endl;
+
+    // Deaths a shard may see before it is given up: every run its attempts,
+    // and a few more for deaths between runs
+    const uint64_t deathLimit = (table.Header->ShardRuns + 1) * SWEEP_ATTEMPTS;
+    std::vector<uint64_t> deaths(shards, 0);
+    std::map<pid_t, uint64_t> children;
+    size_t restarts = 0, abandoned = 0;
+
+    const pid_t driver = getpid();
+    auto start = std::chrono::steady_clock::now();
+    while (!queue.empty() || !children.empty()) {
+        while ((long)children.size() < workers && !queue.empty()) {
+            uint64_t shard = queue.front();
+
+            std::cout.flush();
+            pid_t pid = fork();
+            if (pid == 0) {
+#ifdef __linux__
+                // Workers go down with the driver, so a restarted driver does not share the table with them
+                prctl(PR_SET_PDEATHSIG, SIGKILL);
+                if (getppid() != driver) _exit(1);
+#endif
+                runShard(table, base, spec, shard, timeout);
+                _exit(0);
+            }
+            if (pid < 0) {
+                // Out of processes: wait for a worker to finish, unless there is none
+                if (children.empty()) {
+                    std::cerr << "cannot start a worker: " << std::strerror(errno) << std::endl;
+                    return 1;
+                }
+                break;
+            }
+            queue.pop_front();
+            children[pid] = shard;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        auto child = children.find(pid);
+        if (child == children.end()) continue;
+        uint64_t shard = child->second;
+        children.erase(child);
+
+        if (table.Done[shard]) continue;
+
+        ++restarts;
+        std::cerr << "worker on shard " << shard << " died";
+        if (WIFSIGNALED(status)) std::cerr << " (signal " << WTERMSIG(status) << ")";
+        else if (WIFEXITED(status)) std::cerr << " (exit " << WEXITSTATUS(status) << ")";
+
+        if (++deaths[shard] < deathLimit) {
+            std::cerr << ", restarting it" << std::endl;
+            queue.push_back(shard);
+        } else {
+            std::cerr << ", giving it up" << std::endl;
+            ++abandoned;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t finished = 0, crashed = 0, outcomes[5] = {0, 0, 0, 0, 0};
+    for (uint64_t run = 0; run < table.Header->Runs; ++run) {
+        const SweepRecord& record = table.Records[run];
+        if (record.Status == runStatus::FINISHED) {
+            ++finished;
+            ++outcomes[std::min<uint32_t>(record.Outcome, 4)];
+        } else if (record.Status == runStatus::CRASHED) {
+            ++crashed;
+        }
+    }
+
+    std::cout << "wall time         " << seconds << " s\n"
+              << "runs finished     " << finished << " of " << table.Header->Runs << '\n'
+              << "  timed out       " << outcomes[runOutcome::TIMED_OUT] << '\n'
+              << "  escaped         " << outcomes[runOutcome::ESCAPED] << '\n'
+              << "  merged          " << outcomes[runOutcome::MERGED] << '\n'
+              << "  boundary        " << outcomes[runOutcome::BOUNDARY] << '\n'
+              << "  collided        " << outcomes[runOutcome::COLLIDED] << '\n'
+              << "runs crashed      " << crashed << '\n'
+              << "worker restarts   " << restarts << '\n';
+    if (abandoned) std::cout << "shards given up   " << abandoned << '\n';
+
+    int result = abandoned ? 1 : 0;
+    if (!csv.empty()) {
+        std::ofstream out(csv);
+        if (out) {
+            writeCsv(out, table, spec);
+        } else {
+            std::cerr << "cannot write " << csv << std::endl;
+            result = 1;
+        }
+    }
+
+    munmap(table.Header, table.Size);
+    return result;
+}
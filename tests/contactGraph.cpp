@@ -0,0 +1,115 @@
+/**
+ * @file contactGraph.cpp
+ * @author DotBox
+ * @brief Check: contact resolution does not depend on the thread count
+ *
+ * Colours the contacts of a cubic lattice of touching spheres and checks that
+ * every contact is resolved exactly once, with the batches running threaded.
+ * Then runs the same lattice, large enough for the batches to go
+ * threaded, through the engine with 1 and with 4 threads, for both contact
+ * solvers, and requires bit-identical bodies.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include "Physics/physics.h"
+
+inline constexpr int LATTICE = 12;      ///< Spheres per edge of the lattice
+
+static bool check(bool condition, const char* what) {
+    if (!condition) std::cerr << "FAILED: " << what << std::endl;
+    return condition;
+}
+
+// Neighbouring lattice sites, in lattice order
+static std::vector<std::pair<uint32_t, uint32_t>> latticeContacts() {
+    auto site = [](int x, int y, int z) { return (uint32_t)((x * LATTICE + y) * LATTICE + z); };
+    std::vector<std::pair<uint32_t, uint32_t>> contacts;
+    for (int x = 0; x < LATTICE; ++x) {
+        for (int y = 0; y < LATTICE; ++y) {
+            for (int z = 0; z < LATTICE; ++z) {
+                if (x + 1 < LATTICE) contacts.push_back({site(x, y, z), site(x + 1, y, z)});
+                if (y + 1 < LATTICE) contacts.push_back({site(x, y, z), site(x, y + 1, z)});
+                if (z + 1 < LATTICE) contacts.push_back({site(x, y, z), site(x, y, z + 1)});
+            }
+        }
+    }
+    return contacts;
+}
+
+static bool everyContactOnce() {
+    const auto contacts = latticeContacts();
+    const size_t bodies = LATTICE * LATTICE * LATTICE;
+
+    ContactGraph graph;
+    graph.setThreads(4);
+    graph.build(contacts, bodies);
+
+    std::vector<int> visits(contacts.size(), 0);
+    std::mutex lock;
+    graph.resolve([&](uint32_t contact) {
+        std::lock_guard<std::mutex> guard(lock);
+        ++visits[contact];
+    });
+
+    bool once = true;
+    for (int count : visits) once &= count == 1;
+    bool ok = check(once, "every contact resolved exactly once");
+    ok &= check(graph.getBatches() >= 6, "a lattice needs at least six colours");
+    return ok;
+}
+
+// A lattice of slightly overlapping spheres, jittered so the contacts differ
+static std::deque<Body> pile() {
+    std::deque<Body> bodies;
+    for (int x = 0; x < LATTICE; ++x) {
+        for (int y = 0; y < LATTICE; ++y) {
+            for (int z = 0; z < LATTICE; ++z) {
+                Body body;
+                body.Mass = 1.0f + 0.01f * (float)((x * 7 + y * 3 + z) % 5);
+                body.setRadius(0.5f);
+                body.Position = glm::vec3(0.98f * x, 0.98f * y + 5.0f, 0.98f * z);
+                body.Velocity = glm::vec3(0.01f * (float)((x + 2 * y) % 3) - 0.01f, 0.0f, 0.01f * (float)((y + z) % 3) - 0.01f);
+                bodies.push_back(body);
+            }
+        }
+    }
+    return bodies;
+}
+
+static std::deque<Body> run(unsigned threads, contactSolverType solver) {
+    std::deque<Body> bodies = pile();
+    std::vector<Body*> pointers;
+    for (Body& body : bodies) pointers.push_back(&body);
+
+    Physics engine(1.0f / 60.0f, 1.0f);
+    engine.setThreads(threads);
+    engine.setContactSolver(solver, CONTACT_ITERATIONS);
+    for (int frame = 0; frame < 20; ++frame) engine.processFrame(pointers);
+    engine.cleanup();
+    return bodies;
+}
+
+static bool same(const std::deque<Body>& one, const std::deque<Body>& two) {
+    if (one.size() != two.size()) return false;
+    for (size_t i = 0; i < one.size(); ++i) {
+        if (std::memcmp(&one[i].Position, &two[i].Position, sizeof(glm::vec3)) != 0) return false;
+        if (std::memcmp(&one[i].Velocity, &two[i].Velocity, sizeof(glm::vec3)) != 0) return false;
+    }
+    return true;
+}
+
+int main() {
+    bool ok = everyContactOnce();
+
+    ok &= check(same(run(1, contactSolverType::ELASTIC), run(4, contactSolverType::ELASTIC)), "elastic contacts identical on 1 and 4 threads");
+    ok &= check(same(run(1, contactSolverType::SEQUENTIAL_IMPULSE), run(4, contactSolverType::SEQUENTIAL_IMPULSE)), "impulse solver identical on 1 and 4 threads");
+
+    return ok ? 0 : 1;
+}
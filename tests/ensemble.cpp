@@ -0,0 +1,172 @@
+/**
+ * @file ensemble.cpp
+ * @author DotBox
+ * @brief Check: the ensemble engine agrees with a scalar leapfrog, one system at a time
+ *
+ * Draws three-body systems of random masses, positions and velocities, more
+ * than fill two blocks of lanes so that harvested lanes get refilled, and
+ * integrates them with the ensemble for a duration that is not a whole
+ * number of steps. Each one is also integrated on its own by a plain
+ * kick-drift-kick loop with the same cut last step and collision test. Both
+ * must stop at the same time with the same outcome and the same state, with
+ * one worker thread and with several, and with one collision distance for
+ * every pair as well as with bodies of different radii. A step of zero must
+ * be clamped, so the run still returns.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Physics/ensemble.h"
+#include "Physics/physics.h"
+
+inline constexpr size_t SYSTEMS = 150;          ///< Over two blocks of lanes
+inline constexpr double STEP = 0.01;
+inline constexpr double DURATION = 3.005;       ///< Not a whole number of steps
+inline constexpr double COLLISION = 1.0;        ///< Of every pair, without radii
+
+static bool check(bool condition, const char* what, double value) {
+    if (!condition) std::cerr << "FAILED: " << what << " (" << value << ")" << std::endl;
+    return condition;
+}
+
+static std::vector<SystemState> draw() {
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> position(-20.0, 20.0), velocity(-1.5, 1.5), mass(1e11, 5e12);
+
+    std::vector<SystemState> systems(SYSTEMS);
+    for (SystemState& system : systems) {
+        system.resize(ENSEMBLE_BODIES);
+        for (int i = 0; i < ENSEMBLE_BODIES; ++i) {
+            system.Mass[i] = mass(generator);
+            system.Position[i] = glm::dvec3(position(generator), position(generator), position(generator));
+            system.Velocity[i] = glm::dvec3(velocity(generator), velocity(generator), velocity(generator));
+        }
+        system.Time = 2.0;
+    }
+    return systems;
+}
+
+// Collision distance of the pair (i, j)
+static double contact(const std::vector<double>& radii, int i, int j) {
+    return radii.empty() ? COLLISION : radii[i] + radii[j];
+}
+
+// Accelerations of the pairs in the order of the ensemble; returns the pair
+// deepest inside its collision distance as the body left out of it, or -1
+static int accelerations(const SystemState& state, const std::vector<double>& radii, std::vector<glm::dvec3>& acc) {
+    int collided = -1;
+    double deepest = 1.0;
+    std::fill(acc.begin(), acc.end(), glm::dvec3(0.0));
+    for (int i = 0; i < ENSEMBLE_BODIES; ++i) {
+        for (int j = i + 1; j < ENSEMBLE_BODIES; ++j) {
+            glm::dvec3 d = state.Position[j] - state.Position[i];
+            double d2 = d.x * d.x + d.y * d.y + d.z * d.z;
+            double inv3 = GRAV_CONST / (d2 * std::sqrt(d2));
+            acc[i] += state.Mass[j] * inv3 * d;
+            acc[j] -= state.Mass[i] * inv3 * d;
+            double depth = d2 / (contact(radii, i, j) * contact(radii, i, j));
+            if (depth < deepest) {
+                deepest = depth;
+                collided = ENSEMBLE_BODIES - i - j;
+            }
+        }
+    }
+    return collided;
+}
+
+// One system on its own: kick-drift-kick until a collision or the end of the duration
+static EnsembleResult leapfrog(const SystemState& start, const std::vector<double>& radii) {
+    EnsembleResult result;
+    result.Final = start;
+    result.Outcome = ensembleOutcome::TIMED_OUT;
+    result.Body = -1;
+    SystemState& state = result.Final;
+
+    std::vector<glm::dvec3> acc(ENSEMBLE_BODIES);
+    accelerations(state, radii, acc);
+    double elapsed = 0.0;
+    while (true) {
+        const double h = std::min(DURATION - elapsed, STEP);
+        for (int i = 0; i < ENSEMBLE_BODIES; ++i) {
+            state.Velocity[i] += 0.5 * h * acc[i];
+            state.Position[i] += h * state.Velocity[i];
+        }
+        const int collided = accelerations(state, radii, acc);
+        for (int i = 0; i < ENSEMBLE_BODIES; ++i) {
+            state.Velocity[i] += 0.5 * h * acc[i];
+        }
+        elapsed += h;
+        if (collided >= 0) {
+            result.Outcome = ensembleOutcome::COLLIDED;
+            result.Body = collided;
+            break;
+        }
+        if (DURATION - elapsed <= 1e-9 * STEP) break;
+    }
+    state.Time = start.Time + elapsed;
+    return result;
+}
+
+// Largest difference of the states, relative to the largest coordinate and speed
+static double difference(const SystemState& one, const SystemState& two) {
+    double error = 0.0;
+    for (int i = 0; i < ENSEMBLE_BODIES; ++i) {
+        const double scale = std::max(1.0, glm::length(two.Position[i]));
+        error = std::max(error, glm::length(one.Position[i] - two.Position[i]) / scale);
+        error = std::max(error, glm::length(one.Velocity[i] - two.Velocity[i]) / std::max(1.0, glm::length(two.Velocity[i])));
+    }
+    return error;
+}
+
+static bool compare(const std::vector<SystemState>& systems, unsigned threads, const std::vector<double>& radii) {
+    Ensemble ensemble;
+    ensemble.setThreads(threads);
+    ensemble.setStep(STEP);
+    ensemble.setDuration(DURATION);
+    ensemble.setCollisionDistance(COLLISION);
+    ensemble.setRadii(radii);
+    std::vector<EnsembleResult> results = ensemble.run(systems);
+
+    bool ok = check(results.size() == systems.size(), "a result per system", (double)results.size());
+    size_t collided = 0;
+    for (size_t s = 0; s < systems.size() && ok; ++s) {
+        EnsembleResult reference = leapfrog(systems[s], radii);
+        collided += reference.Outcome == ensembleOutcome::COLLIDED;
+        ok &= check(results[s].System == s, "results in the order of the systems", (double)s);
+        ok &= check(results[s].Outcome == reference.Outcome, "same outcome as the scalar leapfrog", (double)s);
+        ok &= check(results[s].Body == reference.Body, "same body left out of the collision", (double)s);
+        ok &= check(std::abs(results[s].Final.Time - reference.Final.Time) < 1e-12, "same stop time",
+                    results[s].Final.Time - reference.Final.Time);
+        ok &= check(difference(results[s].Final, reference.Final) < 1e-12, "same final state",
+                    difference(results[s].Final, reference.Final));
+    }
+    // Both outcomes have to be covered for the check to mean anything
+    ok &= check(collided > 0 && collided < systems.size(), "some systems collide, some time out", (double)collided);
+    return ok;
+}
+
+int main() {
+    const std::vector<SystemState> systems = draw();
+    bool ok = compare(systems, 1, {});
+    ok &= compare(systems, 3, {});
+    // Unequal spheres: each pair touches at the sum of its own radii
+    ok &= compare(systems, 1, {0.2, 0.5, 1.5});
+
+    // A step of zero is clamped to ENSEMBLE_MIN_STEP
+    Ensemble ensemble;
+    ensemble.setThreads(1);
+    ensemble.setStep(0.0);
+    ensemble.setDuration(1000.0 * ENSEMBLE_MIN_STEP);
+    std::vector<EnsembleResult> results = ensemble.run(std::vector<SystemState>(systems.begin(), systems.begin() + 1));
+    ok &= check(std::abs(results[0].Final.Time - systems[0].Time - 1000.0 * ENSEMBLE_MIN_STEP) < 1e-12,
+                "a zero step runs to the duration", results[0].Final.Time - systems[0].Time);
+
+    return ok ? 0 : 1;
+}
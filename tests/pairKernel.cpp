@@ -0,0 +1,106 @@
+/**
+ * @file pairKernel.cpp
+ * @author DotBox
+ * @brief Check: the fused pair kernel reproduces Physics::gravityBetween exactly
+ *
+ * Scatters bodies of random masses and radii (including a light source, a
+ * coincident pair and pairs inside the one-unit clamp) and sums the gravity
+ * of every pair j > i with gravityBetween, in the order of the engine's force
+ * loop. The kernel must give bit-identical accumulators, with and without
+ * regularization groups (whose pairs exert no force there), and flag every
+ * pair within contact distance as a candidate.
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include "Physics/physics.h"
+
+inline constexpr size_t BODIES = 67;    ///< Not a multiple of any vector width
+
+static bool check(bool condition, const char* what) {
+    if (!condition) std::cerr << "FAILED: " << what << std::endl;
+    return condition;
+}
+
+static std::deque<Body> scatter() {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(-20.0f, 20.0f), mass(1e9f, 1e12f), radius(0.1f, 1.5f);
+
+    std::deque<Body> bodies(BODIES);
+    for (Body& body : bodies) {
+        body.Mass = mass(generator);
+        body.setRadius(radius(generator));
+        body.Position = glm::vec3(position(generator), position(generator), position(generator));
+        body.vForceAccumulator = glm::vec3(0.0f);
+    }
+    bodies[3].sphere.mesh.source = true;
+    bodies[10].Position = bodies[9].Position;
+    bodies[20].Position = bodies[19].Position + glm::vec3(0.6f, 0.0f, 0.3f);
+    bodies[31].Position = bodies[30].Position + glm::vec3(0.0f, 1.0005f, 0.0f);
+    return bodies;
+}
+
+static bool same(const glm::vec3& one, const glm::vec3& two) {
+    return std::memcmp(&one, &two, sizeof(glm::vec3)) == 0;
+}
+
+static bool compare(const std::vector<int>& group) {
+    Physics engine;
+
+    // Reference: the engine's pair loop over gravityBetween
+    std::deque<Body> reference = scatter();
+    for (size_t i = 0; i < reference.size(); ++i) {
+        if (reference[i].sphere.mesh.source) continue;
+        for (size_t j = i + 1; j < reference.size(); ++j) {
+            if (reference[j].sphere.mesh.source) continue;
+            if (group[i] >= 0 && group[i] == group[j]) continue;
+            glm::vec3 force = engine.gravityBetween(reference[i], reference[j]);
+            reference[i].vForceAccumulator += force;
+            reference[j].vForceAccumulator -= force;
+        }
+    }
+
+    std::deque<Body> fused = scatter();
+    std::vector<Body*> pointers;
+    for (Body& body : fused) pointers.push_back(&body);
+    std::vector<std::pair<uint32_t, uint32_t>> candidates;
+    PairKernel kernel;
+    kernel.run(pointers, group, 0.0f, &candidates);
+
+    bool forces = true;
+    for (size_t i = 0; i < fused.size(); ++i) forces &= same(fused[i].vForceAccumulator, reference[i].vForceAccumulator);
+    bool ok = check(forces, "kernel forces bit-identical to gravityBetween");
+
+    bool touching = true;
+    for (size_t i = 0; i < fused.size(); ++i) {
+        for (size_t j = i + 1; j < fused.size(); ++j) {
+            if (fused[i].sphere.mesh.source || fused[j].sphere.mesh.source) continue;
+            float contact = fused[i].sphere.geometry.getRadius() + fused[j].sphere.geometry.getRadius();
+            glm::vec3 d = fused[j].Position - fused[i].Position;
+            if (glm::dot(d, d) > contact * contact) continue;
+            touching &= std::find(candidates.begin(), candidates.end(), std::make_pair((uint32_t)i, (uint32_t)j)) != candidates.end();
+        }
+    }
+    ok &= check(touching, "every touching pair is a candidate");
+    return ok;
+}
+
+int main() {
+    bool ok = compare(std::vector<int>(BODIES, -1));
+
+    // Two regularized pairs and a chain of three
+    std::vector<int> group(BODIES, -1);
+    group[19] = group[20] = 0;
+    group[30] = group[31] = 1;
+    group[40] = group[41] = group[42] = 2;
+    ok &= compare(group);
+
+    return ok ? 0 : 1;
+}
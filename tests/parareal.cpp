@@ -0,0 +1,67 @@
+/**
+ * @file parareal.cpp
+ * @author DotBox
+ * @brief Check: Parareal converges to the serial fine propagator
+ *
+ * Integrates the three spheres of scenarios/free.txt (without their contacts)
+ * over 20 s, once with the Parareal driver on 8 slices and once serially with
+ * its fine propagator alone. Converged, the two agree to about the Parareal
+ * tolerance. Run to as many iterations as slices, Parareal reproduces to
+ * rounding the fine propagator stepped serially through the same slices (the
+ * adaptive integrators place their steps differently across one long call).
+ *
+ * @version 0.1
+ * @date 2025-10-28
+ *
+ */
+
+#include <iostream>
+#include "Physics/physics.h"
+
+static SystemState scene() {
+    SystemState state;
+    state.Mass = {30e11, 30e11, 30e11};
+    state.Position = {{0.0, 36.0, -2.0}, {17.32, 20.0, -2.0}, {-17.32, 20.0, -2.0}};
+    state.Velocity = {{2.0, -1.4142, 0.0}, {-1.4142, -1.4142, 0.0}, {1.4142, 1.4142, 0.0}};
+    return state;
+}
+
+static bool check(bool condition, const char* what, double value) {
+    if (!condition) std::cerr << "FAILED: " << what << " (" << value << ")" << std::endl;
+    return condition;
+}
+
+int main() {
+    const double interval = 20.0, step = 1.0 / 60.0;
+    const unsigned slices = 8;
+    bool ok = true;
+
+    for (integratorType type : {integratorType::EULER, integratorType::BULIRSCH_STOER, integratorType::TAYLOR}) {
+        Propagator fine = Physics::makePropagator(type, 1e-12, step);
+        Propagator coarse = Physics::makePropagator(integratorType::EULER, 0.0, 10.0 * step);
+
+        SystemState serial = scene();
+        fine(serial, interval);
+
+        SystemState sliced = scene();
+        for (unsigned n = 0; n < slices; ++n) fine(sliced, interval / slices);
+
+        // Converged early
+        Parareal parareal(coarse, fine);
+        parareal.setThreads(4);
+        SystemState converged = scene();
+        unsigned iterations = parareal.integrate(converged, interval, slices);
+        ok &= check(iterations >= 1 && iterations <= slices, "iterations within the slices", iterations);
+        ok &= check(Parareal::difference(converged, serial) < 1e-8, "converged result matches the serial fine one", Parareal::difference(converged, serial));
+        ok &= check(std::abs(converged.Time - interval) < 1e-9, "time advanced by the interval", converged.Time);
+
+        // Every iteration: slice n is exact after n iterations
+        parareal.setTolerance(0.0);
+        SystemState exact = scene();
+        iterations = parareal.integrate(exact, interval, slices);
+        ok &= check(iterations == slices, "tolerance 0 runs every iteration", iterations);
+        ok &= check(Parareal::difference(exact, sliced) < 1e-10, "full iteration reproduces the serial fine result", Parareal::difference(exact, sliced));
+    }
+
+    return ok ? 0 : 1;
+}